@@ -1,4 +1,7 @@
 #include "chunkprocessor.h"
+#include "performancemonitor.h"
+#include <chrono>
+#include <thread>
 
 /**
  * Implementation file for chunk processor data structures
@@ -16,16 +19,196 @@
  *
  * Memory Usage Pattern:
  * - Producer thread: Holds 1 chunk worth of frames during extraction
- * - Shared queue: Holds reference to 1 chunk (capacity = 1)
+ * - ChunkQueue: Holds up to N chunks (configurable depth, default 2)
  * - Consumer thread: Processes workingFrames = lastFrame + currentChunk
  * - ProcessingState: Retains only 1 frame (lastFrame) between chunks
- * - Peak memory: ~2 chunks worth of frames (significantly reduced from original)
+ * - Peak memory: ~(N + 2) chunks worth of frames, further capped by the MemoryBudget
  */
 
-// Note: This implementation file primarily contains the data structure definitions
-// from the header file. The actual chunk processing logic will be implemented
-// in the SlideDetector class through the detectSlidesFromChunk method, and
-// the producer-consumer coordination will be handled in the ProcessingThread class.
+namespace {
+
+// Sleep interval while polling the lock-free queue or re-checking abort conditions
+const auto LOCK_FREE_POLL_INTERVAL = std::chrono::microseconds(200);
+const auto BLOCKING_WAIT_INTERVAL = std::chrono::milliseconds(100);
+
+long long elapsedMicroseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+ChunkQueue::ChunkQueue(size_t capacity, bool lockFree)
+    : m_capacity(capacity > 0 ? capacity : 1),
+      m_lockFree(lockFree),
+      m_slots(m_capacity + 1),
+      m_head(0),
+      m_tail(0),
+      m_closed(false),
+      m_producerStallUs(0),
+      m_consumerStallUs(0),
+      m_peakOccupancy(0)
+{
+}
+
+bool ChunkQueue::isFull() const
+{
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    return (tail + 1) % m_slots.size() == m_head.load(std::memory_order_acquire);
+}
+
+bool ChunkQueue::isEmpty() const
+{
+    return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+}
+
+bool ChunkQueue::push(std::unique_ptr<FrameChunk>& chunk, const std::function<bool()>& shouldAbort)
+{
+    if (!chunk) {
+        return false;
+    }
+
+    auto waitStart = std::chrono::steady_clock::now();
+    bool stalled = false;
+
+    if (m_lockFree) {
+        while (isFull()) {
+            if (shouldAbort && shouldAbort()) {
+                return false;
+            }
+            stalled = true;
+            std::this_thread::sleep_for(LOCK_FREE_POLL_INTERVAL);
+        }
+
+        // Only the producer writes the tail slot, so no lock is needed
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        m_slots[tail] = std::move(chunk);
+        m_tail.store((tail + 1) % m_slots.size(), std::memory_order_release);
+    } else {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (isFull()) {
+            if (shouldAbort && shouldAbort()) {
+                return false;
+            }
+            stalled = true;
+            m_notFull.wait_for(lock, BLOCKING_WAIT_INTERVAL);
+        }
+
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        m_slots[tail] = std::move(chunk);
+        m_tail.store((tail + 1) % m_slots.size(), std::memory_order_release);
+        lock.unlock();
+        m_notEmpty.notify_one();
+    }
+
+    if (stalled) {
+        long long stallUs = elapsedMicroseconds(waitStart);
+        m_producerStallUs += stallUs;
+        PerformanceMonitor::getInstance().recordSample("ChunkQueue.producerStallMs", stallUs / 1000.0, "ChunkQueue");
+    }
+    recordOccupancy();
+    return true;
+}
+
+bool ChunkQueue::pop(std::unique_ptr<FrameChunk>& chunk, const std::function<bool()>& shouldAbort)
+{
+    auto waitStart = std::chrono::steady_clock::now();
+    bool stalled = false;
+
+    if (m_lockFree) {
+        while (isEmpty()) {
+            // Re-check emptiness after observing close so a final push is not lost
+            if (m_closed.load(std::memory_order_acquire) && isEmpty()) {
+                return false;
+            }
+            if (shouldAbort && shouldAbort()) {
+                return false;
+            }
+            stalled = true;
+            std::this_thread::sleep_for(LOCK_FREE_POLL_INTERVAL);
+        }
+
+        // Only the consumer reads the head slot, so no lock is needed
+        size_t head = m_head.load(std::memory_order_relaxed);
+        chunk = std::move(m_slots[head]);
+        m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+    } else {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (isEmpty()) {
+            if (m_closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (shouldAbort && shouldAbort()) {
+                return false;
+            }
+            stalled = true;
+            m_notEmpty.wait_for(lock, BLOCKING_WAIT_INTERVAL);
+        }
+
+        size_t head = m_head.load(std::memory_order_relaxed);
+        chunk = std::move(m_slots[head]);
+        m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+        lock.unlock();
+        m_notFull.notify_one();
+    }
+
+    if (stalled) {
+        long long stallUs = elapsedMicroseconds(waitStart);
+        m_consumerStallUs += stallUs;
+        PerformanceMonitor::getInstance().recordSample("ChunkQueue.consumerStallMs", stallUs / 1000.0, "ChunkQueue");
+    }
+    return true;
+}
+
+void ChunkQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed.store(true, std::memory_order_release);
+    }
+    m_notEmpty.notify_all();
+}
+
+void ChunkQueue::wakeAll()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+}
+
+std::vector<std::unique_ptr<FrameChunk>> ChunkQueue::drain()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<std::unique_ptr<FrameChunk>> remaining;
+    while (!isEmpty()) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        remaining.push_back(std::move(m_slots[head]));
+        m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+    }
+    return remaining;
+}
+
+size_t ChunkQueue::size() const
+{
+    size_t head = m_head.load(std::memory_order_acquire);
+    size_t tail = m_tail.load(std::memory_order_acquire);
+    return (tail + m_slots.size() - head) % m_slots.size();
+}
+
+void ChunkQueue::recordOccupancy()
+{
+    size_t occupancy = size();
+
+    size_t peak = m_peakOccupancy.load();
+    while (occupancy > peak && !m_peakOccupancy.compare_exchange_weak(peak, occupancy)) {
+    }
+
+    PerformanceMonitor::getInstance().recordSample("ChunkQueue.occupancy", static_cast<double>(occupancy), "ChunkQueue");
+}
 
 // The structures defined in chunkprocessor.h are designed to be:
 // 1. Lightweight and efficient for frequent copying/moving
@@ -36,5 +219,4 @@
 // Future enhancements could include:
 // - Memory pool allocation for FrameChunk objects to reduce allocation overhead
 // - Compression of lastFrame in ProcessingState for very large frames
-// - Statistics collection for memory usage monitoring
-// - Adaptive chunk sizing based on available memory
\ No newline at end of file
+// - Adaptive chunk sizing based on available memory
@@ -3,6 +3,10 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <opencv2/opencv.hpp>
 #include "memoryoptimizer.h"
 
@@ -29,6 +33,7 @@ struct ProcessingState {
 
     // Zero-copy single-frame overlap mechanism
     FrameBuffer lastFrameBuffer;            // Last frame from the previous chunk (zero-copy)
+    cv::Mat lastPreprocessedFrame;          // Last frame of the previous chunk, already downsampled to gray for SSIM
     int lastFrameGlobalIndex;               // Global index of the last frame
 
     // Verification state management for cross-chunk continuity
@@ -61,6 +66,7 @@ struct ProcessingState {
         savedSlideIndices.clear();
         lastStableIndex = -1;
         lastFrameBuffer.reset();
+        lastPreprocessedFrame.release();
         lastFrameGlobalIndex = -1;
         lastFrameVerificationState = VerificationState::NONE;
         verificationStartIndex = -1;
@@ -76,7 +82,7 @@ struct ProcessingState {
      * @return true if no previous frame exists (first chunk)
      */
     bool isFirstChunk() const {
-        return !lastFrameBuffer.isValid();
+        return !lastFrameBuffer.isValid() && lastPreprocessedFrame.empty();
     }
 
     /**
@@ -125,6 +131,10 @@ struct FrameChunk {
     std::unique_ptr<MappedFrameChunk> mappedChunk;  // Memory-mapped chunk for large datasets
     std::vector<FrameBuffer> frameBuffers;          // Zero-copy frame buffers
 
+    // Detection-only storage: `frames` holds detection-size luma, full-resolution frames are produced on demand
+    std::vector<std::function<cv::Mat()>> fullFrameLoaders;
+    size_t loaderMemoryUsage = 0;   // Memory retained by the loaders
+
     // Metadata
     int startOffset;                // Starting offset of this chunk in the video (frame index)
     bool isLastChunk;               // Flag indicating if this is the final chunk
@@ -171,6 +181,8 @@ struct FrameChunk {
         frames(std::move(other.frames)),
         mappedChunk(std::move(other.mappedChunk)),
         frameBuffers(std::move(other.frameBuffers)),
+        fullFrameLoaders(std::move(other.fullFrameLoaders)),
+        loaderMemoryUsage(other.loaderMemoryUsage),
         startOffset(other.startOffset),
         isLastChunk(other.isLastChunk),
         useOptimizedStorage(other.useOptimizedStorage) {}
@@ -183,6 +195,8 @@ struct FrameChunk {
             frames = std::move(other.frames);
             mappedChunk = std::move(other.mappedChunk);
             frameBuffers = std::move(other.frameBuffers);
+            fullFrameLoaders = std::move(other.fullFrameLoaders);
+            loaderMemoryUsage = other.loaderMemoryUsage;
             startOffset = other.startOffset;
             isLastChunk = other.isLastChunk;
             useOptimizedStorage = other.useOptimizedStorage;
@@ -246,6 +260,18 @@ struct FrameChunk {
         return cv::Mat();
     }
 
+    /**
+     * Get a frame at full resolution, for frames selected as slides
+     * @param index Frame index within this chunk
+     * @return Full-resolution frame, or empty Mat if index invalid or the frame could not be produced
+     */
+    cv::Mat getFullFrame(size_t index) const {
+        if (index < fullFrameLoaders.size() && fullFrameLoaders[index]) {
+            return fullFrameLoaders[index]();
+        }
+        return getFrame(index);
+    }
+
     /**
      * Get all frames as Mat views (zero-copy when possible)
      * @return Vector of Mat views
@@ -328,7 +354,7 @@ struct FrameChunk {
             }
             return total;
         } else {
-            size_t total = 0;
+            size_t total = loaderMemoryUsage;
             for (const auto& frame : frames) {
                 total += frame.total() * frame.elemSize();
             }
@@ -337,4 +363,124 @@ struct FrameChunk {
     }
 };
 
-#endif // CHUNKPROCESSOR_H
\ No newline at end of file
+/**
+ * Bounded FIFO of frame chunks between the decoder (producer) and slide detection (consumer)
+ * Holds up to `capacity` chunks so bursty decoding and slow chunks on either side do not
+ * immediately stall the other stage. Two implementations are available:
+ * - Blocking: mutex + condition variables, suitable for any capacity
+ * - Lock-free: single-producer/single-consumer ring buffer with atomic indices;
+ *   waiting sides poll with a short sleep instead of sleeping on a condition variable
+ * Time spent waiting on a full (producer) or empty (consumer) queue is accumulated
+ * and reported to PerformanceMonitor together with the queue occupancy.
+ */
+class ChunkQueue {
+public:
+    /**
+     * Constructor
+     * @param capacity Maximum number of queued chunks (at least 1)
+     * @param lockFree Use the lock-free SPSC ring buffer instead of the blocking queue
+     */
+    explicit ChunkQueue(size_t capacity, bool lockFree = false);
+
+    /**
+     * Deleted copy operations
+     */
+    ChunkQueue(const ChunkQueue&) = delete;
+    ChunkQueue& operator=(const ChunkQueue&) = delete;
+
+    /**
+     * Append a chunk, waiting while the queue is full
+     * Must only be called from the single producer thread
+     * @param chunk Chunk to append; left untouched if the push is aborted
+     * @param shouldAbort Polled while waiting; returning true abandons the push
+     * @return true if the chunk was queued
+     */
+    bool push(std::unique_ptr<FrameChunk>& chunk, const std::function<bool()>& shouldAbort);
+
+    /**
+     * Take the oldest chunk, waiting while the queue is empty and not closed
+     * Must only be called from the single consumer thread
+     * @param chunk Receives the dequeued chunk
+     * @param shouldAbort Polled while waiting; returning true abandons the pop
+     * @return true if a chunk was dequeued, false if the queue is closed and drained or aborted
+     */
+    bool pop(std::unique_ptr<FrameChunk>& chunk, const std::function<bool()>& shouldAbort);
+
+    /**
+     * Mark the end of the stream; pop() returns false once remaining chunks are drained
+     */
+    void close();
+
+    /**
+     * Wake all waiting threads so they can re-check their abort condition
+     */
+    void wakeAll();
+
+    /**
+     * Remove and return every queued chunk (used for teardown after the threads have exited)
+     * @return Chunks that were still queued, oldest first
+     */
+    std::vector<std::unique_ptr<FrameChunk>> drain();
+
+    /**
+     * Get the number of queued chunks
+     * @return Current occupancy
+     */
+    size_t size() const;
+
+    /**
+     * Get the queue capacity
+     * @return Maximum number of queued chunks
+     */
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * Check which implementation is in use
+     * @return true for the lock-free SPSC ring buffer
+     */
+    bool isLockFree() const { return m_lockFree; }
+
+    /**
+     * Get the accumulated time the producer waited on a full queue
+     * @return Stall time in milliseconds
+     */
+    double producerStallMs() const { return m_producerStallUs.load() / 1000.0; }
+
+    /**
+     * Get the accumulated time the consumer waited on an empty queue
+     * @return Stall time in milliseconds
+     */
+    double consumerStallMs() const { return m_consumerStallUs.load() / 1000.0; }
+
+    /**
+     * Get the highest occupancy observed after a push
+     * @return Peak number of queued chunks
+     */
+    size_t peakOccupancy() const { return m_peakOccupancy.load(); }
+
+private:
+    bool isFull() const;
+    bool isEmpty() const;
+    void recordOccupancy();
+
+    const size_t m_capacity;
+    const bool m_lockFree;
+
+    // Ring storage: capacity + 1 slots so that head == tail means empty
+    std::vector<std::unique_ptr<FrameChunk>> m_slots;
+    std::atomic<size_t> m_head;              // Next slot to pop (written by consumer)
+    std::atomic<size_t> m_tail;              // Next slot to push (written by producer)
+    std::atomic<bool> m_closed;
+
+    // Blocking mode synchronization
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+
+    // Statistics
+    std::atomic<long long> m_producerStallUs;
+    std::atomic<long long> m_consumerStallUs;
+    std::atomic<size_t> m_peakOccupancy;
+};
+
+#endif // CHUNKPROCESSOR_H
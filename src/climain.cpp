@@ -0,0 +1,685 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QDir>
+#include <QStandardPaths>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "clirunner.h"
+#include "configmanager.h"
+#include "postprocessor.h"
+#include "phashindex.h"
+#include "hardwaredecoder.h"
+#include "slidedetector.h"
+#include "ssimkernels.h"
+#include "optimizationmanager.h"
+
+namespace {
+
+/**
+ * Parse an integer option, reporting an error for malformed values
+ * @param parser Command-line parser
+ * @param name Option name
+ * @param target Value to overwrite when the option is set
+ * @return false if the option was set but could not be parsed
+ */
+bool readIntOption(const QCommandLineParser& parser, const QString& name, int& target)
+{
+    if (!parser.isSet(name)) {
+        return true;
+    }
+
+    bool ok = false;
+    int value = parser.value(name).toInt(&ok);
+    if (!ok) {
+        fprintf(stderr, "Invalid value for --%s: %s\n",
+                qPrintable(name), qPrintable(parser.value(name)));
+        return false;
+    }
+    target = value;
+    return true;
+}
+
+/**
+ * Time global and tiled SSIM on synthetic grayscale frames and print the result as JSON
+ * @param config Configuration providing the downsample size frames are scored at
+ */
+void benchmarkSSIMModes(const AppConfig& config)
+{
+    const int width = config.enableDownsampling ? config.downsampleWidth : 1920;
+    const int height = config.enableDownsampling ? config.downsampleHeight : 1080;
+    const int iterations = 200;
+    constexpr double C1 = 6.5025;   // (0.01 * 255)^2
+    constexpr double C2 = 58.5225;  // (0.03 * 255)^2
+
+    PerformanceBenchmark benchmark;
+    std::vector<cv::Mat> frames = benchmark.generateTestImages(8, width, height);
+    for (auto& frame : frames) {
+        cv::cvtColor(frame, frame, cv::COLOR_BGR2GRAY);
+    }
+    const int pairs = static_cast<int>(frames.size()) - 1;
+
+    // Sum the scores so neither loop can be optimized away
+    double checksum = 0.0;
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        for (int j = 0; j < pairs; ++j) {
+            SSIMMoments moments;
+            SSIMKernels::computeMoments(frames[j], frames[j + 1], moments);
+            checksum += moments.globalSSIM(C1, C2);
+        }
+    }
+    const double globalMicros = timer.nsecsElapsed() / 1000.0 / (iterations * pairs);
+
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        for (int j = 0; j < pairs; ++j) {
+            TiledSSIMResult tiled;
+            SSIMKernels::computeTiledSSIM(frames[j], frames[j + 1], SSIMKernels::DEFAULT_TILE_SIZE, C1, C2, tiled);
+            checksum += tiled.minSSIM;
+        }
+    }
+    const double tiledMicros = timer.nsecsElapsed() / 1000.0 / (iterations * pairs);
+
+    QJsonObject record;
+    record["benchmark"] = "ssim";
+    record["kernels"] = QString::fromLatin1(SSIMKernels::momentsKernelName());
+    record["width"] = width;
+    record["height"] = height;
+    record["pairs"] = iterations * pairs;
+    record["globalMicrosPerPair"] = globalMicros;
+    record["tiledMicrosPerPair"] = tiledMicros;
+    record["tiledToGlobalRatio"] = globalMicros > 0.0 ? tiledMicros / globalMicros : 0.0;
+    record["checksum"] = checksum;
+
+    QTextStream out(stdout);
+    out << QJsonDocument(record).toJson(QJsonDocument::Compact) << '\n';
+}
+
+/**
+ * Score consecutive sampled frames of real videos in global and tiled mode, find for each preset
+ * the tiled threshold that best reproduces the global mode's change decisions and print the result as JSON
+ * A pair counts as a change when its score is below the threshold, as in SlideDetector::extractSlides;
+ * the calibrated threshold minimizes missed plus extra changes over all pairs.
+ * @param config Configuration providing chunk and downsample sizes
+ * @param videos Video files to sample
+ * @return true if every video was decoded and at least one pair was scored
+ */
+bool calibrateTiledThresholds(const AppConfig& config, const QStringList& videos)
+{
+    const int width = config.enableDownsampling ? config.downsampleWidth : 1920;
+    const int height = config.enableDownsampling ? config.downsampleHeight : 1080;
+
+    std::vector<double> globalScores;
+    std::vector<double> tiledScores;
+    int decodedVideos = 0;
+    bool allDecoded = true;
+
+    for (const QString& video : videos) {
+        HardwareDecoder decoder;
+        if (!decoder.openVideo(video.toStdString())) {
+            fprintf(stderr, "%s: %s\n", qPrintable(video), decoder.getLastError().c_str());
+            allDecoded = false;
+            continue;
+        }
+
+        // Same sampling and preprocessing as extraction; the preprocessed last frame links the chunks
+        SlideDetector globalDetector;
+        SlideDetector tiledDetector;
+        tiledDetector.setTiledSSIM(true);
+        cv::Mat globalPrevious;
+        cv::Mat tiledPrevious;
+        auto chunkCallback = [&](const std::vector<cv::Mat>& frames, int, bool) {
+            cv::Mat globalLast;
+            cv::Mat tiledLast;
+            std::vector<double> global = globalDetector.calculateSSIMScoresFromFrames(
+                frames, globalPrevious, config.enableDownsampling, width, height, &globalLast);
+            std::vector<double> tiled = tiledDetector.calculateSSIMScoresFromFrames(
+                frames, tiledPrevious, config.enableDownsampling, width, height, &tiledLast);
+            globalPrevious = globalLast;
+            tiledPrevious = tiledLast;
+            globalScores.insert(globalScores.end(), global.begin(), global.end());
+            tiledScores.insert(tiledScores.end(), tiled.begin(), tiled.end());
+        };
+
+        if (decoder.extractFramesInChunks(chunkCallback, nullptr, config.chunkSize, 2.0) <= 0) {
+            fprintf(stderr, "%s: no frames extracted\n", qPrintable(video));
+            allDecoded = false;
+            continue;
+        }
+        decodedVideos++;
+    }
+
+    const size_t pairs = std::min(globalScores.size(), tiledScores.size());
+    QJsonArray presets;
+    for (SSIMPreset preset : {SSIMPreset::Strict, SSIMPreset::Normal, SSIMPreset::Loose}) {
+        const double globalThreshold = ConfigManager::getSSIMThreshold(preset, 0.9985, SSIMMode::Global);
+        const double tiledThreshold = ConfigManager::getSSIMThreshold(preset, 0.9985, SSIMMode::Tiled);
+
+        int globalChanges = 0;
+        for (size_t i = 0; i < pairs; ++i) {
+            globalChanges += globalScores[i] < globalThreshold ? 1 : 0;
+        }
+
+        auto countMismatches = [&](double threshold, int& missed, int& extra) {
+            missed = 0;
+            extra = 0;
+            for (size_t i = 0; i < pairs; ++i) {
+                const bool globalChange = globalScores[i] < globalThreshold;
+                const bool tiledChange = tiledScores[i] < threshold;
+                missed += globalChange && !tiledChange ? 1 : 0;
+                extra += !globalChange && tiledChange ? 1 : 0;
+            }
+        };
+
+        int missed = 0, extra = 0;
+        countMismatches(tiledThreshold, missed, extra);
+
+        // Sweep 0.500-0.995; ties go to the candidate nearest the current preset
+        double bestThreshold = tiledThreshold;
+        int bestMissed = missed, bestExtra = extra;
+        for (int step = 0; step < 100; ++step) {
+            const double candidate = 0.500 + step * 0.005;
+            int candidateMissed = 0, candidateExtra = 0;
+            countMismatches(candidate, candidateMissed, candidateExtra);
+            const int mismatches = candidateMissed + candidateExtra;
+            const int bestMismatches = bestMissed + bestExtra;
+            if (mismatches < bestMismatches ||
+                (mismatches == bestMismatches &&
+                 std::abs(candidate - tiledThreshold) < std::abs(bestThreshold - tiledThreshold))) {
+                bestThreshold = candidate;
+                bestMissed = candidateMissed;
+                bestExtra = candidateExtra;
+            }
+        }
+
+        QJsonObject entry;
+        entry["preset"] = ConfigManager::getPresetName(preset);
+        entry["globalThreshold"] = globalThreshold;
+        entry["globalChanges"] = globalChanges;
+        entry["tiledThreshold"] = tiledThreshold;
+        entry["missed"] = missed;
+        entry["extra"] = extra;
+        entry["calibratedTiledThreshold"] = bestThreshold;
+        entry["calibratedMissed"] = bestMissed;
+        entry["calibratedExtra"] = bestExtra;
+        presets.append(entry);
+    }
+
+    QJsonObject record;
+    record["benchmark"] = "ssim-calibration";
+    record["videos"] = decodedVideos;
+    record["width"] = width;
+    record["height"] = height;
+    record["pairs"] = static_cast<qint64>(pairs);
+    record["presets"] = presets;
+
+    QTextStream out(stdout);
+    out << QJsonDocument(record).toJson(QJsonDocument::Compact) << '\n';
+
+    return allDecoded && pairs > 0;
+}
+
+/**
+ * Compare PHashIndex radius search against a linear scan on synthetic near-duplicate hashes,
+ * check the batch Hamming kernel against scalar popcount and print the result as JSON
+ * @param radius Hamming radius, as used for duplicate removal
+ * @return true if the index and the kernel agree with the linear scan
+ */
+bool benchmarkPHashIndex(int radius)
+{
+    const int hashCount = 20000;
+    const int clusterSize = 4;      // Near-duplicate slides per distinct slide
+    const int kernelQueries = 512;
+
+    // Clusters of hashes within (and just beyond) the radius of a random base hash
+    std::mt19937_64 rng(20240601);
+    std::uniform_int_distribution<int> flipCount(0, radius + 2);
+    std::uniform_int_distribution<int> flipBit(0, 255);
+    std::vector<PHash> hashes;
+    hashes.reserve(hashCount);
+    PHash base;
+    base.valid = true;
+    for (int i = 0; i < hashCount; ++i) {
+        if (i % clusterSize == 0) {
+            for (uint64_t& word : base.words) {
+                word = rng();
+            }
+            hashes.push_back(base);
+            continue;
+        }
+        PHash nearby = base;
+        for (int flips = flipCount(rng); flips > 0; --flips) {
+            int bit = flipBit(rng);
+            nearby.words[bit / 64] ^= 1ULL << (bit % 64);
+        }
+        hashes.push_back(nearby);
+    }
+
+    QElapsedTimer timer;
+
+    // Reference: every query against every hash with scalar popcount
+    timer.start();
+    std::vector<std::vector<int>> linearMatches(hashCount);
+    for (int q = 0; q < hashCount; ++q) {
+        for (int i = 0; i < hashCount; ++i) {
+            if (PHashCalculator::hammingDistance(hashes[q], hashes[i]) <= radius) {
+                linearMatches[q].push_back(i);
+            }
+        }
+    }
+    const double linearMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    PHashIndex index(radius);
+    index.reserve(hashes.size());
+    for (int i = 0; i < hashCount; ++i) {
+        index.insert(i, hashes[i]);
+    }
+    const double buildMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    std::vector<std::vector<int>> indexMatches(hashCount);
+    for (int q = 0; q < hashCount; ++q) {
+        indexMatches[q] = index.radiusSearch(hashes[q]);
+    }
+    const double queryMs = timer.nsecsElapsed() / 1e6;
+
+    long long matches = 0;
+    int indexMismatches = 0;
+    for (int q = 0; q < hashCount; ++q) {
+        std::sort(indexMatches[q].begin(), indexMatches[q].end());
+        matches += static_cast<long long>(linearMatches[q].size());
+        if (indexMatches[q] != linearMatches[q]) {
+            indexMismatches++;
+        }
+    }
+
+    // Batch kernel selected for this CPU against scalar popcount, distance by distance
+    PHashTable table;
+    table.reserve(hashes.size());
+    for (const PHash& hash : hashes) {
+        table.append(hash);
+    }
+    std::vector<int> distances(table.size());
+    long long kernelMismatches = 0;
+    timer.restart();
+    for (int q = 0; q < kernelQueries; ++q) {
+        const PHash& query = hashes[(static_cast<size_t>(q) * 7919) % hashes.size()];
+        table.hammingDistances(query, distances.data());
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            if (distances[i] != PHashCalculator::hammingDistance(query, hashes[i])) {
+                kernelMismatches++;
+            }
+        }
+    }
+    const double kernelMs = timer.nsecsElapsed() / 1e6;
+
+    QJsonObject record;
+    record["benchmark"] = "phash";
+    record["hashes"] = hashCount;
+    record["radius"] = radius;
+    record["matches"] = static_cast<double>(matches);
+    record["linearScanMs"] = linearMs;
+    record["indexBuildMs"] = buildMs;
+    record["indexQueryMs"] = queryMs;
+    record["indexSpeedup"] = buildMs + queryMs > 0.0 ? linearMs / (buildMs + queryMs) : 0.0;
+    record["indexMismatches"] = indexMismatches;
+    record["kernel"] = QString::fromLatin1(PHashTable::kernelName());
+    record["kernelQueries"] = kernelQueries;
+    record["kernelCheckMs"] = kernelMs;
+    record["kernelMismatches"] = static_cast<double>(kernelMismatches);
+
+    QTextStream out(stdout);
+    out << QJsonDocument(record).toJson(QJsonDocument::Compact) << '\n';
+
+    return indexMismatches == 0 && kernelMismatches == 0;
+}
+
+/**
+ * Hash real images with both pHash algorithms and print how many bits differ as JSON
+ * @param paths Image files or folders of images (e.g. an output folder of extracted slides)
+ * @param tolerance Largest difference in bits accepted per image
+ * @return true if every image stays within the tolerance
+ */
+bool compareFastPHash(const QStringList& paths, int tolerance)
+{
+    QStringList imageFiles;
+    for (const QString& path : paths) {
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDir dir(path);
+            for (const QString& name : dir.entryList({"*.jpg", "*.jpeg", "*.png"}, QDir::Files, QDir::Name)) {
+                imageFiles.append(dir.filePath(name));
+            }
+        } else if (info.isFile()) {
+            imageFiles.append(path);
+        }
+    }
+
+    int compared = 0;
+    int failed = 0;
+    int identical = 0;
+    int exceeding = 0;
+    int maxBits = 0;
+    long long totalBits = 0;
+    qint64 referenceNs = 0;
+    qint64 fastNs = 0;
+    QElapsedTimer timer;
+
+    for (const QString& imageFile : imageFiles) {
+        timer.start();
+        PHash reference = PHashCalculator::calculatePHash(imageFile);
+        referenceNs += timer.nsecsElapsed();
+
+        timer.restart();
+        PHash fast = PHashCalculator::calculatePHashFast(imageFile);
+        fastNs += timer.nsecsElapsed();
+
+        const int bits = PHashCalculator::hammingDistance(reference, fast);
+        if (bits < 0) {
+            failed++;
+            continue;
+        }
+        compared++;
+        totalBits += bits;
+        maxBits = std::max(maxBits, bits);
+        if (bits == 0) {
+            identical++;
+        }
+        if (bits > tolerance) {
+            exceeding++;
+            fprintf(stderr, "%s: fast and reference pHash differ in %d bits\n", qPrintable(imageFile), bits);
+        }
+    }
+
+    QJsonObject record;
+    record["benchmark"] = "phash-fast";
+    record["images"] = compared;
+    record["failed"] = failed;
+    record["identical"] = identical;
+    record["meanBitsDiffering"] = compared > 0 ? static_cast<double>(totalBits) / compared : 0.0;
+    record["maxBitsDiffering"] = maxBits;
+    record["tolerance"] = tolerance;
+    record["exceedingTolerance"] = exceeding;
+    record["referenceMsPerImage"] = imageFiles.isEmpty() ? 0.0 : referenceNs / 1e6 / imageFiles.size();
+    record["fastMsPerImage"] = imageFiles.isEmpty() ? 0.0 : fastNs / 1e6 / imageFiles.size();
+
+    QTextStream out(stdout);
+    out << QJsonDocument(record).toJson(QJsonDocument::Compact) << '\n';
+
+    return compared > 0 && exceeding == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Same organization as the GUI so both share persisted settings
+    app.setApplicationName("AutoSlides Extractor");
+    app.setApplicationVersion("1.1.0");
+    app.setOrganizationName("AutoSlidesExtractor");
+    app.setOrganizationDomain("autoslidesextractor.com");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Headless slide extractor. Writes one JSON object per video to stdout.\n"
+        "Exit status: 0 = all videos processed, 1 = at least one video failed, 2 = usage error.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("videos", "Video files to process.", "<video>...");
+
+    parser.addOptions({
+        {{"c", "config"}, "Load settings from an INI file (same keys as the GUI settings) instead of the saved GUI settings.", "file"},
+        {"defaults", "Ignore saved GUI settings and start from built-in defaults."},
+        {{"o", "output"}, "Base output directory.", "dir"},
+        {"ssim-preset", "SSIM preset: Strict, Normal, Loose or Custom.", "preset"},
+        {"ssim-threshold", "Custom SSIM threshold (implies --ssim-preset Custom).", "value"},
+        {"ssim-mode", "SSIM mode: Global (whole frame) or Tiled (lowest local tile score).", "mode"},
+        {"benchmark-ssim", "Time global against tiled SSIM at the configured downsample size, print one JSON object and exit."},
+        {"calibrate-ssim", "Score consecutive sampled frames of the given videos in global and tiled mode, report for each preset the tiled threshold that best reproduces the global change decisions, print one JSON object and exit (status 1 if a video fails to decode)."},
+        {"benchmark-phash", "Time the pHash index against a linear scan on 20000 synthetic hashes at the configured Hamming threshold, check the batch Hamming kernel against scalar popcount, print one JSON object and exit (status 1 if results differ). Image files or folders given as arguments are also hashed with the fast and the reference pHash; a second JSON object reports the differing bits (status 1 if any image differs by more than the Hamming threshold)."},
+        {"no-downsampling", "Compare frames at full resolution."},
+        {"downsample-width", "Downsample width for SSIM comparison.", "pixels"},
+        {"downsample-height", "Downsample height for SSIM comparison.", "pixels"},
+        {"chunk-size", "Frames per processing chunk.", "frames"},
+        {"queue-depth", "Decoded chunks buffered between decoding and slide detection.", "chunks"},
+        {"lock-free-queue", "Use the lock-free single-producer/single-consumer chunk queue."},
+        {"no-video-cache", "Re-analyze every video instead of reusing cached stream info and keyframe indexes."},
+        {"luma-detection", "Decode detection frames straight to detection-size luma instead of full-resolution BGR (experimental)."},
+        {"bgr-detection", "Decode every sampled frame to full-resolution BGR for slide detection (default)."},
+        {"redecode-slides", "With --luma-detection, drop decoded frames and re-decode selected slides from their keyframe to save memory."},
+        {"retain-decoded-frames", "Keep every decoded frame until its chunk is processed instead of re-decoding selected slides (default)."},
+        {{"j", "jobs"}, "Number of videos processed concurrently.", "count"},
+        {"decoder-threads", "Parallel decoders splitting each video at keyframes (1 = sequential).", "count"},
+        {"memory-budget", "Memory budget in MB for decoded frames across all videos (0 = unlimited).", "mb"},
+        {"jpeg-quality", "JPEG quality for saved slides (1-100).", "quality"},
+        {"writer-threads", "Threads encoding and writing slide JPEGs.", "count"},
+        {"no-post-processing", "Skip pHash and ML post-processing."},
+        {"reread-slides", "Post-process by re-reading saved slides instead of using features computed during extraction."},
+        {"hamming-threshold", "Hamming distance threshold for duplicate removal.", "bits"},
+        {"hash-threads", "Threads computing pHashes during post-processing (0 = one per core).", "count"},
+        {"no-hash-cache", "Recompute every pHash instead of reusing the per-folder hash cache."},
+        {"fast-phash", "Hash images from reduced-resolution JPEG decodes. Exclusion list entries are reference hashes, see --benchmark-phash."},
+        {"full-decode-phash", "Decode images at full resolution for pHash calculation (default)."},
+        {"no-ml", "Disable ML classification during post-processing."},
+        {"ml-model", "Path to the ONNX classification model.", "path"},
+        {"ml-provider", "ML execution provider: Auto, CoreML, CUDA, DirectML or CPU.", "provider"},
+        {"ml-batch-size", "Images per ML inference run.", "count"},
+        {"ml-preprocess-threads", "Threads preprocessing images for ML classification (0 = automatic).", "count"},
+        {"ml-full-decode", "Decode images at full resolution for ML classification."},
+        {"ml-intra-threads", "ONNX Runtime threads within an operator (0 = runtime default).", "count"},
+        {"ml-inter-threads", "ONNX Runtime threads across operators in parallel mode (0 = runtime default).", "count"},
+        {"ml-parallel", "Use the parallel ONNX Runtime execution mode."},
+        {"ml-no-arena", "Disable the ONNX Runtime CPU memory arena."},
+        {"ml-no-model-cache", "Do not cache the optimized ML model between runs."},
+    });
+
+    parser.process(app);
+
+    // Build configuration: built-in defaults, saved settings or INI file, then flags
+    AppConfig config;
+    QList<ExclusionEntry> exclusionList = PostProcessor::getDefaultExclusionList();
+
+    if (parser.isSet("config")) {
+        QString configFile = parser.value("config");
+        if (!QFileInfo::exists(configFile)) {
+            fprintf(stderr, "Config file not found: %s\n", qPrintable(configFile));
+            return CliRunner::ExitUsageError;
+        }
+        ConfigManager configManager(configFile);
+        config = configManager.loadConfig();
+        exclusionList = configManager.loadExclusionList();
+    } else if (!parser.isSet("defaults")) {
+        ConfigManager configManager;
+        config = configManager.loadConfig();
+        exclusionList = configManager.loadExclusionList();
+    }
+
+    if (parser.isSet("output")) {
+        config.outputDirectory = QDir(parser.value("output")).absolutePath();
+    }
+    if (parser.isSet("ssim-preset")) {
+        const QString preset = parser.value("ssim-preset");
+        const QStringList presetNames = {"Strict", "Normal", "Loose", "Custom"};
+        auto name = std::find_if(presetNames.cbegin(), presetNames.cend(), [&preset](const QString& candidate) {
+            return candidate.compare(preset, Qt::CaseInsensitive) == 0;
+        });
+        if (name == presetNames.cend()) {
+            fprintf(stderr, "Invalid value for --ssim-preset: %s\n", qPrintable(preset));
+            return CliRunner::ExitUsageError;
+        }
+        config.ssimPreset = ConfigManager::getPresetFromName(*name);
+    }
+    if (parser.isSet("ssim-threshold")) {
+        bool ok = false;
+        double threshold = parser.value("ssim-threshold").toDouble(&ok);
+        if (!ok || threshold <= 0.0 || threshold > 1.0) {
+            fprintf(stderr, "Invalid value for --ssim-threshold: %s\n",
+                    qPrintable(parser.value("ssim-threshold")));
+            return CliRunner::ExitUsageError;
+        }
+        config.ssimPreset = SSIMPreset::Custom;
+        config.customSSIMThreshold = threshold;
+    }
+    if (parser.isSet("ssim-mode")) {
+        const QString mode = parser.value("ssim-mode");
+        if (mode.compare("Global", Qt::CaseInsensitive) != 0 && mode.compare("Tiled", Qt::CaseInsensitive) != 0) {
+            fprintf(stderr, "Invalid value for --ssim-mode: %s\n", qPrintable(mode));
+            return CliRunner::ExitUsageError;
+        }
+        config.ssimMode = ConfigManager::getSSIMModeFromName(mode);
+    }
+    if (parser.isSet("no-downsampling")) {
+        config.enableDownsampling = false;
+    }
+    if (parser.isSet("lock-free-queue")) {
+        config.useLockFreeChunkQueue = true;
+    }
+    if (parser.isSet("no-video-cache")) {
+        config.enableVideoAnalysisCache = false;
+    }
+    if (parser.isSet("luma-detection")) {
+        config.lumaDetection = true;
+    }
+    if (parser.isSet("bgr-detection")) {
+        config.lumaDetection = false;
+    }
+    if (parser.isSet("redecode-slides")) {
+        config.redecodeSlideFrames = true;
+    }
+    if (parser.isSet("retain-decoded-frames")) {
+        config.redecodeSlideFrames = false;
+    }
+    if (parser.isSet("no-post-processing")) {
+        config.enablePostProcessing = false;
+    }
+    if (parser.isSet("no-hash-cache")) {
+        config.enableHashCache = false;
+    }
+    if (parser.isSet("fast-phash")) {
+        config.fastPHash = true;
+    }
+    if (parser.isSet("full-decode-phash")) {
+        config.fastPHash = false;
+    }
+    if (parser.isSet("reread-slides")) {
+        config.postProcessFromMemory = false;
+    }
+    if (parser.isSet("no-ml")) {
+        config.enableMLClassification = false;
+    }
+    if (parser.isSet("ml-model")) {
+        config.mlModelPath = parser.value("ml-model");
+    }
+    if (parser.isSet("ml-full-decode")) {
+        config.mlReducedDecode = false;
+    }
+    if (parser.isSet("ml-parallel")) {
+        config.mlParallelExecution = true;
+    }
+    if (parser.isSet("ml-no-arena")) {
+        config.mlEnableMemoryArena = false;
+    }
+    if (parser.isSet("ml-no-model-cache")) {
+        config.mlCacheOptimizedModel = false;
+    }
+    if (parser.isSet("ml-provider")) {
+        config.mlExecutionProvider = parser.value("ml-provider");
+    }
+
+    if (!readIntOption(parser, "downsample-width", config.downsampleWidth) ||
+        !readIntOption(parser, "downsample-height", config.downsampleHeight) ||
+        !readIntOption(parser, "chunk-size", config.chunkSize) ||
+        !readIntOption(parser, "queue-depth", config.chunkQueueDepth) ||
+        !readIntOption(parser, "jobs", config.maxConcurrentVideos) ||
+        !readIntOption(parser, "decoder-threads", config.decoderThreads) ||
+        !readIntOption(parser, "memory-budget", config.memoryBudgetMB) ||
+        !readIntOption(parser, "jpeg-quality", config.jpegQuality) ||
+        !readIntOption(parser, "writer-threads", config.slideWriterThreads) ||
+        !readIntOption(parser, "hamming-threshold", config.hammingThreshold) ||
+        !readIntOption(parser, "hash-threads", config.hashThreads) ||
+        !readIntOption(parser, "ml-batch-size", config.mlBatchSize) ||
+        !readIntOption(parser, "ml-preprocess-threads", config.mlPreprocessThreads) ||
+        !readIntOption(parser, "ml-intra-threads", config.mlIntraOpThreads) ||
+        !readIntOption(parser, "ml-inter-threads", config.mlInterOpThreads)) {
+        return CliRunner::ExitUsageError;
+    }
+
+    if (config.downsampleWidth < 1 || config.downsampleHeight < 1) {
+        fprintf(stderr, "Downsample width and height must be positive\n");
+        return CliRunner::ExitUsageError;
+    }
+
+    if (config.chunkSize < 1 || config.chunkQueueDepth < 1 || config.maxConcurrentVideos < 1 || config.decoderThreads < 1 ||
+        config.memoryBudgetMB < 0 || config.slideWriterThreads < 1 || config.mlBatchSize < 1 || config.mlPreprocessThreads < 0 ||
+        config.hashThreads < 0 || config.mlIntraOpThreads < 0 || config.mlInterOpThreads < 0 ||
+        config.jpegQuality < 1 || config.jpegQuality > 100) {
+        fprintf(stderr, "Chunk size, queue depth, jobs, decoder threads, writer threads and ML batch size must be positive, memory budget, hash threads and ML thread counts non-negative and JPEG quality within 1-100\n");
+        return CliRunner::ExitUsageError;
+    }
+
+    // Select SIMD kernels for this CPU before any worker thread starts; done after argument
+    // parsing so --help, --version and usage errors return immediately
+    SSIMKernels::initialize();
+
+    if (parser.isSet("benchmark-ssim")) {
+        benchmarkSSIMModes(config);
+        return CliRunner::ExitSuccess;
+    }
+    if (parser.isSet("calibrate-ssim")) {
+        if (parser.positionalArguments().isEmpty()) {
+            fprintf(stderr, "--calibrate-ssim needs at least one video\n");
+            return CliRunner::ExitUsageError;
+        }
+        return calibrateTiledThresholds(config, parser.positionalArguments()) ? CliRunner::ExitSuccess
+                                                                              : CliRunner::ExitVideoFailed;
+    }
+    if (parser.isSet("benchmark-phash")) {
+        const int radius = std::max(0, config.hammingThreshold);
+        bool matches = benchmarkPHashIndex(radius);
+        if (!parser.positionalArguments().isEmpty()) {
+            matches = compareFastPHash(parser.positionalArguments(), radius) && matches;
+        }
+        return matches ? CliRunner::ExitSuccess : CliRunner::ExitVideoFailed;
+    }
+
+    const QStringList videos = parser.positionalArguments();
+    if (videos.isEmpty()) {
+        fprintf(stderr, "No input videos given\n\n%s", qPrintable(parser.helpText()));
+        return CliRunner::ExitUsageError;
+    }
+
+    if (!QDir().mkpath(config.outputDirectory)) {
+        fprintf(stderr, "Cannot create output directory: %s\n", qPrintable(config.outputDirectory));
+        return CliRunner::ExitUsageError;
+    }
+
+    // Pick the fastest validated SSIM backend; the benchmark runs once per machine and is cached
+    OptimizationConfig optimizationConfig;
+    optimizationConfig.enableBenchmarking = true;
+    optimizationConfig.benchmarkCachePath = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+                                                .filePath("ssim_backend.cache").toStdString();
+    if (!OptimizationManager::getInstance().initialize(optimizationConfig)) {
+        qWarning() << "OptimizationManager:" << QString::fromStdString(OptimizationManager::getInstance().getErrorMessage());
+    }
+
+    CliRunner runner(config, exclusionList);
+    if (!runner.start(videos)) {
+        return CliRunner::ExitVideoFailed;
+    }
+
+    return app.exec();
+}
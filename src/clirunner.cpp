@@ -0,0 +1,198 @@
+#include "clirunner.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QDebug>
+#include <cstdio>
+
+CliRunner::CliRunner(const AppConfig& config,
+                     const QList<ExclusionEntry>& exclusionList,
+                     QObject *parent)
+    : QObject(parent),
+      m_config(config),
+      m_exclusionList(exclusionList),
+      m_out(stdout),
+      m_completedCount(0),
+      m_failedCount(0),
+      m_totalSlides(0)
+{
+    m_videoQueue = std::make_unique<VideoQueue>();
+    m_processingThread = std::make_unique<ProcessingThread>(m_videoQueue.get());
+
+    // Signals are emitted from the worker thread and delivered queued to this object
+    connect(m_processingThread.get(), &ProcessingThread::videoProcessingStarted,
+            this, &CliRunner::onVideoProcessingStarted);
+    connect(m_processingThread.get(), &ProcessingThread::videoProcessingCompleted,
+            this, &CliRunner::onVideoProcessingCompleted);
+    connect(m_processingThread.get(), &ProcessingThread::videoProcessingError,
+            this, &CliRunner::onVideoProcessingError);
+    connect(m_processingThread.get(), &ProcessingThread::videoInfoLogged,
+            this, &CliRunner::onVideoInfoLogged);
+    connect(m_processingThread.get(), &ProcessingThread::processingStopped,
+            this, &CliRunner::onProcessingStopped);
+}
+
+CliRunner::~CliRunner()
+{
+    // Make sure the worker is gone before the queue it points to
+    m_processingThread.reset();
+
+    MLClassifier::releaseShared();
+}
+
+bool CliRunner::start(const QStringList& videoPaths)
+{
+    for (const QString& path : videoPaths) {
+        QString absolutePath = QFileInfo(path).absoluteFilePath();
+        if (m_videoQueue->addVideo(absolutePath) < 0) {
+            qWarning() << "Skipping (missing or duplicate):" << path;
+
+            QJsonObject record;
+            record["video"] = absolutePath;
+            record["status"] = "error";
+            record["error"] = "File not found or already queued";
+            writeRecord(record);
+            m_failedCount++;
+        }
+    }
+
+    if (m_videoQueue->isEmpty()) {
+        return false;
+    }
+
+    m_batchTimer.start();
+    m_processingThread->updateConfig(m_config);
+    m_processingThread->startProcessing();
+    return true;
+}
+
+int CliRunner::exitCode() const
+{
+    return m_failedCount > 0 ? ExitVideoFailed : ExitSuccess;
+}
+
+void CliRunner::onVideoProcessingStarted(int videoIndex)
+{
+    m_videoStartMs[videoIndex] = m_batchTimer.elapsed();
+
+    VideoQueueItem* video = m_videoQueue->getVideo(videoIndex);
+    if (video) {
+        qInfo().noquote() << "Processing:" << video->filePath;
+    }
+}
+
+void CliRunner::onVideoProcessingCompleted(int videoIndex, int slidesExtracted)
+{
+    VideoQueueItem* video = m_videoQueue->getVideo(videoIndex);
+    if (!video) {
+        return;
+    }
+
+    double postProcessingSeconds = runPostProcessing(videoIndex, video);
+    double wallSeconds = (m_batchTimer.elapsed() - m_videoStartMs.value(videoIndex, 0)) / 1000.0;
+
+    QJsonObject record;
+    record["video"] = video->filePath;
+    record["status"] = "completed";
+    record["outputDirectory"] = video->outputDirectory;
+    record["slidesExtracted"] = slidesExtracted;
+    record["slidesKept"] = slidesExtracted - video->movedToTrash;
+    record["removedByPHash"] = video->movedByPHash;
+    record["removedByML"] = video->movedByML;
+    record["extractionSeconds"] = video->processingTimeSeconds;
+    record["postProcessingSeconds"] = postProcessingSeconds;
+    record["totalSeconds"] = wallSeconds;
+    writeRecord(record);
+
+    m_completedCount++;
+    m_totalSlides += slidesExtracted - video->movedToTrash;
+}
+
+void CliRunner::onVideoProcessingError(int videoIndex, const QString& error)
+{
+    VideoQueueItem* video = m_videoQueue->getVideo(videoIndex);
+    double wallSeconds = (m_batchTimer.elapsed() - m_videoStartMs.value(videoIndex, 0)) / 1000.0;
+
+    QJsonObject record;
+    record["video"] = video ? video->filePath : QString();
+    record["status"] = "error";
+    record["error"] = error;
+    record["totalSeconds"] = wallSeconds;
+    writeRecord(record);
+
+    m_failedCount++;
+}
+
+void CliRunner::onVideoInfoLogged(int videoIndex, const QString& info)
+{
+    Q_UNUSED(videoIndex)
+    qInfo().noquote() << info;
+}
+
+void CliRunner::onProcessingStopped()
+{
+    QJsonObject summary;
+    summary["summary"] = true;
+    summary["videosCompleted"] = m_completedCount;
+    summary["videosFailed"] = m_failedCount;
+    summary["slidesKept"] = m_totalSlides;
+    summary["totalSeconds"] = m_batchTimer.elapsed() / 1000.0;
+    writeRecord(summary);
+
+    QCoreApplication::exit(exitCode());
+}
+
+double CliRunner::runPostProcessing(int videoIndex, VideoQueueItem* video)
+{
+    if (!m_config.enablePostProcessing || video->outputDirectory.isEmpty()) {
+        return 0.0;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    PostProcessor processor;
+    processor.setMLOptions(ConfigManager::getMLClassifierOptions(m_config));
+    processor.setHashThreads(m_config.hashThreads);
+    processor.setHashCacheEnabled(m_config.enableHashCache);
+    processor.setFastPHash(m_config.fastPHash);
+
+    connect(&processor, &PostProcessor::mlClassificationStarted, this, [](const QString& executionProvider) {
+        qInfo().noquote() << QString("ML Classification: Enabled (Using %1)").arg(executionProvider);
+    });
+    connect(&processor, &PostProcessor::mlClassificationFailed, this, [](const QString& errorMessage) {
+        qWarning().noquote() << QString("ML Classification: Failed - %1").arg(errorMessage);
+    });
+
+    PostProcessingResult result = processor.processDirectory(
+        video->outputDirectory,
+        m_config.deleteRedundant,
+        m_config.compareExcluded,
+        m_config.hammingThreshold,
+        m_exclusionList,
+        m_config.enableMLClassification,
+        m_config.mlModelPath,
+        m_config.mlNotSlideHighThreshold,
+        m_config.mlNotSlideLowThreshold,
+        m_config.mlMaybeSlideHighThreshold,
+        m_config.mlMaybeSlideLowThreshold,
+        m_config.mlSlideMaxThreshold,
+        m_config.mlDeleteMaybeSlides,
+        m_config.mlExecutionProvider,
+        true,  // useApplicationTrash
+        m_config.outputDirectory,
+        m_processingThread->takeSlideFeatures(videoIndex)
+    );
+
+    video->movedToTrash = result.totalRemoved;
+    video->movedByPHash = result.removedByPHash;
+    video->movedByML = result.removedByML;
+
+    return timer.elapsed() / 1000.0;
+}
+
+void CliRunner::writeRecord(const QJsonObject& object)
+{
+    m_out << QJsonDocument(object).toJson(QJsonDocument::Compact) << '\n';
+    m_out.flush();
+}
@@ -0,0 +1,100 @@
+#ifndef CLIRUNNER_H
+#define CLIRUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QTextStream>
+#include <memory>
+#include "configmanager.h"
+#include "videoqueue.h"
+#include "processingthread.h"
+#include "postprocessor.h"
+
+/**
+ * @brief Headless batch driver for the extraction pipeline
+ *
+ * Feeds a list of videos through the same VideoQueue/ProcessingThread pipeline
+ * used by MainWindow, runs PostProcessor on each finished output directory and
+ * writes one JSON object per video (plus a final summary) to stdout.
+ * Diagnostics go to stderr so stdout stays machine-readable.
+ */
+class CliRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Process exit codes reported by the command-line tool
+     */
+    enum ExitCode {
+        ExitSuccess = 0,        // All videos processed
+        ExitVideoFailed = 1,    // At least one video failed
+        ExitUsageError = 2      // Invalid arguments or no input
+    };
+
+    /**
+     * @brief Constructor
+     * @param config Processing configuration
+     * @param exclusionList Exclusion list used by post-processing
+     * @param parent Parent object
+     */
+    CliRunner(const AppConfig& config,
+              const QList<ExclusionEntry>& exclusionList,
+              QObject *parent = nullptr);
+    ~CliRunner();
+
+    /**
+     * @brief Queue the videos and start processing
+     * The runner quits the application event loop with the resulting exit code when done
+     * @param videoPaths Video files to process
+     * @return true if processing was started
+     */
+    bool start(const QStringList& videoPaths);
+
+    /**
+     * @brief Exit code for the finished batch
+     * @return ExitSuccess if every video completed, ExitVideoFailed otherwise
+     */
+    int exitCode() const;
+
+private slots:
+    void onVideoProcessingStarted(int videoIndex);
+    void onVideoProcessingCompleted(int videoIndex, int slidesExtracted);
+    void onVideoProcessingError(int videoIndex, const QString& error);
+    void onVideoInfoLogged(int videoIndex, const QString& info);
+    void onProcessingStopped();
+
+private:
+    /**
+     * @brief Run post-processing on a finished video's output directory
+     * @param videoIndex Index of the video in the queue
+     * @param video Video item whose slides should be post-processed
+     * @return Seconds spent in post-processing
+     */
+    double runPostProcessing(int videoIndex, VideoQueueItem* video);
+
+    /**
+     * @brief Write a single JSON line to stdout
+     * @param object JSON object to write
+     */
+    void writeRecord(const QJsonObject& object);
+
+    AppConfig m_config;
+    QList<ExclusionEntry> m_exclusionList;
+    std::unique_ptr<VideoQueue> m_videoQueue;
+    std::unique_ptr<ProcessingThread> m_processingThread;
+    QTextStream m_out;
+
+    QElapsedTimer m_batchTimer;
+    QHash<int, qint64> m_videoStartMs;   // Per-video start time relative to m_batchTimer
+    int m_completedCount;
+    int m_failedCount;
+    int m_totalSlides;
+};
+
+#endif // CLIRUNNER_H
@@ -1,5 +1,6 @@
 #include "configmanager.h"
 #include "postprocessor.h"
+#include "mlclassifier.h"
 #include <QDir>
 #include <QCoreApplication>
 
@@ -8,17 +9,31 @@ const QString ConfigManager::KEY_OUTPUT_DIR = "outputDirectory";
 const QString ConfigManager::KEY_FRAME_INTERVAL = "frameInterval";
 const QString ConfigManager::KEY_SSIM_PRESET = "ssimPreset";
 const QString ConfigManager::KEY_CUSTOM_SSIM_THRESHOLD = "customSSIMThreshold";
+const QString ConfigManager::KEY_SSIM_MODE = "ssimMode";
 const QString ConfigManager::KEY_ENABLE_VERIFICATION = "enableVerification";
 const QString ConfigManager::KEY_VERIFICATION_COUNT = "verificationCount";
 const QString ConfigManager::KEY_ENABLE_DOWNSAMPLING = "enableDownsampling";
 const QString ConfigManager::KEY_DOWNSAMPLE_WIDTH = "downsampleWidth";
 const QString ConfigManager::KEY_DOWNSAMPLE_HEIGHT = "downsampleHeight";
 const QString ConfigManager::KEY_CHUNK_SIZE = "chunkSize";
+const QString ConfigManager::KEY_CHUNK_QUEUE_DEPTH = "chunkQueueDepth";
+const QString ConfigManager::KEY_USE_LOCK_FREE_CHUNK_QUEUE = "useLockFreeChunkQueue";
+const QString ConfigManager::KEY_ENABLE_VIDEO_ANALYSIS_CACHE = "enableVideoAnalysisCache";
+const QString ConfigManager::KEY_LUMA_DETECTION = "lumaDetection";
+const QString ConfigManager::KEY_REDECODE_SLIDE_FRAMES = "redecodeSlideFrames";
+const QString ConfigManager::KEY_MAX_CONCURRENT_VIDEOS = "maxConcurrentVideos";
+const QString ConfigManager::KEY_DECODER_THREADS = "decoderThreads";
+const QString ConfigManager::KEY_MEMORY_BUDGET_MB = "memoryBudgetMB";
 const QString ConfigManager::KEY_JPEG_QUALITY = "jpegQuality";
+const QString ConfigManager::KEY_SLIDE_WRITER_THREADS = "slideWriterThreads";
 const QString ConfigManager::KEY_ENABLE_POST_PROCESSING = "enablePostProcessing";
 const QString ConfigManager::KEY_DELETE_REDUNDANT = "deleteRedundant";
 const QString ConfigManager::KEY_COMPARE_EXCLUDED = "compareExcluded";
 const QString ConfigManager::KEY_HAMMING_THRESHOLD = "hammingThreshold";
+const QString ConfigManager::KEY_HASH_THREADS = "hashThreads";
+const QString ConfigManager::KEY_ENABLE_HASH_CACHE = "enableHashCache";
+const QString ConfigManager::KEY_FAST_PHASH = "fastPHash";
+const QString ConfigManager::KEY_POST_PROCESS_FROM_MEMORY = "postProcessFromMemory";
 const QString ConfigManager::KEY_EXCLUSION_LIST_SIZE = "exclusionListSize";
 const QString ConfigManager::KEY_EXCLUSION_REMARK = "exclusionRemark";
 const QString ConfigManager::KEY_EXCLUSION_HASH = "exclusionHash";
@@ -26,6 +41,14 @@ const QString ConfigManager::KEY_ENABLE_ML_CLASSIFICATION = "enableMLClassificat
 const QString ConfigManager::KEY_ML_DELETE_MAYBE_SLIDES = "mlDeleteMaybeSlides";
 const QString ConfigManager::KEY_ML_MODEL_PATH = "mlModelPath";
 const QString ConfigManager::KEY_ML_EXECUTION_PROVIDER = "mlExecutionProvider";
+const QString ConfigManager::KEY_ML_BATCH_SIZE = "mlBatchSize";
+const QString ConfigManager::KEY_ML_PREPROCESS_THREADS = "mlPreprocessThreads";
+const QString ConfigManager::KEY_ML_REDUCED_DECODE = "mlReducedDecode";
+const QString ConfigManager::KEY_ML_INTRA_OP_THREADS = "mlIntraOpThreads";
+const QString ConfigManager::KEY_ML_INTER_OP_THREADS = "mlInterOpThreads";
+const QString ConfigManager::KEY_ML_PARALLEL_EXECUTION = "mlParallelExecution";
+const QString ConfigManager::KEY_ML_ENABLE_MEMORY_ARENA = "mlEnableMemoryArena";
+const QString ConfigManager::KEY_ML_CACHE_OPTIMIZED_MODEL = "mlCacheOptimizedModel";
 const QString ConfigManager::KEY_ML_NOT_SLIDE_HIGH_THRESHOLD = "mlNotSlideHighThreshold";
 const QString ConfigManager::KEY_ML_NOT_SLIDE_LOW_THRESHOLD = "mlNotSlideLowThreshold";
 const QString ConfigManager::KEY_ML_MAYBE_SLIDE_HIGH_THRESHOLD = "mlMaybeSlideHighThreshold";
@@ -39,6 +62,12 @@ ConfigManager::ConfigManager(QObject *parent)
     m_settings = new QSettings("AutoSlidesExtractor", "AutoSlidesExtractor", this);
 }
 
+ConfigManager::ConfigManager(const QString& settingsFile, QObject *parent)
+    : QObject(parent)
+{
+    m_settings = new QSettings(settingsFile, QSettings::IniFormat, this);
+}
+
 AppConfig ConfigManager::loadConfig()
 {
     AppConfig config;
@@ -50,6 +79,7 @@ AppConfig ConfigManager::loadConfig()
     config.ssimPreset = getPresetFromName(presetName);
 
     config.customSSIMThreshold = m_settings->value(KEY_CUSTOM_SSIM_THRESHOLD, config.customSSIMThreshold).toDouble();
+    config.ssimMode = getSSIMModeFromName(m_settings->value(KEY_SSIM_MODE, getSSIMModeName(config.ssimMode)).toString());
     // Verification settings are now hardcoded (enableVerification=true, verificationCount=3)
     config.enableVerification = true;
     config.verificationCount = 3;
@@ -57,19 +87,40 @@ AppConfig ConfigManager::loadConfig()
     config.downsampleWidth = m_settings->value(KEY_DOWNSAMPLE_WIDTH, config.downsampleWidth).toInt();
     config.downsampleHeight = m_settings->value(KEY_DOWNSAMPLE_HEIGHT, config.downsampleHeight).toInt();
     config.chunkSize = m_settings->value(KEY_CHUNK_SIZE, config.chunkSize).toInt();
+    config.chunkQueueDepth = m_settings->value(KEY_CHUNK_QUEUE_DEPTH, config.chunkQueueDepth).toInt();
+    config.useLockFreeChunkQueue = m_settings->value(KEY_USE_LOCK_FREE_CHUNK_QUEUE, config.useLockFreeChunkQueue).toBool();
+    config.enableVideoAnalysisCache = m_settings->value(KEY_ENABLE_VIDEO_ANALYSIS_CACHE, config.enableVideoAnalysisCache).toBool();
+    config.lumaDetection = m_settings->value(KEY_LUMA_DETECTION, config.lumaDetection).toBool();
+    config.redecodeSlideFrames = m_settings->value(KEY_REDECODE_SLIDE_FRAMES, config.redecodeSlideFrames).toBool();
+    config.maxConcurrentVideos = m_settings->value(KEY_MAX_CONCURRENT_VIDEOS, config.maxConcurrentVideos).toInt();
+    config.decoderThreads = m_settings->value(KEY_DECODER_THREADS, config.decoderThreads).toInt();
+    config.memoryBudgetMB = m_settings->value(KEY_MEMORY_BUDGET_MB, config.memoryBudgetMB).toInt();
     config.jpegQuality = m_settings->value(KEY_JPEG_QUALITY, config.jpegQuality).toInt();
+    config.slideWriterThreads = m_settings->value(KEY_SLIDE_WRITER_THREADS, config.slideWriterThreads).toInt();
 
     // Load post-processing settings
     config.enablePostProcessing = m_settings->value(KEY_ENABLE_POST_PROCESSING, config.enablePostProcessing).toBool();
     config.deleteRedundant = m_settings->value(KEY_DELETE_REDUNDANT, config.deleteRedundant).toBool();
     config.compareExcluded = m_settings->value(KEY_COMPARE_EXCLUDED, config.compareExcluded).toBool();
     config.hammingThreshold = m_settings->value(KEY_HAMMING_THRESHOLD, config.hammingThreshold).toInt();
+    config.hashThreads = m_settings->value(KEY_HASH_THREADS, config.hashThreads).toInt();
+    config.enableHashCache = m_settings->value(KEY_ENABLE_HASH_CACHE, config.enableHashCache).toBool();
+    config.fastPHash = m_settings->value(KEY_FAST_PHASH, config.fastPHash).toBool();
+    config.postProcessFromMemory = m_settings->value(KEY_POST_PROCESS_FROM_MEMORY, config.postProcessFromMemory).toBool();
 
     // Load ML classification settings
     config.enableMLClassification = m_settings->value(KEY_ENABLE_ML_CLASSIFICATION, config.enableMLClassification).toBool();
     config.mlDeleteMaybeSlides = m_settings->value(KEY_ML_DELETE_MAYBE_SLIDES, config.mlDeleteMaybeSlides).toBool();
     config.mlModelPath = m_settings->value(KEY_ML_MODEL_PATH, config.mlModelPath).toString();
     config.mlExecutionProvider = m_settings->value(KEY_ML_EXECUTION_PROVIDER, config.mlExecutionProvider).toString();
+    config.mlBatchSize = m_settings->value(KEY_ML_BATCH_SIZE, config.mlBatchSize).toInt();
+    config.mlPreprocessThreads = m_settings->value(KEY_ML_PREPROCESS_THREADS, config.mlPreprocessThreads).toInt();
+    config.mlReducedDecode = m_settings->value(KEY_ML_REDUCED_DECODE, config.mlReducedDecode).toBool();
+    config.mlIntraOpThreads = m_settings->value(KEY_ML_INTRA_OP_THREADS, config.mlIntraOpThreads).toInt();
+    config.mlInterOpThreads = m_settings->value(KEY_ML_INTER_OP_THREADS, config.mlInterOpThreads).toInt();
+    config.mlParallelExecution = m_settings->value(KEY_ML_PARALLEL_EXECUTION, config.mlParallelExecution).toBool();
+    config.mlEnableMemoryArena = m_settings->value(KEY_ML_ENABLE_MEMORY_ARENA, config.mlEnableMemoryArena).toBool();
+    config.mlCacheOptimizedModel = m_settings->value(KEY_ML_CACHE_OPTIMIZED_MODEL, config.mlCacheOptimizedModel).toBool();
     config.mlNotSlideHighThreshold = m_settings->value(KEY_ML_NOT_SLIDE_HIGH_THRESHOLD, config.mlNotSlideHighThreshold).toFloat();
     config.mlNotSlideLowThreshold = m_settings->value(KEY_ML_NOT_SLIDE_LOW_THRESHOLD, config.mlNotSlideLowThreshold).toFloat();
     config.mlMaybeSlideHighThreshold = m_settings->value(KEY_ML_MAYBE_SLIDE_HIGH_THRESHOLD, config.mlMaybeSlideHighThreshold).toFloat();
@@ -90,24 +141,46 @@ void ConfigManager::saveConfig(const AppConfig& config)
     m_settings->setValue(KEY_FRAME_INTERVAL, config.frameInterval);
     m_settings->setValue(KEY_SSIM_PRESET, getPresetName(config.ssimPreset));
     m_settings->setValue(KEY_CUSTOM_SSIM_THRESHOLD, config.customSSIMThreshold);
+    m_settings->setValue(KEY_SSIM_MODE, getSSIMModeName(config.ssimMode));
     // Verification settings are now hardcoded, no need to save them
     m_settings->setValue(KEY_ENABLE_DOWNSAMPLING, config.enableDownsampling);
     m_settings->setValue(KEY_DOWNSAMPLE_WIDTH, config.downsampleWidth);
     m_settings->setValue(KEY_DOWNSAMPLE_HEIGHT, config.downsampleHeight);
     m_settings->setValue(KEY_CHUNK_SIZE, config.chunkSize);
+    m_settings->setValue(KEY_CHUNK_QUEUE_DEPTH, config.chunkQueueDepth);
+    m_settings->setValue(KEY_USE_LOCK_FREE_CHUNK_QUEUE, config.useLockFreeChunkQueue);
+    m_settings->setValue(KEY_ENABLE_VIDEO_ANALYSIS_CACHE, config.enableVideoAnalysisCache);
+    m_settings->setValue(KEY_LUMA_DETECTION, config.lumaDetection);
+    m_settings->setValue(KEY_REDECODE_SLIDE_FRAMES, config.redecodeSlideFrames);
+    m_settings->setValue(KEY_MAX_CONCURRENT_VIDEOS, config.maxConcurrentVideos);
+    m_settings->setValue(KEY_DECODER_THREADS, config.decoderThreads);
+    m_settings->setValue(KEY_MEMORY_BUDGET_MB, config.memoryBudgetMB);
     m_settings->setValue(KEY_JPEG_QUALITY, config.jpegQuality);
+    m_settings->setValue(KEY_SLIDE_WRITER_THREADS, config.slideWriterThreads);
 
     // Save post-processing settings
     m_settings->setValue(KEY_ENABLE_POST_PROCESSING, config.enablePostProcessing);
     m_settings->setValue(KEY_DELETE_REDUNDANT, config.deleteRedundant);
     m_settings->setValue(KEY_COMPARE_EXCLUDED, config.compareExcluded);
     m_settings->setValue(KEY_HAMMING_THRESHOLD, config.hammingThreshold);
+    m_settings->setValue(KEY_HASH_THREADS, config.hashThreads);
+    m_settings->setValue(KEY_ENABLE_HASH_CACHE, config.enableHashCache);
+    m_settings->setValue(KEY_FAST_PHASH, config.fastPHash);
+    m_settings->setValue(KEY_POST_PROCESS_FROM_MEMORY, config.postProcessFromMemory);
 
     // Save ML classification settings
     m_settings->setValue(KEY_ENABLE_ML_CLASSIFICATION, config.enableMLClassification);
     m_settings->setValue(KEY_ML_DELETE_MAYBE_SLIDES, config.mlDeleteMaybeSlides);
     m_settings->setValue(KEY_ML_MODEL_PATH, config.mlModelPath);
     m_settings->setValue(KEY_ML_EXECUTION_PROVIDER, config.mlExecutionProvider);
+    m_settings->setValue(KEY_ML_BATCH_SIZE, config.mlBatchSize);
+    m_settings->setValue(KEY_ML_PREPROCESS_THREADS, config.mlPreprocessThreads);
+    m_settings->setValue(KEY_ML_REDUCED_DECODE, config.mlReducedDecode);
+    m_settings->setValue(KEY_ML_INTRA_OP_THREADS, config.mlIntraOpThreads);
+    m_settings->setValue(KEY_ML_INTER_OP_THREADS, config.mlInterOpThreads);
+    m_settings->setValue(KEY_ML_PARALLEL_EXECUTION, config.mlParallelExecution);
+    m_settings->setValue(KEY_ML_ENABLE_MEMORY_ARENA, config.mlEnableMemoryArena);
+    m_settings->setValue(KEY_ML_CACHE_OPTIMIZED_MODEL, config.mlCacheOptimizedModel);
     m_settings->setValue(KEY_ML_NOT_SLIDE_HIGH_THRESHOLD, config.mlNotSlideHighThreshold);
     m_settings->setValue(KEY_ML_NOT_SLIDE_LOW_THRESHOLD, config.mlNotSlideLowThreshold);
     m_settings->setValue(KEY_ML_MAYBE_SLIDE_HIGH_THRESHOLD, config.mlMaybeSlideHighThreshold);
@@ -119,8 +192,28 @@ void ConfigManager::saveConfig(const AppConfig& config)
     m_settings->sync();
 }
 
-double ConfigManager::getSSIMThreshold(SSIMPreset preset, double customValue)
+double ConfigManager::getSSIMThreshold(SSIMPreset preset, double customValue, SSIMMode mode)
 {
+    // Tiled scores are the worst tile's SSIM, so a real change drops them far below these
+    // values while compression noise does not; no need for thresholds near 1.0.
+    // Provisional: re-check them against the global presets on a set of lecture videos with
+    // `autoslides-cli --calibrate-ssim <videos>`, which reports for each preset the tiled
+    // threshold whose change decisions on consecutive sampled frames best match global mode.
+    if (mode == SSIMMode::Tiled) {
+        switch (preset) {
+            case SSIMPreset::Strict:
+                return 0.90;
+            case SSIMPreset::Normal:
+                return 0.85;
+            case SSIMPreset::Loose:
+                return 0.80;
+            case SSIMPreset::Custom:
+                return customValue;
+            default:
+                return 0.85;
+        }
+    }
+
     switch (preset) {
         case SSIMPreset::Strict:
             return 0.999;
@@ -135,6 +228,11 @@ double ConfigManager::getSSIMThreshold(SSIMPreset preset, double customValue)
     }
 }
 
+double ConfigManager::getMinimumCustomSSIMThreshold(SSIMMode mode)
+{
+    return mode == SSIMMode::Tiled ? 0.500 : 0.900;
+}
+
 QString ConfigManager::getPresetName(SSIMPreset preset)
 {
     switch (preset) {
@@ -166,6 +264,39 @@ SSIMPreset ConfigManager::getPresetFromName(const QString& name)
     }
 }
 
+QString ConfigManager::getSSIMModeName(SSIMMode mode)
+{
+    switch (mode) {
+        case SSIMMode::Tiled:
+            return "Tiled";
+        case SSIMMode::Global:
+        default:
+            return "Global";
+    }
+}
+
+SSIMMode ConfigManager::getSSIMModeFromName(const QString& name)
+{
+    if (name.compare("Tiled", Qt::CaseInsensitive) == 0) {
+        return SSIMMode::Tiled;
+    }
+    return SSIMMode::Global;
+}
+
+MLClassifierOptions ConfigManager::getMLClassifierOptions(const AppConfig& config)
+{
+    MLClassifierOptions options;
+    options.batchSize = config.mlBatchSize;
+    options.preprocessThreads = config.mlPreprocessThreads;
+    options.reducedDecode = config.mlReducedDecode;
+    options.intraOpThreads = config.mlIntraOpThreads;
+    options.interOpThreads = config.mlInterOpThreads;
+    options.parallelExecution = config.mlParallelExecution;
+    options.enableMemoryArena = config.mlEnableMemoryArena;
+    options.cacheOptimizedModel = config.mlCacheOptimizedModel;
+    return options;
+}
+
 QList<ExclusionEntry> ConfigManager::loadExclusionList()
 {
     QList<ExclusionEntry> list;
@@ -14,35 +14,68 @@ enum class SSIMPreset {
     Custom
 };
 
-// Forward declaration
+enum class SSIMMode {
+    Global,     // One SSIM over the whole downsampled frame
+    Tiled       // Lowest SSIM over ~16x16 pixel tiles of the downsampled frame
+};
+
+// Forward declarations
 struct ExclusionEntry;
+struct MLClassifierOptions;
 
 struct AppConfig {
     QString outputDirectory;
     double frameInterval;
     SSIMPreset ssimPreset;
     double customSSIMThreshold;
+    SSIMMode ssimMode;          // Global or tiled (local) SSIM; presets map to per-mode thresholds
     bool enableVerification;
     int verificationCount;
     bool enableDownsampling;
     int downsampleWidth;
     int downsampleHeight;
     int chunkSize;
+    int chunkQueueDepth;        // Decoded chunks buffered between decoder and detector (default: 2)
+    bool useLockFreeChunkQueue; // Use the lock-free SPSC ring buffer for the chunk handoff
+    bool enableVideoAnalysisCache; // Reuse stream info and keyframe index of unchanged videos
+    bool lumaDetection;         // Decode detection frames as luma at detection size, BGR only for slides (off: swscale
+                                // SWS_AREA resampling is not yet shown to select the same slides as INTER_AREA)
+    bool redecodeSlideFrames;   // With luma detection, re-decode selected slides instead of keeping decoded frames (opt-in)
+
+    // Concurrency settings
+    int maxConcurrentVideos;   // Number of videos processed in parallel (default: 1)
+    int decoderThreads;        // Parallel decoders splitting each video at keyframes, 1 = sequential
+    int memoryBudgetMB;        // Budget for decoded frames across all videos, 0 = unlimited
 
     // Output settings
     int jpegQuality;
+    int slideWriterThreads;     // Threads encoding and writing slide JPEGs (default: 2)
 
     // Post-processing settings
     bool enablePostProcessing;
     bool deleteRedundant;
     bool compareExcluded;
     int hammingThreshold;
+    int hashThreads;             // Threads computing pHashes during post-processing, 0 = automatic
+    bool enableHashCache;        // Reuse pHashes of unchanged images from a per-folder cache file
+    bool fastPHash;              // Hash from reduced-resolution JPEG decodes (off: exclusion entries are reference hashes)
+    bool postProcessFromMemory;  // Compute pHash / ML inputs from in-memory slides during extraction
 
     // ML Classification settings
     bool enableMLClassification;
     bool mlDeleteMaybeSlides;  // true = delete may_be_slide images (default: true)
     QString mlModelPath;
     QString mlExecutionProvider;
+    int mlBatchSize;                 // Images per ONNX inference run (default: 8)
+    int mlPreprocessThreads;         // Image preprocessing threads, 0 = automatic
+    bool mlReducedDecode;            // Decode large JPEGs at reduced resolution for ML input
+
+    // ONNX Runtime session settings
+    int mlIntraOpThreads;            // Threads within an operator, 0 = ONNX Runtime default
+    int mlInterOpThreads;            // Threads across operators (parallel mode only), 0 = default
+    bool mlParallelExecution;        // Run independent graph branches in parallel
+    bool mlEnableMemoryArena;        // Use the CPU memory arena allocator
+    bool mlCacheOptimizedModel;      // Reuse the graph-optimized model across application starts
 
     // 2-stage classification thresholds for not_slide
     float mlNotSlideHighThreshold;   // High confidence: delete if >= this (default: 0.9)
@@ -61,21 +94,43 @@ struct AppConfig {
         frameInterval(2.0),
         ssimPreset(SSIMPreset::Normal),
         customSSIMThreshold(0.9985),
+        ssimMode(SSIMMode::Global),
         enableVerification(true),
         verificationCount(3),
         enableDownsampling(true),
         downsampleWidth(480),
         downsampleHeight(270),
         chunkSize(100),
+        chunkQueueDepth(2),
+        useLockFreeChunkQueue(false),
+        enableVideoAnalysisCache(true),
+        lumaDetection(false),
+        redecodeSlideFrames(false),
+        maxConcurrentVideos(1),
+        decoderThreads(1),
+        memoryBudgetMB(4096),
         jpegQuality(95),
+        slideWriterThreads(2),
         enablePostProcessing(true),
         deleteRedundant(true),
         compareExcluded(true),
         hammingThreshold(10),
+        hashThreads(0),
+        enableHashCache(true),
+        fastPHash(false),
+        postProcessFromMemory(true),
         enableMLClassification(true),
         mlDeleteMaybeSlides(true),  // Default: delete may_be_slide images
         mlModelPath(":/models/resources/models/slide_classifier_mobilenetv4_v1.onnx"),
         mlExecutionProvider("Auto"),
+        mlBatchSize(8),
+        mlPreprocessThreads(0),
+        mlReducedDecode(true),
+        mlIntraOpThreads(0),
+        mlInterOpThreads(0),
+        mlParallelExecution(false),
+        mlEnableMemoryArena(true),
+        mlCacheOptimizedModel(true),
         mlNotSlideHighThreshold(0.9f),   // High confidence threshold
         mlNotSlideLowThreshold(0.75f),   // Low confidence boundary
         mlMaybeSlideHighThreshold(0.9f), // High confidence threshold
@@ -92,6 +147,14 @@ class ConfigManager : public QObject
 public:
     explicit ConfigManager(QObject *parent = nullptr);
 
+    /**
+     * Create a config manager backed by an INI file instead of the platform settings store
+     * Uses the same keys as the GUI settings, so a file written by saveConfig() can be reused
+     * @param settingsFile Path to the INI file
+     * @param parent Parent object
+     */
+    explicit ConfigManager(const QString& settingsFile, QObject *parent = nullptr);
+
     /**
      * Load configuration from persistent storage
      * @return AppConfig structure with loaded settings
@@ -108,9 +171,18 @@ public:
      * Get SSIM threshold value based on preset
      * @param preset SSIM preset type
      * @param customValue Custom threshold value (used when preset is Custom)
+     * @param mode SSIM mode the threshold applies to (tiled scores run much lower)
      * @return SSIM threshold value
      */
-    static double getSSIMThreshold(SSIMPreset preset, double customValue = 0.9985);
+    static double getSSIMThreshold(SSIMPreset preset, double customValue = 0.9985,
+                                   SSIMMode mode = SSIMMode::Global);
+
+    /**
+     * Get the lowest custom SSIM threshold offered for a mode
+     * @param mode SSIM mode the threshold applies to
+     * @return Minimum custom threshold value
+     */
+    static double getMinimumCustomSSIMThreshold(SSIMMode mode);
 
     /**
      * Get preset name as string
@@ -126,6 +198,27 @@ public:
      */
     static SSIMPreset getPresetFromName(const QString& name);
 
+    /**
+     * Get SSIM mode name as string
+     * @param mode SSIM mode
+     * @return Mode name ("Global" or "Tiled")
+     */
+    static QString getSSIMModeName(SSIMMode mode);
+
+    /**
+     * Get SSIM mode from string name
+     * @param name Mode name (case-insensitive)
+     * @return SSIM mode, Global for unknown names
+     */
+    static SSIMMode getSSIMModeFromName(const QString& name);
+
+    /**
+     * Collect the ML classifier batching, preprocessing and session options from a configuration
+     * @param config Application configuration
+     * @return Classifier options
+     */
+    static MLClassifierOptions getMLClassifierOptions(const AppConfig& config);
+
     /**
      * Load exclusion list from settings
      * @return List of exclusion entries
@@ -146,17 +239,31 @@ private:
     static const QString KEY_FRAME_INTERVAL;
     static const QString KEY_SSIM_PRESET;
     static const QString KEY_CUSTOM_SSIM_THRESHOLD;
+    static const QString KEY_SSIM_MODE;
     static const QString KEY_ENABLE_VERIFICATION;
     static const QString KEY_VERIFICATION_COUNT;
     static const QString KEY_ENABLE_DOWNSAMPLING;
     static const QString KEY_DOWNSAMPLE_WIDTH;
     static const QString KEY_DOWNSAMPLE_HEIGHT;
     static const QString KEY_CHUNK_SIZE;
+    static const QString KEY_CHUNK_QUEUE_DEPTH;
+    static const QString KEY_USE_LOCK_FREE_CHUNK_QUEUE;
+    static const QString KEY_ENABLE_VIDEO_ANALYSIS_CACHE;
+    static const QString KEY_LUMA_DETECTION;
+    static const QString KEY_REDECODE_SLIDE_FRAMES;
+    static const QString KEY_MAX_CONCURRENT_VIDEOS;
+    static const QString KEY_DECODER_THREADS;
+    static const QString KEY_MEMORY_BUDGET_MB;
     static const QString KEY_JPEG_QUALITY;
+    static const QString KEY_SLIDE_WRITER_THREADS;
     static const QString KEY_ENABLE_POST_PROCESSING;
     static const QString KEY_DELETE_REDUNDANT;
     static const QString KEY_COMPARE_EXCLUDED;
     static const QString KEY_HAMMING_THRESHOLD;
+    static const QString KEY_HASH_THREADS;
+    static const QString KEY_ENABLE_HASH_CACHE;
+    static const QString KEY_FAST_PHASH;
+    static const QString KEY_POST_PROCESS_FROM_MEMORY;
     static const QString KEY_EXCLUSION_LIST_SIZE;
     static const QString KEY_EXCLUSION_REMARK;
     static const QString KEY_EXCLUSION_HASH;
@@ -164,6 +271,14 @@ private:
     static const QString KEY_ML_DELETE_MAYBE_SLIDES;
     static const QString KEY_ML_MODEL_PATH;
     static const QString KEY_ML_EXECUTION_PROVIDER;
+    static const QString KEY_ML_BATCH_SIZE;
+    static const QString KEY_ML_PREPROCESS_THREADS;
+    static const QString KEY_ML_REDUCED_DECODE;
+    static const QString KEY_ML_INTRA_OP_THREADS;
+    static const QString KEY_ML_INTER_OP_THREADS;
+    static const QString KEY_ML_PARALLEL_EXECUTION;
+    static const QString KEY_ML_ENABLE_MEMORY_ARENA;
+    static const QString KEY_ML_CACHE_OPTIMIZED_MODEL;
     static const QString KEY_ML_NOT_SLIDE_HIGH_THRESHOLD;
     static const QString KEY_ML_NOT_SLIDE_LOW_THRESHOLD;
     static const QString KEY_ML_MAYBE_SLIDE_HIGH_THRESHOLD;
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 // Static member initialization
 bool HardwareDecoder::s_ffmpegInitialized = false;
@@ -13,16 +16,19 @@ HardwareDecoder::HardwareDecoder()
     , m_codec(nullptr)
     , m_swsContext(nullptr)
     , m_frame(nullptr)
-    , m_frameRGB(nullptr)
     , m_packet(nullptr)
+    , m_lumaOutput(false)
+    , m_lumaWidth(0)
+    , m_lumaHeight(0)
+    , m_retainSourceFrames(true)
+    , m_lumaSwsContext(nullptr)
+    , m_lumaSourceRange(-1)
     , m_useHardwareAcceleration(false)
     , m_hwDeviceType(AV_HWDEVICE_TYPE_NONE)
     , m_hwDeviceContext(nullptr)
     , m_hwFrame(nullptr)
     , m_videoStreamIndex(-1)
     , m_samplingStrategy(SamplingStrategy::UseAllIFrames)
-    , m_buffer(nullptr)
-    , m_bufferSize(0)
     , m_shouldCancel(false)
 {
     initializeFFmpeg();
@@ -41,12 +47,13 @@ void HardwareDecoder::initializeFFmpeg()
     }
 }
 
-bool HardwareDecoder::openVideo(const std::string& videoPath)
+bool HardwareDecoder::openVideo(const std::string& videoPath, const VideoAnalysis* cachedAnalysis)
 {
     close(); // Clean up any previous state
 
     // Reset cancellation flag
     m_shouldCancel = false;
+    m_videoPath = videoPath;
 
     // Allocate format context
     m_formatContext = avformat_alloc_context();
@@ -65,10 +72,19 @@ bool HardwareDecoder::openVideo(const std::string& videoPath)
         return false;
     }
 
-    // Retrieve stream information
-    if (avformat_find_stream_info(m_formatContext, nullptr) < 0) {
-        m_lastError = "Could not find stream information";
-        return false;
+    // Stream probing reads and decodes the start of the file; a matching cached analysis
+    // already holds everything it would provide
+    bool useCachedAnalysis = cachedAnalysis && cachedAnalysisMatches(*cachedAnalysis);
+
+    if (!useCachedAnalysis) {
+        // Retrieve stream information
+        if (avformat_find_stream_info(m_formatContext, nullptr) < 0) {
+            m_lastError = "Could not find stream information";
+            return false;
+        }
+
+        // Some demuxers (e.g. MPEG-TS) only create their streams while probing
+        useCachedAnalysis = cachedAnalysis && cachedAnalysisMatches(*cachedAnalysis);
     }
 
     // Find video stream
@@ -85,6 +101,13 @@ bool HardwareDecoder::openVideo(const std::string& videoPath)
         return false;
     }
 
+    // Only the video stream is decoded; let the demuxer skip audio, subtitle and data packets
+    for (unsigned int i = 0; i < m_formatContext->nb_streams; i++) {
+        if (static_cast<int>(i) != m_videoStreamIndex) {
+            m_formatContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
     // Get codec parameters
     AVCodecParameters* codecParams = m_formatContext->streams[m_videoStreamIndex]->codecpar;
 
@@ -109,24 +132,29 @@ bool HardwareDecoder::openVideo(const std::string& videoPath)
     }
 
     // Fill video info
-    m_videoInfo.width = codecParams->width;
-    m_videoInfo.height = codecParams->height;
-    m_videoInfo.codecName = m_codec->name;
-
-    // Calculate duration
-    if (m_formatContext->duration != AV_NOPTS_VALUE) {
-        m_videoInfo.duration = (double)m_formatContext->duration / AV_TIME_BASE;
+    if (useCachedAnalysis) {
+        // Duration and frame rate are only reliable after probing
+        m_videoInfo = cachedAnalysis->info;
     } else {
-        m_videoInfo.duration = 0.0;
-    }
+        m_videoInfo.width = codecParams->width;
+        m_videoInfo.height = codecParams->height;
+
+        // Calculate duration
+        if (m_formatContext->duration != AV_NOPTS_VALUE) {
+            m_videoInfo.duration = (double)m_formatContext->duration / AV_TIME_BASE;
+        } else {
+            m_videoInfo.duration = 0.0;
+        }
 
-    // Calculate frame rate
-    AVRational frameRate = m_formatContext->streams[m_videoStreamIndex]->r_frame_rate;
-    if (frameRate.den != 0) {
-        m_videoInfo.frameRate = (double)frameRate.num / frameRate.den;
-    } else {
-        m_videoInfo.frameRate = 25.0; // Default fallback
+        // Calculate frame rate
+        AVRational frameRate = m_formatContext->streams[m_videoStreamIndex]->r_frame_rate;
+        if (frameRate.den != 0) {
+            m_videoInfo.frameRate = (double)frameRate.num / frameRate.den;
+        } else {
+            m_videoInfo.frameRate = 25.0; // Default fallback
+        }
     }
+    m_videoInfo.codecName = m_codec->name;
 
     // Try hardware acceleration first, fallback to software
     if (!setupHardwareDecoder()) {
@@ -138,21 +166,57 @@ bool HardwareDecoder::openVideo(const std::string& videoPath)
 
     // Allocate frames and packet
     m_frame = av_frame_alloc();
-    m_frameRGB = av_frame_alloc();
     m_packet = av_packet_alloc();
 
-    if (!m_frame || !m_frameRGB || !m_packet) {
+    if (!m_frame || !m_packet) {
         m_lastError = "Could not allocate frames or packet";
         return false;
     }
 
+    if (useCachedAnalysis) {
+        m_keyframeIndex = cachedAnalysis->keyframeIndex;
+        m_keyframeIndexComplete = cachedAnalysis->keyframeIndexComplete;
+        if (m_keyframeIndex.empty()) {
+            buildKeyframeIndexFromContainer();
+        }
+        return true;
+    }
+
     // Analyze video properties
+    buildKeyframeIndexFromContainer();
     m_videoInfo.avgIFrameInterval = analyzeIFrameIntervals();
     m_videoInfo.isScreenRecording = detectScreenRecording();
 
     return true;
 }
 
+bool HardwareDecoder::cachedAnalysisMatches(const VideoAnalysis& analysis) const
+{
+    for (unsigned int i = 0; i < m_formatContext->nb_streams; i++) {
+        const AVCodecParameters* codecParams = m_formatContext->streams[i]->codecpar;
+        if (codecParams->codec_type == AVMEDIA_TYPE_VIDEO) {
+            // Only the first video stream is decoded
+            return codecParams->codec_id != AV_CODEC_ID_NONE &&
+                   codecParams->codec_id == analysis.codecId &&
+                   codecParams->width == analysis.info.width &&
+                   codecParams->height == analysis.info.height;
+        }
+    }
+    return false;
+}
+
+HardwareDecoder::VideoAnalysis HardwareDecoder::getAnalysis() const
+{
+    VideoAnalysis analysis;
+    analysis.info = m_videoInfo;
+    analysis.keyframeIndex = m_keyframeIndex;
+    analysis.keyframeIndexComplete = m_keyframeIndexComplete;
+    if (m_formatContext && m_videoStreamIndex >= 0) {
+        analysis.codecId = m_formatContext->streams[m_videoStreamIndex]->codecpar->codec_id;
+    }
+    return analysis;
+}
+
 std::vector<AVHWDeviceType> HardwareDecoder::getPreferredHardwareDeviceTypes()
 {
     std::vector<AVHWDeviceType> deviceTypes;
@@ -275,6 +339,13 @@ double HardwareDecoder::analyzeIFrameIntervals(int maxFramesToAnalyze)
         return 2.0; // Default fallback
     }
 
+    // The keyframe index covers the whole video without reading any packets
+    if (m_keyframeIndex.size() >= 2) {
+        double span = (double)(m_keyframeIndex.back() - m_keyframeIndex.front()) *
+            av_q2d(m_formatContext->streams[m_videoStreamIndex]->time_base);
+        return span / (m_keyframeIndex.size() - 1);
+    }
+
     std::vector<double> iFrameTimestamps;
     AVPacket* packet = av_packet_alloc();
     int framesAnalyzed = 0;
@@ -376,6 +447,195 @@ HardwareDecoder::SamplingStrategy HardwareDecoder::analyzeIFrameDistribution()
     }
 }
 
+bool HardwareDecoder::buildKeyframeIndexFromContainer()
+{
+    m_keyframeIndex.clear();
+    m_keyframeIndexComplete = false;
+
+    // Generic indexes only hold the packets read so far (e.g. while probing MPEG-TS)
+    if (m_formatContext->iformat->flags & AVFMT_GENERIC_INDEX) {
+        return false;
+    }
+
+    AVStream* stream = m_formatContext->streams[m_videoStreamIndex];
+    int entryCount = avformat_index_get_entries_count(stream);
+    m_keyframeIndex.reserve(entryCount);
+
+    for (int i = 0; i < entryCount; i++) {
+        const AVIndexEntry* entry = avformat_index_get_entry(stream, i);
+        if (entry && (entry->flags & AVINDEX_KEYFRAME) && entry->timestamp != AV_NOPTS_VALUE) {
+            m_keyframeIndex.push_back(entry->timestamp);
+        }
+    }
+
+    std::sort(m_keyframeIndex.begin(), m_keyframeIndex.end());
+    m_keyframeIndex.erase(std::unique(m_keyframeIndex.begin(), m_keyframeIndex.end()), m_keyframeIndex.end());
+
+    // A container index lists every keyframe of the stream
+    m_keyframeIndexComplete = !m_keyframeIndex.empty();
+    return m_keyframeIndexComplete;
+}
+
+void HardwareDecoder::beginKeyframeIteration(KeyframeCursor& cursor)
+{
+    cursor = KeyframeCursor();
+    cursor.useIndex = !m_keyframeIndex.empty();
+
+    // Only keyframe packets are needed; demuxers honoring this skip reading the others
+    m_formatContext->streams[m_videoStreamIndex]->discard = AVDISCARD_NONKEY;
+
+    if (!cursor.useIndex) {
+        av_seek_frame(m_formatContext, m_videoStreamIndex, 0, AVSEEK_FLAG_BACKWARD);
+    }
+    avcodec_flush_buffers(m_codecContext);
+}
+
+bool HardwareDecoder::shouldDecodeKeyframe(KeyframeCursor& cursor)
+{
+    switch (m_samplingStrategy) {
+        case SamplingStrategy::SkipEveryOtherI: {
+            bool shouldDecode = !cursor.skipNext;
+            cursor.skipNext = !cursor.skipNext;
+            return shouldDecode;
+        }
+        case SamplingStrategy::UseAllIFrames:
+        case SamplingStrategy::UseAllIFramesWarn:
+            break;
+    }
+    return true;
+}
+
+bool HardwareDecoder::nextKeyframe(KeyframeCursor& cursor, AVFrame*& frame, double& timestamp)
+{
+    const AVRational timeBase = m_formatContext->streams[m_videoStreamIndex]->time_base;
+
+    if (cursor.useIndex) {
+        // Seek straight to each selected keyframe; P/B packets in between are never read
+        while (cursor.indexPosition < m_keyframeIndex.size()) {
+            if (m_shouldCancel) {
+                return false;
+            }
+
+            int64_t target = m_keyframeIndex[cursor.indexPosition++];
+            if (!shouldDecodeKeyframe(cursor)) {
+                continue;
+            }
+
+            int64_t keyframe = AV_NOPTS_VALUE;
+            if (decodeKeyframe(target, frame, keyframe, timestamp) && keyframe != cursor.lastKeyframe) {
+                cursor.lastKeyframe = keyframe;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // No index yet: read sequentially, recording keyframes for later passes
+    while (!m_shouldCancel) {
+        int readResult = av_read_frame(m_formatContext, m_packet);
+        if (readResult < 0) {
+            // Only a scan that reached the end of the file lists every keyframe; after an I/O or
+            // demuxing error the index stays empty so no truncated index reaches the cache
+            if (readResult == AVERROR_EOF && !m_shouldCancel && m_keyframeIndex.empty()) {
+                m_keyframeIndex = std::move(cursor.scannedKeyframes);
+                std::sort(m_keyframeIndex.begin(), m_keyframeIndex.end());
+                m_keyframeIndex.erase(std::unique(m_keyframeIndex.begin(), m_keyframeIndex.end()), m_keyframeIndex.end());
+                m_keyframeIndexComplete = !m_keyframeIndex.empty();
+            } else if (readResult != AVERROR_EOF) {
+                m_lastError = "Read error before end of video, keyframe index not recorded";
+            }
+            return false;
+        }
+
+        if (m_packet->stream_index == m_videoStreamIndex && (m_packet->flags & AV_PKT_FLAG_KEY)) {
+            int64_t keyframe = keyframeTimestamp(m_packet);
+            if (keyframe != AV_NOPTS_VALUE) {
+                cursor.scannedKeyframes.push_back(keyframe);
+            }
+
+            if (shouldDecodeKeyframe(cursor)) {
+                int64_t pts = m_packet->pts != AV_NOPTS_VALUE ? m_packet->pts : keyframe;
+                bool decoded = decodeKeyPacket(m_packet, frame);
+                av_packet_unref(m_packet);
+
+                if (decoded) {
+                    timestamp = (double)pts * av_q2d(timeBase);
+                    cursor.lastKeyframe = keyframe;
+                    return true;
+                }
+                continue;
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+
+    return false;
+}
+
+bool HardwareDecoder::decodeKeyframe(int64_t target, AVFrame*& frame, int64_t& keyframe, double& timestamp)
+{
+    if (!seekToKeyframe(target)) {
+        return false;
+    }
+
+    keyframe = keyframeTimestamp(m_packet);
+    int64_t pts = m_packet->pts != AV_NOPTS_VALUE ? m_packet->pts : keyframe;
+    bool decoded = decodeKeyPacket(m_packet, frame);
+    av_packet_unref(m_packet);
+
+    if (decoded) {
+        timestamp = (double)pts * av_q2d(m_formatContext->streams[m_videoStreamIndex]->time_base);
+    }
+    return decoded;
+}
+
+bool HardwareDecoder::seekToKeyframe(int64_t keyframeTimestamp)
+{
+    if (av_seek_frame(m_formatContext, m_videoStreamIndex, keyframeTimestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+        return false;
+    }
+
+    while (!isCancelled() && av_read_frame(m_formatContext, m_packet) >= 0) {
+        if (m_packet->stream_index == m_videoStreamIndex && (m_packet->flags & AV_PKT_FLAG_KEY)) {
+            // Index entries are DTS for some demuxers and PTS for others; a seek may also land
+            // on an earlier keyframe, which is skipped
+            if (m_packet->dts == keyframeTimestamp || m_packet->pts == keyframeTimestamp ||
+                HardwareDecoder::keyframeTimestamp(m_packet) > keyframeTimestamp) {
+                return true;
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+
+    return false;
+}
+
+bool HardwareDecoder::decodeKeyPacket(AVPacket* packet, AVFrame*& frame)
+{
+    frame = m_useHardwareAcceleration ? m_hwFrame : m_frame;
+
+    bool decoded = false;
+    if (avcodec_send_packet(m_codecContext, packet) >= 0) {
+        int ret = avcodec_receive_frame(m_codecContext, frame);
+        if (ret == AVERROR(EAGAIN)) {
+            // Reordering or frame threading holds the frame back; drain instead of feeding more packets
+            avcodec_send_packet(m_codecContext, nullptr);
+            ret = avcodec_receive_frame(m_codecContext, frame);
+        }
+        decoded = (ret >= 0);
+    }
+
+    // Every keyframe is decoded on its own, so reset the decoder for the next one
+    avcodec_flush_buffers(m_codecContext);
+
+    return decoded;
+}
+
+int64_t HardwareDecoder::keyframeTimestamp(const AVPacket* packet)
+{
+    return packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+}
+
 int HardwareDecoder::extractFramesIntelligent(const FrameCallback& frameCallback,
                                             const ProgressCallback& progressCallback,
                                             double targetInterval)
@@ -388,62 +648,26 @@ int HardwareDecoder::extractFramesIntelligent(const FrameCallback& frameCallback
     // Determine sampling strategy
     m_samplingStrategy = analyzeIFrameDistribution();
 
-    // Seek to beginning
-    av_seek_frame(m_formatContext, m_videoStreamIndex, 0, AVSEEK_FLAG_BACKWARD);
-    avcodec_flush_buffers(m_codecContext);
+    KeyframeCursor cursor;
+    beginKeyframeIteration(cursor);
 
     int frameCount = 0;
-    int iFrameCount = 0;
-    bool skipNext = false;
-
-    while (av_read_frame(m_formatContext, m_packet) >= 0) {
-        if (m_packet->stream_index == m_videoStreamIndex) {
-            // Check if this is an I-frame
-            bool isIFrame = (m_packet->flags & AV_PKT_FLAG_KEY);
-
-            if (isIFrame) {
-                // Apply sampling strategy
-                bool shouldDecode = true;
-
-                switch (m_samplingStrategy) {
-                    case SamplingStrategy::SkipEveryOtherI:
-                        shouldDecode = !skipNext;
-                        skipNext = !skipNext;
-                        break;
-                    case SamplingStrategy::UseAllIFrames:
-                    case SamplingStrategy::UseAllIFramesWarn:
-                        shouldDecode = true;
-                        break;
-                }
+    AVFrame* decodedFrame = nullptr;
+    double timestamp = 0.0;
 
-                if (shouldDecode) {
-                    // Decode the I-frame
-                    if (avcodec_send_packet(m_codecContext, m_packet) >= 0) {
-                        AVFrame* targetFrame = m_useHardwareAcceleration ? m_hwFrame : m_frame;
+    while (nextKeyframe(cursor, decodedFrame, timestamp)) {
+        cv::Mat mat;
 
-                        if (avcodec_receive_frame(m_codecContext, targetFrame) >= 0) {
-                            cv::Mat mat;
+        if (convertFrameToMat(decodedFrame, mat)) {
+            frameCallback(mat, timestamp, frameCount);
+            frameCount++;
 
-                            if (convertFrameToMat(targetFrame, mat)) {
-                                double timestamp = (double)m_packet->pts *
-                                    av_q2d(m_formatContext->streams[m_videoStreamIndex]->time_base);
-
-                                frameCallback(mat, timestamp, frameCount);
-                                frameCount++;
-
-                                // Progress callback
-                                if (progressCallback && m_videoInfo.duration > 0) {
-                                    double progress = (timestamp / m_videoInfo.duration) * 100.0;
-                                    progressCallback(timestamp, m_videoInfo.duration, progress);
-                                }
-                            }
-                        }
-                    }
-                }
-                iFrameCount++;
+            // Progress callback
+            if (progressCallback && m_videoInfo.duration > 0) {
+                double progress = (timestamp / m_videoInfo.duration) * 100.0;
+                progressCallback(timestamp, m_videoInfo.duration, progress);
             }
         }
-        av_packet_unref(m_packet);
     }
 
     return frameCount;
@@ -458,6 +682,9 @@ int HardwareDecoder::extractFramesAtInterval(const FrameCallback& frameCallback,
         return -1;
     }
 
+    // Every frame is a candidate here, not just keyframes
+    m_formatContext->streams[m_videoStreamIndex]->discard = AVDISCARD_DEFAULT;
+
     // Seek to beginning
     av_seek_frame(m_formatContext, m_videoStreamIndex, 0, AVSEEK_FLAG_BACKWARD);
     avcodec_flush_buffers(m_codecContext);
@@ -503,6 +730,80 @@ int HardwareDecoder::extractFramesInChunks(const ChunkReadyCallback& chunkCallba
                                          const ProgressCallback& progressCallback,
                                          int chunkSize,
                                          double targetInterval)
+{
+    if (!chunkCallback) {
+        m_lastError = "Video not opened or invalid callback";
+        return -1;
+    }
+
+    m_lumaOutput = false;
+    return extractChunks([&](std::vector<cv::Mat>&& frames, std::vector<FrameSource>&&, int startOffset, bool isLastChunk) {
+        chunkCallback(frames, startOffset, isLastChunk);
+    }, progressCallback, chunkSize);
+}
+
+int HardwareDecoder::extractFramesInChunksParallel(const ChunkReadyCallback& chunkCallback,
+                                                 const ProgressCallback& progressCallback,
+                                                 int chunkSize,
+                                                 int decoderCount)
+{
+    if (!chunkCallback) {
+        m_lastError = "Video not opened or invalid callback";
+        return -1;
+    }
+
+    m_lumaOutput = false;
+    return extractChunksParallel([&](std::vector<cv::Mat>&& frames, std::vector<FrameSource>&&, int startOffset, bool isLastChunk) {
+        chunkCallback(frames, startOffset, isLastChunk);
+    }, progressCallback, chunkSize, decoderCount);
+}
+
+int HardwareDecoder::extractDetectionFramesInChunks(const DetectionChunkReadyCallback& chunkCallback,
+                                                  const ProgressCallback& progressCallback,
+                                                  int chunkSize,
+                                                  int detectionWidth,
+                                                  int detectionHeight,
+                                                  int decoderCount,
+                                                  bool retainFrames)
+{
+    m_lumaOutput = true;
+    m_lumaWidth = std::max(0, detectionWidth);
+    m_lumaHeight = std::max(0, detectionHeight);
+    m_retainSourceFrames = retainFrames;
+    return extractChunksParallel(chunkCallback, progressCallback, chunkSize, decoderCount);
+}
+
+bool HardwareDecoder::decodeSourceFrame(const FrameSource& source, cv::Mat& mat)
+{
+    if (source.frame) {
+        return convertSourceToMat(source, mat);
+    }
+
+    if (!m_formatContext || !m_codecContext) {
+        m_lastError = "Video not opened";
+        return false;
+    }
+
+    if (source.keyframe == AV_NOPTS_VALUE) {
+        m_lastError = "Frame source has neither a retained frame nor a keyframe";
+        return false;
+    }
+
+    // A seek that lands on a different keyframe would save the wrong image
+    AVFrame* frame = nullptr;
+    int64_t keyframe = AV_NOPTS_VALUE;
+    double timestamp = 0.0;
+    if (!decodeKeyframe(source.keyframe, frame, keyframe, timestamp) || keyframe != source.keyframe) {
+        m_lastError = "Could not decode keyframe " + std::to_string(source.keyframe);
+        return false;
+    }
+
+    return convertFrameToMat(frame, mat);
+}
+
+int HardwareDecoder::extractChunks(const DetectionChunkReadyCallback& chunkCallback,
+                                 const ProgressCallback& progressCallback,
+                                 int chunkSize)
 {
     if (!m_formatContext || !m_codecContext || !chunkCallback) {
         m_lastError = "Video not opened or invalid callback";
@@ -517,95 +818,258 @@ int HardwareDecoder::extractFramesInChunks(const ChunkReadyCallback& chunkCallba
     // Determine sampling strategy
     m_samplingStrategy = analyzeIFrameDistribution();
 
-    // Seek to beginning
-    av_seek_frame(m_formatContext, m_videoStreamIndex, 0, AVSEEK_FLAG_BACKWARD);
-    avcodec_flush_buffers(m_codecContext);
+    KeyframeCursor cursor;
+    beginKeyframeIteration(cursor);
 
     int totalFrameCount = 0;
-    int iFrameCount = 0;
-    bool skipNext = false;
     std::vector<cv::Mat> currentChunk;
+    std::vector<FrameSource> currentSources;
     int chunkStartOffset = 0;
+    AVFrame* decodedFrame = nullptr;
+    double timestamp = 0.0;
+
+    while (nextKeyframe(cursor, decodedFrame, timestamp)) {
+        cv::Mat mat;
+        FrameSource source;
+        source.timestamp = timestamp;
+        source.keyframe = cursor.lastKeyframe;
+
+        if (convertChunkFrame(decodedFrame, mat, source)) {
+            // Add frame to current chunk (mat owns its data)
+            currentChunk.push_back(mat);
+            currentSources.push_back(std::move(source));
+
+            // Progress callback
+            if (progressCallback && m_videoInfo.duration > 0) {
+                double progress = (timestamp / m_videoInfo.duration) * 100.0;
+                progressCallback(timestamp, m_videoInfo.duration, progress);
+            }
+
+            totalFrameCount++;
 
-    while (true) {
-        // Check for cancellation before reading next frame
-        if (m_shouldCancel) {
-            m_lastError = "Operation cancelled by user";
-            return -1;
+            // Check if chunk is full
+            if (currentChunk.size() >= static_cast<size_t>(chunkSize)) {
+                // Call chunk callback with current chunk
+                chunkCallback(std::move(currentChunk), std::move(currentSources), chunkStartOffset, false);
+
+                // Prepare for next chunk
+                chunkStartOffset = totalFrameCount;
+                currentChunk.clear();
+                currentSources.clear();
+            }
         }
+    }
 
-        int ret = av_read_frame(m_formatContext, m_packet);
-        if (ret < 0) {
-            // Check if it was cancelled or EOF
-            if (m_shouldCancel) {
-                m_lastError = "Operation cancelled by user";
-                return -1;
+    // Check if iteration stopped because of cancellation rather than EOF
+    if (m_shouldCancel) {
+        m_lastError = "Operation cancelled by user";
+        return -1;
+    }
+
+    // Handle remaining frames in the last chunk
+    if (!currentChunk.empty()) {
+        chunkCallback(std::move(currentChunk), std::move(currentSources), chunkStartOffset, true); // Mark as last chunk
+    }
+
+    return totalFrameCount;
+}
+
+int HardwareDecoder::extractChunksParallel(const DetectionChunkReadyCallback& chunkCallback,
+                                         const ProgressCallback& progressCallback,
+                                         int chunkSize,
+                                         int decoderCount)
+{
+    if (!m_formatContext || !m_codecContext || !chunkCallback) {
+        m_lastError = "Video not opened or invalid callback";
+        return -1;
+    }
+
+    if (chunkSize <= 0) {
+        m_lastError = "Invalid chunk size";
+        return -1;
+    }
+
+    // Segments are cut from the keyframe index; without one the file is read sequentially
+    if (decoderCount <= 1 || m_keyframeIndex.empty()) {
+        return extractChunks(chunkCallback, progressCallback, chunkSize);
+    }
+
+    // Select keyframes up front so the sampling pattern does not depend on segment boundaries
+    m_samplingStrategy = analyzeIFrameDistribution();
+    KeyframeCursor selection;
+    std::vector<int64_t> selected;
+    for (int64_t keyframe : m_keyframeIndex) {
+        if (shouldDecodeKeyframe(selection)) {
+            selected.push_back(keyframe);
+        }
+    }
+
+    struct Segment {
+        std::vector<cv::Mat> frames;
+        std::vector<FrameSource> sources;
+        bool done = false;
+    };
+
+    const size_t segmentCount = (selected.size() + SEGMENT_KEYFRAMES - 1) / SEGMENT_KEYFRAMES;
+    const size_t workerCount = std::min(static_cast<size_t>(decoderCount), segmentCount);
+    const size_t window = workerCount * 2;  // Segments decoded ahead of the merge point
+    std::vector<Segment> segments(segmentCount);
+
+    std::mutex mutex;
+    std::condition_variable segmentDone;
+    std::condition_variable segmentMerged;
+    size_t nextSegment = 0;     // Next segment to merge
+    bool stopWorkers = false;
+    std::string workerError;
+
+    const VideoAnalysis analysis = getAnalysis();
+
+    // Worker w decodes segments w, w + workerCount, ... with its own demuxer and codec context
+    auto decodeSegments = [&](size_t firstSegment) {
+        HardwareDecoder decoder;
+        decoder.m_lumaOutput = m_lumaOutput;
+        decoder.m_lumaWidth = m_lumaWidth;
+        decoder.m_lumaHeight = m_lumaHeight;
+        decoder.m_retainSourceFrames = m_retainSourceFrames;
+        // Cancelling this decoder (requestCancellation) also interrupts the worker's seeks and blocking reads
+        decoder.m_parentCancel = &m_shouldCancel;
+        if (!decoder.openVideo(m_videoPath, &analysis)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (workerError.empty()) {
+                workerError = decoder.getLastError();
             }
-            break; // EOF or error
+            stopWorkers = true;
+            segmentDone.notify_all();
+            segmentMerged.notify_all();
+            return;
         }
-        if (m_packet->stream_index == m_videoStreamIndex) {
-            // Check if this is an I-frame
-            bool isIFrame = (m_packet->flags & AV_PKT_FLAG_KEY);
-
-            if (isIFrame) {
-                // Apply sampling strategy
-                bool shouldDecode = true;
-
-                switch (m_samplingStrategy) {
-                    case SamplingStrategy::SkipEveryOtherI:
-                        shouldDecode = !skipNext;
-                        skipNext = !skipNext;
-                        break;
-                    case SamplingStrategy::UseAllIFrames:
-                    case SamplingStrategy::UseAllIFramesWarn:
-                        shouldDecode = true;
-                        break;
+
+        KeyframeCursor cursor;
+        decoder.beginKeyframeIteration(cursor);
+
+        for (size_t s = firstSegment; s < segmentCount; s += workerCount) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                segmentMerged.wait(lock, [&]() { return stopWorkers || s < nextSegment + window; });
+                if (stopWorkers) {
+                    return;
                 }
+            }
 
-                if (shouldDecode) {
-                    // Decode the I-frame
-                    if (avcodec_send_packet(m_codecContext, m_packet) >= 0) {
-                        AVFrame* targetFrame = m_useHardwareAcceleration ? m_hwFrame : m_frame;
-
-                        if (avcodec_receive_frame(m_codecContext, targetFrame) >= 0) {
-                            cv::Mat mat;
-
-                            if (convertFrameToMat(targetFrame, mat)) {
-                                // Add frame to current chunk (mat is already cloned in convertFrameToMat)
-                                currentChunk.push_back(mat);
-
-                                // Progress callback
-                                if (progressCallback && m_videoInfo.duration > 0) {
-                                    double timestamp = (double)m_packet->pts *
-                                        av_q2d(m_formatContext->streams[m_videoStreamIndex]->time_base);
-                                    double progress = (timestamp / m_videoInfo.duration) * 100.0;
-                                    progressCallback(timestamp, m_videoInfo.duration, progress);
-                                }
-
-                                totalFrameCount++;
-
-                                // Check if chunk is full
-                                if (currentChunk.size() >= static_cast<size_t>(chunkSize)) {
-                                    // Call chunk callback with current chunk
-                                    chunkCallback(currentChunk, chunkStartOffset, false);
-
-                                    // Prepare for next chunk
-                                    chunkStartOffset = totalFrameCount;
-                                    currentChunk.clear();
-                                }
-                            }
-                        }
-                    }
+            // On cancellation the segment is finished early so the merge loop wakes up
+            Segment segment;
+            const size_t end = std::min(selected.size(), (s + 1) * SEGMENT_KEYFRAMES);
+            for (size_t k = s * SEGMENT_KEYFRAMES; k < end && !decoder.isCancelled(); k++) {
+                AVFrame* frame = nullptr;
+                FrameSource source;
+                cv::Mat mat;
+
+                if (decoder.decodeKeyframe(selected[k], frame, source.keyframe, source.timestamp) &&
+                    decoder.convertChunkFrame(frame, mat, source)) {
+                    segment.frames.push_back(mat);
+                    segment.sources.push_back(std::move(source));
                 }
-                iFrameCount++;
             }
+            segment.done = true;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                segments[s] = std::move(segment);
+            }
+            segmentDone.notify_all();
         }
-        av_packet_unref(m_packet);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t w = 0; w < workerCount; w++) {
+        workers.emplace_back(decodeSegments, w);
+    }
+
+    auto joinWorkers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopWorkers = true;
+        }
+        segmentMerged.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    };
+
+    int totalFrameCount = 0;
+    std::vector<cv::Mat> currentChunk;
+    std::vector<FrameSource> currentSources;
+    int chunkStartOffset = 0;
+    int64_t lastKeyframe = AV_NOPTS_VALUE;
+    bool workerFailed = false;
+
+    try {
+        // Merge segments in timeline order into the regular chunk stream
+        for (size_t s = 0; s < segmentCount && !m_shouldCancel; s++) {
+            Segment segment;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                segmentDone.wait(lock, [&]() { return stopWorkers || segments[s].done; });
+                if (!segments[s].done) {
+                    workerFailed = true;
+                    break;
+                }
+                segment = std::move(segments[s]);
+                nextSegment = s + 1;
+            }
+            segmentMerged.notify_all();
+
+            for (size_t i = 0; i < segment.frames.size(); i++) {
+                // Seeks that overshoot can make neighbouring segments land on the same keyframe
+                FrameSource& source = segment.sources[i];
+                if (source.keyframe == lastKeyframe) {
+                    continue;
+                }
+                lastKeyframe = source.keyframe;
+
+                // Progress callback
+                if (progressCallback && m_videoInfo.duration > 0) {
+                    double progress = (source.timestamp / m_videoInfo.duration) * 100.0;
+                    progressCallback(source.timestamp, m_videoInfo.duration, progress);
+                }
+
+                currentChunk.push_back(segment.frames[i]);
+                currentSources.push_back(std::move(source));
+
+                totalFrameCount++;
+
+                // Check if chunk is full
+                if (currentChunk.size() >= static_cast<size_t>(chunkSize)) {
+                    chunkCallback(std::move(currentChunk), std::move(currentSources), chunkStartOffset, false);
+
+                    // Prepare for next chunk
+                    chunkStartOffset = totalFrameCount;
+                    currentChunk.clear();
+                    currentSources.clear();
+                }
+            }
+        }
+    } catch (...) {
+        joinWorkers();
+        throw;
+    }
+
+    joinWorkers();
+
+    if (m_shouldCancel) {
+        m_lastError = "Operation cancelled by user";
+        return -1;
+    }
+
+    if (workerFailed) {
+        m_lastError = "Parallel decoder failed: " + workerError;
+        return -1;
     }
 
     // Handle remaining frames in the last chunk
     if (!currentChunk.empty()) {
-        chunkCallback(currentChunk, chunkStartOffset, true); // Mark as last chunk
+        chunkCallback(std::move(currentChunk), std::move(currentSources), chunkStartOffset, true); // Mark as last chunk
     }
 
     return totalFrameCount;
@@ -617,113 +1081,198 @@ bool HardwareDecoder::convertFrameToMat(AVFrame* frame, cv::Mat& mat)
         return false;
     }
 
-    AVFrame* sourceFrame = frame;
+    AVFrame* sourceFrame = systemMemoryFrame(frame);
+    if (!sourceFrame) {
+        return false;
+    }
 
-    // If using hardware acceleration, transfer frame to system memory
-    if (m_useHardwareAcceleration && frame->format != AV_PIX_FMT_YUV420P) {
-        if (av_hwframe_transfer_data(m_frame, frame, 0) < 0) {
-            return false;
-        }
-        sourceFrame = m_frame;
+    // swscale writes straight into a pooled buffer, which returns to the pool once the
+    // last Mat referencing it is released
+    cv::Mat converted = FrameBufferPool::instance().acquireMat(sourceFrame->height, sourceFrame->width, CV_8UC3);
+    if (!scaleFrameToBGR(sourceFrame, converted.data, static_cast<int>(converted.step[0]))) {
+        return false;
     }
 
-    // Setup conversion context if needed
-    if (!m_swsContext) {
-        m_swsContext = sws_getContext(
-            sourceFrame->width, sourceFrame->height, (AVPixelFormat)sourceFrame->format,
-            sourceFrame->width, sourceFrame->height, AV_PIX_FMT_BGR24,
-            SWS_BILINEAR, nullptr, nullptr, nullptr
-        );
+    mat = converted;
+    return true;
+}
 
-        if (!m_swsContext) {
-            return false;
-        }
+bool HardwareDecoder::convertFrameToFrameBuffer(AVFrame* frame, FrameBuffer& frameBuffer)
+{
+    if (!frame) {
+        return false;
+    }
+
+    AVFrame* sourceFrame = systemMemoryFrame(frame);
+    if (!sourceFrame) {
+        return false;
+    }
 
-        // Allocate buffer for RGB frame
-        m_bufferSize = av_image_get_buffer_size(AV_PIX_FMT_BGR24, sourceFrame->width, sourceFrame->height, 1);
-        m_buffer = (uint8_t*)av_malloc(m_bufferSize);
+    // swscale writes straight into a pooled aligned buffer, returned when the FrameBuffer is destroyed
+    FrameBuffer converted = FrameBufferPool::instance().acquireFrameBuffer(sourceFrame->height, sourceFrame->width, CV_8UC3);
+    if (!converted.isValid() ||
+        !scaleFrameToBGR(sourceFrame, converted.data(), static_cast<int>(converted.getMatView().step[0]))) {
+        return false;
+    }
 
-        if (!m_buffer) {
-            return false;
-        }
+    frameBuffer = std::move(converted);
+    return true;
+}
 
-        av_image_fill_arrays(m_frameRGB->data, m_frameRGB->linesize, m_buffer,
-                           AV_PIX_FMT_BGR24, sourceFrame->width, sourceFrame->height, 1);
+AVFrame* HardwareDecoder::systemMemoryFrame(AVFrame* frame)
+{
+    if (!frame->hw_frames_ctx) {
+        return frame;
     }
 
-    // Convert frame to BGR24
-    sws_scale(m_swsContext, sourceFrame->data, sourceFrame->linesize, 0, sourceFrame->height,
-              m_frameRGB->data, m_frameRGB->linesize);
+    // Hardware surfaces are downloaded into m_frame, whose buffers are reused from frame to frame
+    if (av_hwframe_transfer_data(m_frame, frame, 0) < 0) {
+        return nullptr;
+    }
+    return m_frame;
+}
+
+bool HardwareDecoder::scaleFrameToBGR(const AVFrame* sourceFrame, uint8_t* data, int linesize)
+{
+    m_swsContext = sws_getCachedContext(m_swsContext,
+        sourceFrame->width, sourceFrame->height, (AVPixelFormat)sourceFrame->format,
+        sourceFrame->width, sourceFrame->height, AV_PIX_FMT_BGR24,
+        SWS_BILINEAR, nullptr, nullptr, nullptr);
+
+    if (!m_swsContext) {
+        return false;
+    }
 
-    // Create OpenCV Mat with zero-copy (data is not copied, just wrapped)
-    mat = cv::Mat(sourceFrame->height, sourceFrame->width, CV_8UC3, m_frameRGB->data[0], m_frameRGB->linesize[0]);
+    uint8_t* dstData[4] = { data, nullptr, nullptr, nullptr };
+    int dstLinesize[4] = { linesize, 0, 0, 0 };
 
-    // Clone the mat to ensure data persistence after frame is reused
-    mat = mat.clone();
+    // Convert frame to BGR24
+    sws_scale(m_swsContext, sourceFrame->data, sourceFrame->linesize, 0, sourceFrame->height,
+              dstData, dstLinesize);
 
     return true;
 }
 
-bool HardwareDecoder::convertFrameToFrameBuffer(AVFrame* frame, FrameBuffer& frameBuffer)
+bool HardwareDecoder::convertFrameToLuma(AVFrame* frame, cv::Mat& luma, FrameSource& source)
 {
     if (!frame) {
         return false;
     }
 
-    AVFrame* sourceFrame = frame;
+    // Frames without a keyframe timestamp cannot be found again by seeking
+    const bool retainFrame = m_retainSourceFrames || source.keyframe == AV_NOPTS_VALUE;
 
-    // If using hardware acceleration, transfer frame to system memory
-    if (m_useHardwareAcceleration && frame->format != AV_PIX_FMT_YUV420P) {
-        if (av_hwframe_transfer_data(m_frame, frame, 0) < 0) {
+    std::shared_ptr<AVFrame> retainedFrame;
+    AVFrame* systemFrame = nullptr;
+    if (retainFrame) {
+        retainedFrame.reset(av_frame_alloc(), [](AVFrame* f) { av_frame_free(&f); });
+        if (!retainedFrame) {
             return false;
         }
-        sourceFrame = m_frame;
-    }
 
-    // Setup conversion context if needed
-    if (!m_swsContext) {
-        m_swsContext = sws_getContext(
-            sourceFrame->width, sourceFrame->height, (AVPixelFormat)sourceFrame->format,
-            sourceFrame->width, sourceFrame->height, AV_PIX_FMT_BGR24,
-            SWS_BILINEAR, nullptr, nullptr, nullptr
-        );
-
-        if (!m_swsContext) {
+        // Hardware surfaces are downloaded once; software frames are referenced, not copied
+        if (frame->hw_frames_ctx) {
+            if (av_hwframe_transfer_data(retainedFrame.get(), frame, 0) < 0) {
+                return false;
+            }
+            av_frame_copy_props(retainedFrame.get(), frame);
+        } else if (av_frame_ref(retainedFrame.get(), frame) < 0) {
             return false;
         }
-
-        // Allocate buffer for RGB frame
-        m_bufferSize = av_image_get_buffer_size(AV_PIX_FMT_BGR24, sourceFrame->width, sourceFrame->height, 1);
-        m_buffer = (uint8_t*)av_malloc(m_bufferSize);
-
-        if (!m_buffer) {
+        systemFrame = retainedFrame.get();
+    } else {
+        systemFrame = systemMemoryFrame(frame);
+        if (!systemFrame) {
             return false;
         }
+    }
 
-        av_image_fill_arrays(m_frameRGB->data, m_frameRGB->linesize, m_buffer,
-                           AV_PIX_FMT_BGR24, sourceFrame->width, sourceFrame->height, 1);
+    const int width = systemFrame->width;
+    const int height = systemFrame->height;
+    int lumaWidth = width;
+    int lumaHeight = height;
+    if (m_lumaWidth > 0 && m_lumaHeight > 0 && (width > m_lumaWidth || height > m_lumaHeight)) {
+        lumaWidth = m_lumaWidth;
+        lumaHeight = m_lumaHeight;
     }
 
-    // Convert frame to BGR24
-    sws_scale(m_swsContext, sourceFrame->data, sourceFrame->linesize, 0, sourceFrame->height,
-              m_frameRGB->data, m_frameRGB->linesize);
+    // Area averaging matches the INTER_AREA downsampling of the BGR path
+    SwsContext* previousContext = m_lumaSwsContext;
+    m_lumaSwsContext = sws_getCachedContext(m_lumaSwsContext,
+        width, height, (AVPixelFormat)systemFrame->format,
+        lumaWidth, lumaHeight, AV_PIX_FMT_GRAY8,
+        SWS_AREA, nullptr, nullptr, nullptr);
+
+    if (!m_lumaSwsContext) {
+        return false;
+    }
+
+    // Expand limited-range luma to full range, as the BGR conversion does
+    const int sourceRange = (frame->color_range == AVCOL_RANGE_JPEG) ? 1 : 0;
+    if (m_lumaSwsContext != previousContext || sourceRange != m_lumaSourceRange) {
+        const int* coefficients = sws_getCoefficients(SWS_CS_DEFAULT);
+        sws_setColorspaceDetails(m_lumaSwsContext, coefficients, sourceRange, coefficients, 1, 0, 1 << 16, 1 << 16);
+        m_lumaSourceRange = sourceRange;
+    }
+
+    cv::Mat converted = FrameBufferPool::instance().acquireMat(lumaHeight, lumaWidth, CV_8UC1);
+    uint8_t* lumaData[4] = { converted.data, nullptr, nullptr, nullptr };
+    int lumaLinesize[4] = { static_cast<int>(converted.step[0]), 0, 0, 0 };
+
+    sws_scale(m_lumaSwsContext, systemFrame->data, systemFrame->linesize, 0, height,
+              lumaData, lumaLinesize);
 
-    // Calculate the actual data size needed
-    size_t dataSize = sourceFrame->height * m_frameRGB->linesize[0];
+    luma = converted;
+    source.frame = std::move(retainedFrame);
+    return true;
+}
+
+bool HardwareDecoder::convertChunkFrame(AVFrame* frame, cv::Mat& mat, FrameSource& source)
+{
+    if (m_lumaOutput) {
+        return convertFrameToLuma(frame, mat, source);
+    }
+    return convertFrameToMat(frame, mat);
+}
 
-    // Allocate aligned memory for the FrameBuffer
-    uint8_t* alignedData = static_cast<uint8_t*>(AlignedAllocator::allocate(dataSize, 32));
-    if (!alignedData) {
+bool HardwareDecoder::convertSourceToMat(const FrameSource& source, cv::Mat& mat)
+{
+    const AVFrame* frame = source.frame.get();
+    if (!frame) {
         return false;
     }
 
-    // Copy data to aligned buffer (this is the only copy, but it's to aligned memory)
-    std::memcpy(alignedData, m_frameRGB->data[0], dataSize);
+    // Called for a handful of slides per video, so a temporary context is cheap enough
+    SwsContext* context = sws_getContext(
+        frame->width, frame->height, (AVPixelFormat)frame->format,
+        frame->width, frame->height, AV_PIX_FMT_BGR24,
+        SWS_BILINEAR, nullptr, nullptr, nullptr
+    );
 
-    // Create FrameBuffer that takes ownership of the aligned data
-    frameBuffer = FrameBuffer(alignedData, sourceFrame->height, sourceFrame->width, CV_8UC3, dataSize);
+    if (!context) {
+        return false;
+    }
 
-    return frameBuffer.isValid();
+    cv::Mat converted = FrameBufferPool::instance().acquireMat(frame->height, frame->width, CV_8UC3);
+    uint8_t* matData[4] = { converted.data, nullptr, nullptr, nullptr };
+    int matLinesize[4] = { static_cast<int>(converted.step[0]), 0, 0, 0 };
+
+    sws_scale(context, frame->data, frame->linesize, 0, frame->height, matData, matLinesize);
+    sws_freeContext(context);
+
+    mat = converted;
+    return true;
+}
+
+size_t HardwareDecoder::getSourceMemoryUsage(const FrameSource& source)
+{
+    const AVFrame* frame = source.frame.get();
+    if (!frame) {
+        return 0;
+    }
+
+    int size = av_image_get_buffer_size((AVPixelFormat)frame->format, frame->width, frame->height, 1);
+    return size > 0 ? static_cast<size_t>(size) : 0;
 }
 
 int HardwareDecoder::extractFramesOptimized(const FrameBufferCallback& frameCallback,
@@ -738,65 +1287,28 @@ int HardwareDecoder::extractFramesOptimized(const FrameBufferCallback& frameCall
     // Determine sampling strategy
     m_samplingStrategy = analyzeIFrameDistribution();
 
-    // Seek to beginning
-    av_seek_frame(m_formatContext, m_videoStreamIndex, 0, AVSEEK_FLAG_BACKWARD);
-    avcodec_flush_buffers(m_codecContext);
+    KeyframeCursor cursor;
+    beginKeyframeIteration(cursor);
 
     int totalFrameCount = 0;
-    int iFrameCount = 0;
-    bool skipNext = false;
-
-    while (av_read_frame(m_formatContext, m_packet) >= 0) {
-        if (m_packet->stream_index == m_videoStreamIndex) {
-            // Check if this is an I-frame
-            bool isIFrame = (m_packet->flags & AV_PKT_FLAG_KEY);
-
-            if (isIFrame) {
-                // Apply sampling strategy
-                bool shouldDecode = true;
-
-                switch (m_samplingStrategy) {
-                    case SamplingStrategy::SkipEveryOtherI:
-                        shouldDecode = !skipNext;
-                        skipNext = !skipNext;
-                        break;
-                    case SamplingStrategy::UseAllIFrames:
-                    case SamplingStrategy::UseAllIFramesWarn:
-                        shouldDecode = true;
-                        break;
-                }
-
-                if (shouldDecode) {
-                    // Decode the I-frame
-                    if (avcodec_send_packet(m_codecContext, m_packet) >= 0) {
-                        AVFrame* targetFrame = m_useHardwareAcceleration ? m_hwFrame : m_frame;
+    AVFrame* decodedFrame = nullptr;
+    double timestamp = 0.0;
 
-                        if (avcodec_receive_frame(m_codecContext, targetFrame) >= 0) {
-                            FrameBuffer frameBuffer;
+    while (nextKeyframe(cursor, decodedFrame, timestamp)) {
+        FrameBuffer frameBuffer;
 
-                            if (convertFrameToFrameBuffer(targetFrame, frameBuffer)) {
-                                // Calculate timestamp
-                                double timestamp = (double)m_packet->pts *
-                                    av_q2d(m_formatContext->streams[m_videoStreamIndex]->time_base);
+        if (convertFrameToFrameBuffer(decodedFrame, frameBuffer)) {
+            // Call frame callback with zero-copy FrameBuffer
+            frameCallback(std::move(frameBuffer), timestamp, totalFrameCount);
 
-                                // Call frame callback with zero-copy FrameBuffer
-                                frameCallback(std::move(frameBuffer), timestamp, totalFrameCount);
-
-                                // Progress callback
-                                if (progressCallback && m_videoInfo.duration > 0) {
-                                    double progress = (timestamp / m_videoInfo.duration) * 100.0;
-                                    progressCallback(timestamp, m_videoInfo.duration, progress);
-                                }
-
-                                totalFrameCount++;
-                            }
-                        }
-                    }
-                }
-                iFrameCount++;
+            // Progress callback
+            if (progressCallback && m_videoInfo.duration > 0) {
+                double progress = (timestamp / m_videoInfo.duration) * 100.0;
+                progressCallback(timestamp, m_videoInfo.duration, progress);
             }
+
+            totalFrameCount++;
         }
-        av_packet_unref(m_packet);
     }
 
     return totalFrameCount;
@@ -820,77 +1332,42 @@ int HardwareDecoder::extractFramesInChunksOptimized(const OptimizedChunkReadyCal
     // Determine sampling strategy
     m_samplingStrategy = analyzeIFrameDistribution();
 
-    // Seek to beginning
-    av_seek_frame(m_formatContext, m_videoStreamIndex, 0, AVSEEK_FLAG_BACKWARD);
-    avcodec_flush_buffers(m_codecContext);
+    KeyframeCursor cursor;
+    beginKeyframeIteration(cursor);
 
     int totalFrameCount = 0;
-    int iFrameCount = 0;
-    bool skipNext = false;
     std::vector<FrameBuffer> currentChunk;
     currentChunk.reserve(chunkSize); // Pre-allocate to avoid reallocations
     int chunkStartOffset = 0;
+    AVFrame* decodedFrame = nullptr;
+    double timestamp = 0.0;
 
-    while (av_read_frame(m_formatContext, m_packet) >= 0) {
-        if (m_packet->stream_index == m_videoStreamIndex) {
-            // Check if this is an I-frame
-            bool isIFrame = (m_packet->flags & AV_PKT_FLAG_KEY);
-
-            if (isIFrame) {
-                // Apply sampling strategy
-                bool shouldDecode = true;
-
-                switch (m_samplingStrategy) {
-                    case SamplingStrategy::SkipEveryOtherI:
-                        shouldDecode = !skipNext;
-                        skipNext = !skipNext;
-                        break;
-                    case SamplingStrategy::UseAllIFrames:
-                    case SamplingStrategy::UseAllIFramesWarn:
-                        shouldDecode = true;
-                        break;
-                }
+    while (nextKeyframe(cursor, decodedFrame, timestamp)) {
+        FrameBuffer frameBuffer;
 
-                if (shouldDecode) {
-                    // Decode the I-frame
-                    if (avcodec_send_packet(m_codecContext, m_packet) >= 0) {
-                        AVFrame* targetFrame = m_useHardwareAcceleration ? m_hwFrame : m_frame;
-
-                        if (avcodec_receive_frame(m_codecContext, targetFrame) >= 0) {
-                            FrameBuffer frameBuffer;
-
-                            if (convertFrameToFrameBuffer(targetFrame, frameBuffer)) {
-                                // Add FrameBuffer to current chunk (move semantics)
-                                currentChunk.emplace_back(std::move(frameBuffer));
-
-                                // Progress callback
-                                if (progressCallback && m_videoInfo.duration > 0) {
-                                    double timestamp = (double)m_packet->pts *
-                                        av_q2d(m_formatContext->streams[m_videoStreamIndex]->time_base);
-                                    double progress = (timestamp / m_videoInfo.duration) * 100.0;
-                                    progressCallback(timestamp, m_videoInfo.duration, progress);
-                                }
-
-                                totalFrameCount++;
-
-                                // Check if chunk is full
-                                if (currentChunk.size() >= static_cast<size_t>(chunkSize)) {
-                                    // Call chunk callback with current chunk (move semantics)
-                                    chunkCallback(std::move(currentChunk), chunkStartOffset, false);
-
-                                    // Prepare for next chunk
-                                    chunkStartOffset = totalFrameCount;
-                                    currentChunk.clear();
-                                    currentChunk.reserve(chunkSize); // Re-reserve capacity
-                                }
-                            }
-                        }
-                    }
-                }
-                iFrameCount++;
+        if (convertFrameToFrameBuffer(decodedFrame, frameBuffer)) {
+            // Add FrameBuffer to current chunk (move semantics)
+            currentChunk.emplace_back(std::move(frameBuffer));
+
+            // Progress callback
+            if (progressCallback && m_videoInfo.duration > 0) {
+                double progress = (timestamp / m_videoInfo.duration) * 100.0;
+                progressCallback(timestamp, m_videoInfo.duration, progress);
+            }
+
+            totalFrameCount++;
+
+            // Check if chunk is full
+            if (currentChunk.size() >= static_cast<size_t>(chunkSize)) {
+                // Call chunk callback with current chunk (move semantics)
+                chunkCallback(std::move(currentChunk), chunkStartOffset, false);
+
+                // Prepare for next chunk
+                chunkStartOffset = totalFrameCount;
+                currentChunk.clear();
+                currentChunk.reserve(chunkSize); // Re-reserve capacity
             }
         }
-        av_packet_unref(m_packet);
     }
 
     // Handle remaining frames in the last chunk
@@ -907,9 +1384,6 @@ void HardwareDecoder::close()
     if (m_frame) {
         av_frame_free(&m_frame);
     }
-    if (m_frameRGB) {
-        av_frame_free(&m_frameRGB);
-    }
     if (m_hwFrame) {
         av_frame_free(&m_hwFrame);
     }
@@ -924,12 +1398,11 @@ void HardwareDecoder::close()
         sws_freeContext(m_swsContext);
         m_swsContext = nullptr;
     }
-
-    // Free buffer
-    if (m_buffer) {
-        av_free(m_buffer);
-        m_buffer = nullptr;
+    if (m_lumaSwsContext) {
+        sws_freeContext(m_lumaSwsContext);
+        m_lumaSwsContext = nullptr;
     }
+    m_lumaSourceRange = -1;
 
     // Free codec context
     if (m_codecContext) {
@@ -947,9 +1420,11 @@ void HardwareDecoder::close()
     }
 
     // Reset state
+    m_videoPath.clear();
     m_videoStreamIndex = -1;
+    m_keyframeIndex.clear();
+    m_keyframeIndexComplete = false;
     m_useHardwareAcceleration = false;
-    m_bufferSize = 0;
     m_lastError.clear();
     m_shouldCancel = false;
 }
@@ -967,7 +1442,7 @@ void HardwareDecoder::resetCancellation()
 int HardwareDecoder::interruptCallback(void* ctx)
 {
     HardwareDecoder* decoder = static_cast<HardwareDecoder*>(ctx);
-    if (decoder && decoder->m_shouldCancel) {
+    if (decoder && decoder->isCancelled()) {
         return 1; // Return non-zero to interrupt FFmpeg operations
     }
     return 0; // Return 0 to continue
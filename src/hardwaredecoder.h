@@ -45,6 +45,17 @@ public:
         std::string codecName;          // Codec name
     };
 
+    /**
+     * Everything openVideo() learns by probing and scanning a file, so it can be
+     * persisted and handed to later opens of the same file
+     */
+    struct VideoAnalysis {
+        VideoInfo info;
+        int codecId = 0;                        // AVCodecID of the video stream
+        std::vector<int64_t> keyframeIndex;     // See getKeyframeIndex()
+        bool keyframeIndexComplete = false;     // Index covers the whole stream (container index or a full scan)
+    };
+
     /**
      * Frame sampling strategy based on I-frame analysis
      */
@@ -84,15 +95,32 @@ public:
      */
     using OptimizedChunkReadyCallback = std::function<void(std::vector<FrameBuffer>&&, int startOffset, bool isLastChunk)>;
 
+    /**
+     * Origin of a detection frame, enough to produce its full-resolution image later
+     */
+    struct FrameSource {
+        double timestamp = 0.0;                 // Presentation timestamp in seconds
+        int64_t keyframe = AV_NOPTS_VALUE;      // Keyframe index entry the frame was decoded from
+        std::shared_ptr<AVFrame> frame;         // Decoded frame in system memory, null if not retained
+    };
+
+    /**
+     * Detection chunk ready callback function type
+     * Parameters: luma_frames_vector, frame_sources_vector, start_offset, is_last_chunk
+     */
+    using DetectionChunkReadyCallback = std::function<void(std::vector<cv::Mat>&&, std::vector<FrameSource>&&, int startOffset, bool isLastChunk)>;
+
     HardwareDecoder();
     ~HardwareDecoder();
 
     /**
      * Open video file and analyze its properties
      * @param videoPath Path to video file
+     * @param cachedAnalysis Optional analysis of the same file from an earlier open; when it
+     *                       matches the stream, stream probing and I-frame analysis are skipped
      * @return true if successful
      */
-    bool openVideo(const std::string& videoPath);
+    bool openVideo(const std::string& videoPath, const VideoAnalysis* cachedAnalysis = nullptr);
 
     /**
      * Get video information
@@ -100,6 +128,21 @@ public:
      */
     const VideoInfo& getVideoInfo() const { return m_videoInfo; }
 
+    /**
+     * Get the keyframe index of the open video
+     * Filled from the container index (e.g. MP4 stss) when the video is opened, otherwise
+     * by the first complete I-frame extraction pass. While it is empty, extraction reads
+     * the file sequentially; afterwards it seeks directly to the selected keyframes.
+     * @return Keyframe timestamps in stream time base (DTS when known), ascending
+     */
+    const std::vector<int64_t>& getKeyframeIndex() const { return m_keyframeIndex; }
+
+    /**
+     * Get the analysis of the open video for reuse by later opens
+     * @return Video info, codec and keyframe index
+     */
+    VideoAnalysis getAnalysis() const;
+
     /**
      * Analyze I-frame distribution and determine optimal sampling strategy
      * @return Recommended sampling strategy
@@ -141,6 +184,74 @@ public:
                             int chunkSize = 100,
                             double targetInterval = 2.0);
 
+    /**
+     * Extract frames in chunks, decoding the video with several decoders in parallel
+     * The selected keyframes are split into short runs of consecutive keyframes dealt
+     * round-robin to independent decoder contexts; the runs are merged back in timeline
+     * order, so chunks arrive exactly as from extractFramesInChunks(). Each decoder holds
+     * at most two runs ahead of the merge point. Falls back to sequential extraction when
+     * the video has no keyframe index yet.
+     * @param chunkCallback Callback function called when each chunk is ready
+     * @param progressCallback Optional progress callback
+     * @param chunkSize Number of frames per chunk
+     * @param decoderCount Number of parallel decoders
+     * @return Number of frames extracted, -1 on error
+     */
+    int extractFramesInChunksParallel(const ChunkReadyCallback& chunkCallback,
+                                      const ProgressCallback& progressCallback = nullptr,
+                                      int chunkSize = 100,
+                                      int decoderCount = 2);
+
+    /**
+     * Extract frames in chunks for slide detection
+     * Frames are scaled by swscale straight from the decoder's YUV output to 8-bit luma at
+     * the detection resolution, skipping the full-resolution BGR conversion. Each frame comes
+     * with its source, which decodeSourceFrame() turns into the full-resolution BGR image for
+     * the few frames selected as slides.
+     * @param chunkCallback Callback function called when each chunk is ready
+     * @param progressCallback Optional progress callback
+     * @param chunkSize Number of frames per chunk
+     * @param detectionWidth Detection width; frames not larger than the detection size keep their size (0 = native)
+     * @param detectionHeight Detection height (0 = native)
+     * @param decoderCount Number of parallel decoders (see extractFramesInChunksParallel())
+     * @param retainFrames Keep each decoded frame in its source; otherwise sources only hold the
+     *                     keyframe, and selected slides are decoded again by seeking to it
+     * @return Number of frames extracted, -1 on error
+     */
+    int extractDetectionFramesInChunks(const DetectionChunkReadyCallback& chunkCallback,
+                                       const ProgressCallback& progressCallback = nullptr,
+                                       int chunkSize = 100,
+                                       int detectionWidth = 0,
+                                       int detectionHeight = 0,
+                                       int decoderCount = 1,
+                                       bool retainFrames = true);
+
+    /**
+     * Produce the full-resolution BGR image of a detection frame
+     * Converts the retained frame when there is one, otherwise seeks to the frame's keyframe
+     * and decodes it again. Must not run while the same decoder is extracting.
+     * @param source Frame source from extractDetectionFramesInChunks() on the same video
+     * @param mat Output BGR image
+     * @return true if successful
+     */
+    bool decodeSourceFrame(const FrameSource& source, cv::Mat& mat);
+
+    /**
+     * Convert the source of a detection frame to a full-resolution BGR image
+     * Thread-safe; uses no decoder state, so it may run while the decoder keeps extracting.
+     * @param source Frame source from extractDetectionFramesInChunks()
+     * @param mat Output BGR image
+     * @return true if successful
+     */
+    static bool convertSourceToMat(const FrameSource& source, cv::Mat& mat);
+
+    /**
+     * Get the memory held by a frame source
+     * @param source Frame source
+     * @return Size in bytes of the retained frame data
+     */
+    static size_t getSourceMemoryUsage(const FrameSource& source);
+
     /**
      * Extract frames using zero-copy FrameBuffer (optimized)
      * @param frameCallback Callback function called for each extracted frame
@@ -247,6 +358,66 @@ private:
      */
     bool convertFrameToFrameBuffer(AVFrame* frame, FrameBuffer& frameBuffer);
 
+    /**
+     * Get a decoded frame in system memory, downloading hardware surfaces into m_frame
+     * @param frame Decoded frame
+     * @return The frame itself, m_frame, or nullptr if the transfer failed
+     */
+    AVFrame* systemMemoryFrame(AVFrame* frame);
+
+    /**
+     * Convert a system-memory frame to full-resolution BGR24 in a caller-provided buffer
+     * @param sourceFrame Frame in system memory
+     * @param data Destination buffer (height x linesize bytes)
+     * @param linesize Destination row stride in bytes
+     * @return true if successful
+     */
+    bool scaleFrameToBGR(const AVFrame* sourceFrame, uint8_t* data, int linesize);
+
+    /**
+     * Convert AVFrame to 8-bit luma at the detection resolution
+     * Only the luma plane is scaled; limited-range video is expanded to full range so the
+     * result matches the grayscale conversion of the BGR image.
+     * @param frame AVFrame to convert
+     * @param luma Output CV_8UC1 image
+     * @param source Output, retains the frame in system memory if enabled or needed
+     * @return true if successful
+     */
+    bool convertFrameToLuma(AVFrame* frame, cv::Mat& luma, FrameSource& source);
+
+    /**
+     * Convert a decoded frame in the current chunk output format
+     * @param frame AVFrame to convert
+     * @param mat Output image (BGR or detection luma)
+     * @param source Output frame source, filled for detection luma only
+     * @return true if successful
+     */
+    bool convertChunkFrame(AVFrame* frame, cv::Mat& mat, FrameSource& source);
+
+    /**
+     * Sequential chunk extraction shared by the BGR and detection output formats
+     * @param chunkCallback Callback function called when each chunk is ready
+     * @param progressCallback Optional progress callback
+     * @param chunkSize Number of frames per chunk
+     * @return Number of frames extracted, -1 on error
+     */
+    int extractChunks(const DetectionChunkReadyCallback& chunkCallback,
+                      const ProgressCallback& progressCallback,
+                      int chunkSize);
+
+    /**
+     * Parallel chunk extraction shared by the BGR and detection output formats
+     * @param chunkCallback Callback function called when each chunk is ready
+     * @param progressCallback Optional progress callback
+     * @param chunkSize Number of frames per chunk
+     * @param decoderCount Number of parallel decoders
+     * @return Number of frames extracted, -1 on error
+     */
+    int extractChunksParallel(const DetectionChunkReadyCallback& chunkCallback,
+                              const ProgressCallback& progressCallback,
+                              int chunkSize,
+                              int decoderCount);
+
     /**
      * Detect if video is likely a screen recording
      * @return true if appears to be screen recording
@@ -274,15 +445,102 @@ private:
      */
     bool decodeNextFrame(AVFrame* frame);
 
+    /**
+     * Iteration state over the I-frames selected by the sampling strategy
+     */
+    struct KeyframeCursor {
+        bool useIndex = false;                      // Seek through m_keyframeIndex instead of reading sequentially
+        size_t indexPosition = 0;                   // Next keyframe index entry to visit
+        bool skipNext = false;                      // SkipEveryOtherI toggle
+        int64_t lastKeyframe = AV_NOPTS_VALUE;      // Keyframe of the last decoded frame, guards against seeks landing twice on it
+        std::vector<int64_t> scannedKeyframes;      // Keyframes seen by a sequential pass
+    };
+
+    /**
+     * Check whether a cached analysis describes the video stream of the opened input
+     * Compares codec and resolution as known from the container header, before probing.
+     * @param analysis Cached analysis
+     * @return true if it can be used instead of probing and analyzing the file
+     */
+    bool cachedAnalysisMatches(const VideoAnalysis& analysis) const;
+
+    /**
+     * Fill the keyframe index from the demuxer's own index (MP4 stss, Matroska cues, AVI idx1)
+     * Demuxers that only index packets as they are read are skipped, their index is partial.
+     * @return true if keyframe entries were found
+     */
+    bool buildKeyframeIndexFromContainer();
+
+    /**
+     * Prepare an I-frame extraction pass: keyframe-only demuxing and start position
+     * @param cursor Cursor to initialize
+     */
+    void beginKeyframeIteration(KeyframeCursor& cursor);
+
+    /**
+     * Decode the next I-frame selected by the sampling strategy
+     * @param cursor Iteration state from beginKeyframeIteration()
+     * @param frame Output, decoded frame (owned by the decoder, valid until the next call)
+     * @param timestamp Output, presentation timestamp in seconds
+     * @return false at end of stream or on cancellation
+     */
+    bool nextKeyframe(KeyframeCursor& cursor, AVFrame*& frame, double& timestamp);
+
+    /**
+     * Apply the sampling strategy to the next keyframe
+     * @param cursor Iteration state
+     * @return true if the keyframe should be decoded
+     */
+    bool shouldDecodeKeyframe(KeyframeCursor& cursor);
+
+    /**
+     * Seek to a keyframe and decode it
+     * @param target Keyframe index entry
+     * @param frame Output, decoded frame (owned by the decoder)
+     * @param keyframe Output, index timestamp of the keyframe actually decoded
+     * @param timestamp Output, presentation timestamp in seconds
+     * @return true if a frame was decoded
+     */
+    bool decodeKeyframe(int64_t target, AVFrame*& frame, int64_t& keyframe, double& timestamp);
+
+    /**
+     * Seek to a keyframe and read its packet into m_packet
+     * @param keyframeTimestamp Keyframe index entry
+     * @return true if the keyframe packet was read
+     */
+    bool seekToKeyframe(int64_t keyframeTimestamp);
+
+    /**
+     * Decode a single keyframe packet, draining the decoder so no later packet is needed
+     * @param packet Keyframe packet
+     * @param frame Output, decoded frame
+     * @return true if a frame was decoded
+     */
+    bool decodeKeyPacket(AVPacket* packet, AVFrame*& frame);
+
+    /**
+     * Get the timestamp a keyframe packet is indexed by
+     * @param packet Video packet
+     * @return DTS when known, PTS otherwise
+     */
+    static int64_t keyframeTimestamp(const AVPacket* packet);
+
     // FFmpeg context objects
     AVFormatContext* m_formatContext;
     AVCodecContext* m_codecContext;
     const AVCodec* m_codec;
     SwsContext* m_swsContext;
     AVFrame* m_frame;
-    AVFrame* m_frameRGB;
     AVPacket* m_packet;
 
+    // Detection output format
+    bool m_lumaOutput;                  // Chunks hold detection luma instead of full-resolution BGR
+    int m_lumaWidth;                    // Detection size, 0 = native
+    int m_lumaHeight;
+    bool m_retainSourceFrames;          // Keep decoded frames in detection frame sources
+    SwsContext* m_lumaSwsContext;
+    int m_lumaSourceRange;              // Source color range m_lumaSwsContext is configured for
+
     // Hardware acceleration
     bool m_useHardwareAcceleration;
     AVHWDeviceType m_hwDeviceType;
@@ -290,23 +548,32 @@ private:
     AVFrame* m_hwFrame;
 
     // Video stream info
+    std::string m_videoPath;
     int m_videoStreamIndex;
     VideoInfo m_videoInfo;
     SamplingStrategy m_samplingStrategy;
+    std::vector<int64_t> m_keyframeIndex;   // Keyframe timestamps in stream time base, ascending
+    bool m_keyframeIndexComplete = false;   // m_keyframeIndex covers the whole stream
 
     // Error handling
     std::string m_lastError;
 
-    // Memory management
-    uint8_t* m_buffer;
-    size_t m_bufferSize;
-
     // Cancellation support
     std::atomic<bool> m_shouldCancel;
+    const std::atomic<bool>* m_parentCancel = nullptr;  // Cancel flag of the decoder running this segment worker
+
+    /**
+     * Check whether this decoder, or the decoder that spawned it, was asked to stop
+     * @return true if decoding should stop
+     */
+    bool isCancelled() const { return m_shouldCancel || (m_parentCancel && *m_parentCancel); }
 
     // Static initialization flag
     static bool s_ffmpegInitialized;
 
+    // Consecutive keyframes decoded by one parallel decoder before moving on
+    static constexpr size_t SEGMENT_KEYFRAMES = 8;
+
     // FFmpeg interrupt callback
     static int interruptCallback(void* ctx);
 };
@@ -92,6 +92,137 @@ public:
     {
         return imreadUnicode(QString::fromUtf8(filePath.c_str()), flags);
     }
+
+    /**
+     * Read an image at reduced resolution when only a small version is needed
+     * For JPEG files the largest libjpeg DCT scaling factor (1/2, 1/4 or 1/8) that keeps
+     * the image at least minWidth x minHeight is used, which skips most of the IDCT work.
+     * Other formats, or images that are already small, are decoded at full resolution.
+     * @param filePath Path to read the image from (supports Unicode)
+     * @param minWidth Minimum width the decoded image must keep
+     * @param minHeight Minimum height the decoded image must keep
+     * @param grayscale Decode to a single grayscale channel instead of BGR
+     * @return OpenCV Mat (empty if failed)
+     */
+    static cv::Mat imreadUnicodeReduced(const QString& filePath, int minWidth, int minHeight,
+                                        bool grayscale = false)
+    {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return cv::Mat();
+        }
+
+        QByteArray fileData = file.readAll();
+        file.close();
+
+        if (fileData.isEmpty()) {
+            return cv::Mat();
+        }
+
+        int flags = grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR;
+        int width = 0;
+        int height = 0;
+        if (readJpegSize(fileData, width, height)) {
+            switch (reducedDecodeScale(width, height, minWidth, minHeight)) {
+                case 8:
+                    flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8;
+                    break;
+                case 4:
+                    flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4;
+                    break;
+                case 2:
+                    flags = grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Decode straight from the file buffer without an intermediate copy
+        cv::Mat rawData(1, static_cast<int>(fileData.size()), CV_8UC1,
+                        const_cast<char*>(fileData.constData()));
+        return cv::imdecode(rawData, flags);
+    }
+
+    /**
+     * Pick the largest JPEG DCT scaling divisor that keeps an image at least minWidth x minHeight
+     * @param width Full image width
+     * @param height Full image height
+     * @param minWidth Minimum width after scaling
+     * @param minHeight Minimum height after scaling
+     * @return 8, 4, 2 or 1 (no reduction)
+     */
+    static int reducedDecodeScale(int width, int height, int minWidth, int minHeight)
+    {
+        for (int scale : {8, 4, 2}) {
+            if (width / scale >= minWidth && height / scale >= minHeight) {
+                return scale;
+            }
+        }
+        return 1;
+    }
+
+    /**
+     * Read the dimensions of a JPEG image from its frame header without decoding it
+     * @param data Complete JPEG file contents
+     * @param width Receives the image width
+     * @param height Receives the image height
+     * @return true if the data is a JPEG with a valid frame header
+     */
+    static bool readJpegSize(const QByteArray& data, int& width, int& height)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.constData());
+        const int size = static_cast<int>(data.size());
+
+        // SOI marker
+        if (size < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) {
+            return false;
+        }
+
+        int pos = 2;
+        while (pos + 3 < size) {
+            if (bytes[pos] != 0xFF) {
+                pos++;
+                continue;
+            }
+
+            unsigned char marker = bytes[pos + 1];
+            if (marker == 0xFF) {
+                pos++;  // Fill byte
+                continue;
+            }
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+                pos += 2;  // Markers without a length field
+                continue;
+            }
+
+            int length = (bytes[pos + 2] << 8) | bytes[pos + 3];
+            if (length < 2) {
+                return false;
+            }
+
+            // SOFn frame headers (excluding DHT, JPG and DAC which share the range)
+            bool isFrameHeader = marker >= 0xC0 && marker <= 0xCF &&
+                                 marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+            if (isFrameHeader) {
+                if (pos + 8 >= size) {
+                    return false;
+                }
+                height = (bytes[pos + 5] << 8) | bytes[pos + 6];
+                width = (bytes[pos + 7] << 8) | bytes[pos + 8];
+                return width > 0 && height > 0;
+            }
+
+            // Entropy-coded data follows SOS; a frame header should have appeared before it
+            if (marker == 0xDA) {
+                return false;
+            }
+
+            pos += 2 + length;
+        }
+
+        return false;
+    }
 };
 
 #endif // IMAGEIOHELPER_H
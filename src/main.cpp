@@ -2,7 +2,10 @@
 #include <QStyleFactory>
 #include <QDir>
 #include <QStandardPaths>
+#include <QDebug>
 #include "mainwindow.h"
+#include "ssimkernels.h"
+#include "optimizationmanager.h"
 
 int main(int argc, char *argv[])
 {
@@ -14,6 +17,18 @@ int main(int argc, char *argv[])
     app.setOrganizationName("AutoSlidesExtractor");
     app.setOrganizationDomain("autoslidesextractor.com");
 
+    // Select SIMD kernels for this CPU before any worker thread starts
+    SSIMKernels::initialize();
+
+    // Pick the fastest validated SSIM backend; the benchmark runs once per machine and is cached
+    OptimizationConfig optimizationConfig;
+    optimizationConfig.enableBenchmarking = true;
+    optimizationConfig.benchmarkCachePath = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+                                                .filePath("ssim_backend.cache").toStdString();
+    if (!OptimizationManager::getInstance().initialize(optimizationConfig)) {
+        qWarning() << "OptimizationManager:" << QString::fromStdString(OptimizationManager::getInstance().getErrorMessage());
+    }
+
     // Set a modern style
     app.setStyle(QStyleFactory::create("Fusion"));
 
@@ -49,6 +49,8 @@ MainWindow::~MainWindow()
         m_processingThread->stopProcessing();
         m_processingThread->wait(5000);
     }
+
+    MLClassifier::releaseShared();
 }
 
 void MainWindow::setupUI()
@@ -726,9 +728,10 @@ void MainWindow::updateControlButtons()
     int currentRow = m_queueTable->currentRow();
     bool canRemove = false;
     if (currentRow >= 0) {
-        VideoQueueItem* video = m_videoQueue->getVideo(currentRow);
-        if (video) {
-            ProcessingStatus status = video->status;
+        // Status is written by the video workers, so read it from a snapshot
+        const std::vector<VideoQueueItem> videos = m_videoQueue->getAllVideos();
+        if (currentRow < static_cast<int>(videos.size())) {
+            ProcessingStatus status = videos[currentRow].status;
             canRemove = (status != ProcessingStatus::FFmpegHandling &&
                         status != ProcessingStatus::SSIMCalculating &&
                         status != ProcessingStatus::ImageProcessing);
@@ -739,7 +742,7 @@ void MainWindow::updateControlButtons()
 
 void MainWindow::updateQueueTable()
 {
-    const auto& videos = m_videoQueue->getAllVideos();
+    const std::vector<VideoQueueItem> videos = m_videoQueue->getAllVideos();
     m_queueTable->setRowCount(static_cast<int>(videos.size()));
 
     bool ppEnabled = m_config.enablePostProcessing;
@@ -941,6 +944,10 @@ void MainWindow::performPostProcessing(int videoIndex)
 
     // Create post-processor
     PostProcessor processor;
+    processor.setMLOptions(ConfigManager::getMLClassifierOptions(m_config));
+    processor.setHashThreads(m_config.hashThreads);
+    processor.setHashCacheEnabled(m_config.enableHashCache);
+    processor.setFastPHash(m_config.fastPHash);
 
     // Connect to processor signals for ML classification logging
     connect(&processor, &PostProcessor::imageMovedToTrash, this, [this](const QString& filePath, const QString& reason) {
@@ -977,7 +984,8 @@ void MainWindow::performPostProcessing(int videoIndex)
         m_config.mlDeleteMaybeSlides,
         m_config.mlExecutionProvider,
         true,  // useApplicationTrash
-        m_config.outputDirectory
+        m_config.outputDirectory,
+        m_processingThread->takeSlideFeatures(videoIndex)
     );
 
     // Update video statistics
@@ -1022,6 +1030,10 @@ void MainWindow::onManualPostProcessingClicked()
 
     // Create post-processor
     PostProcessor processor;
+    processor.setMLOptions(ConfigManager::getMLClassifierOptions(m_config));
+    processor.setHashThreads(m_config.hashThreads);
+    processor.setHashCacheEnabled(m_config.enableHashCache);
+    processor.setFastPHash(m_config.fastPHash);
 
     // Connect to processor signals for ML classification logging
     connect(&processor, &PostProcessor::imageMovedToTrash, this, [this](const QString& filePath, const QString& reason) {
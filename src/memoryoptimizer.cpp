@@ -184,8 +184,9 @@ FrameBuffer::FrameBuffer(int rows, int cols, int type)
     m_isValid = true;
 }
 
-FrameBuffer::FrameBuffer(uint8_t* data, int rows, int cols, int type, size_t dataSize)
-    : m_data(nullptr, AlignedAllocator::deallocate), m_size(dataSize), m_isValid(false) {
+FrameBuffer::FrameBuffer(uint8_t* data, int rows, int cols, int type, size_t dataSize,
+                         std::function<void(void*)> deleter)
+    : m_data(nullptr, std::move(deleter)), m_size(dataSize), m_isValid(false) {
 
     if (!data || rows <= 0 || cols <= 0 || dataSize == 0) {
         return;
@@ -272,6 +273,144 @@ FrameBuffer FrameBuffer::wrapMat(const cv::Mat& mat) {
     return buffer;
 }
 
+// ============================================================================
+// FrameBufferPool Implementation
+// ============================================================================
+
+FrameBufferPool& FrameBufferPool::instance() {
+    // Intentionally leaked: frames may still be released during static destruction
+    static FrameBufferPool* pool = new FrameBufferPool();
+    return *pool;
+}
+
+FrameBufferPool::FrameBufferPool(size_t maxCachedBytes)
+    : m_cachedBytes(0), m_maxCachedBytes(maxCachedBytes) {
+}
+
+FrameBufferPool::~FrameBufferPool() {
+    trim();
+}
+
+cv::Mat FrameBufferPool::acquireMat(int rows, int cols, int type) {
+    cv::Mat mat;
+    mat.allocator = this;
+    mat.create(rows, cols, type);
+    return mat;
+}
+
+FrameBuffer FrameBufferPool::acquireFrameBuffer(int rows, int cols, int type) {
+    if (rows <= 0 || cols <= 0) {
+        return FrameBuffer();
+    }
+
+    size_t size = static_cast<size_t>(rows) * cols * CV_ELEM_SIZE(type);
+    uint8_t* block = static_cast<uint8_t*>(acquireBlock(size));
+    if (!block) {
+        return FrameBuffer();
+    }
+
+    return FrameBuffer(block, rows, cols, type, size, [this, size](void* ptr) {
+        releaseBlock(ptr, size);
+    });
+}
+
+void FrameBufferPool::trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_freeBlocks) {
+        for (void* block : entry.second) {
+            AlignedAllocator::deallocate(block);
+        }
+    }
+    m_freeBlocks.clear();
+    m_cachedBytes = 0;
+}
+
+size_t FrameBufferPool::cachedBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cachedBytes;
+}
+
+cv::UMatData* FrameBufferPool::allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                        cv::AccessFlag /*flags*/, cv::UMatUsageFlags /*usageFlags*/) const {
+    // Same layout as OpenCV's standard allocator: continuous rows unless the caller supplies steps
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    uchar* block = data ? static_cast<uchar*>(data) : static_cast<uchar*>(acquireBlock(total));
+    if (!block) {
+        CV_Error(cv::Error::StsNoMem, "FrameBufferPool: Failed to allocate frame buffer");
+    }
+
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = block;
+    u->size = total;
+    if (data) {
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return u;
+}
+
+bool FrameBufferPool::allocate(cv::UMatData* data, cv::AccessFlag /*accessFlags*/,
+                               cv::UMatUsageFlags /*usageFlags*/) const {
+    return data != nullptr;
+}
+
+void FrameBufferPool::deallocate(cv::UMatData* u) const {
+    if (!u) {
+        return;
+    }
+
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        releaseBlock(u->origdata, u->size);
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+void* FrameBufferPool::acquireBlock(size_t size) const {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_freeBlocks.find(size);
+        if (it != m_freeBlocks.end() && !it->second.empty()) {
+            void* block = it->second.back();
+            it->second.pop_back();
+            m_cachedBytes -= size;
+            return block;
+        }
+    }
+
+    return AlignedAllocator::allocate(size, BLOCK_ALIGNMENT);
+}
+
+void FrameBufferPool::releaseBlock(void* block, size_t size) const {
+    if (!block) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cachedBytes + size <= m_maxCachedBytes) {
+            m_freeBlocks[size].push_back(block);
+            m_cachedBytes += size;
+            return;
+        }
+    }
+
+    AlignedAllocator::deallocate(block);
+}
+
 // ============================================================================
 // MappedFrameChunk Implementation
 // ============================================================================
@@ -752,4 +891,55 @@ void PooledMat::release() {
         m_pool->releaseBuffer(m_mat, m_isGrayBuffer);
         m_released = true;
     }
-}
\ No newline at end of file
+}
+// ============================================================================
+// MemoryBudget Implementation
+// ============================================================================
+
+MemoryBudget::MemoryBudget(size_t limitBytes) : m_limit(limitBytes), m_inUse(0) {
+}
+
+void MemoryBudget::setLimit(size_t limitBytes) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_limit = limitBytes;
+    }
+    m_released.notify_all();
+}
+
+size_t MemoryBudget::limit() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limit;
+}
+
+size_t MemoryBudget::inUse() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_inUse;
+}
+
+bool MemoryBudget::acquire(size_t bytes, const std::function<bool()>& shouldAbort) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_limit != 0 && m_inUse != 0 && m_inUse + bytes > m_limit) {
+        if (shouldAbort && shouldAbort()) {
+            return false;
+        }
+        // Poll periodically so stop requests are noticed even without a release
+        m_released.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    m_inUse += bytes;
+    return true;
+}
+
+void MemoryBudget::release(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_inUse = bytes > m_inUse ? 0 : m_inUse - bytes;
+    }
+    m_released.notify_all();
+}
+
+void MemoryBudget::wakeAll() {
+    m_released.notify_all();
+}
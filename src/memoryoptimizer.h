@@ -5,6 +5,10 @@
 #include <vector>
 #include <mutex>
 #include <queue>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <unordered_map>
 #include <opencv2/opencv.hpp>
 #include <cstdlib>
 
@@ -72,7 +76,7 @@ public:
  */
 class FrameBuffer {
 private:
-    std::unique_ptr<uint8_t[], void(*)(void*)> m_data;  // Aligned raw data with custom deleter
+    std::unique_ptr<uint8_t[], std::function<void(void*)>> m_data;  // Aligned raw data with custom deleter
     cv::Mat m_mat;                                       // Mat wrapper (no data copy)
     size_t m_size;                                       // Total buffer size
     bool m_isValid;                                      // Buffer validity flag
@@ -98,8 +102,10 @@ public:
      * @param cols Image width
      * @param type OpenCV matrix type
      * @param dataSize Size of the data buffer
+     * @param deleter Releases the data (default: AlignedAllocator::deallocate)
      */
-    FrameBuffer(uint8_t* data, int rows, int cols, int type, size_t dataSize);
+    FrameBuffer(uint8_t* data, int rows, int cols, int type, size_t dataSize,
+                std::function<void(void*)> deleter = AlignedAllocator::deallocate);
 
     /**
      * Move constructor
@@ -174,6 +180,97 @@ public:
     static FrameBuffer wrapMat(const cv::Mat& mat);
 };
 
+/**
+ * Recycling pool of aligned buffers for decoded frames
+ * Decoding produces a steady stream of equally sized frames that are dropped chunk by chunk,
+ * so freed buffers are kept and handed out again instead of allocating (and page-faulting)
+ * a new one per frame. Serves cv::Mat as a cv::MatAllocator - a buffer returns to the pool
+ * when the last Mat referencing it is released - and FrameBuffer, whose buffer returns when
+ * it is destroyed. Thread-safe.
+ */
+class FrameBufferPool : public cv::MatAllocator {
+private:
+    mutable std::mutex m_mutex;
+    mutable std::unordered_map<size_t, std::vector<void*>> m_freeBlocks;  // Block size -> free blocks
+    mutable size_t m_cachedBytes;            // Total size of free blocks
+    size_t m_maxCachedBytes;                 // Free blocks beyond this are deallocated
+
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+    static constexpr size_t DEFAULT_MAX_CACHED_BYTES = 512 * 1024 * 1024;
+
+public:
+    /**
+     * Get the process-wide pool used by the decoder
+     * Never destroyed, since Mats allocated from it may outlive any owner
+     * @return Shared pool
+     */
+    static FrameBufferPool& instance();
+
+    /**
+     * Constructor
+     * @param maxCachedBytes Maximum total size of free blocks kept for reuse
+     */
+    explicit FrameBufferPool(size_t maxCachedBytes = DEFAULT_MAX_CACHED_BYTES);
+
+    /**
+     * Destructor - frees cached blocks; blocks still in use must not be released afterwards
+     */
+    ~FrameBufferPool() override;
+
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    /**
+     * Acquire a continuous Mat backed by a pooled block
+     * @param rows Image height
+     * @param cols Image width
+     * @param type OpenCV matrix type
+     * @return Mat whose buffer returns to the pool when its last reference is released
+     */
+    cv::Mat acquireMat(int rows, int cols, int type);
+
+    /**
+     * Acquire a FrameBuffer backed by a pooled block
+     * @param rows Image height
+     * @param cols Image width
+     * @param type OpenCV matrix type
+     * @return FrameBuffer whose buffer returns to the pool when it is destroyed
+     */
+    FrameBuffer acquireFrameBuffer(int rows, int cols, int type);
+
+    /**
+     * Free all cached blocks, e.g. once processing has finished
+     */
+    void trim();
+
+    /**
+     * Get the total size of cached free blocks
+     * @return Size in bytes
+     */
+    size_t cachedBytes() const;
+
+    // cv::MatAllocator interface
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+private:
+    /**
+     * Take a free block of the given size or allocate a new one
+     * @param size Block size in bytes
+     * @return Aligned block, nullptr on allocation failure
+     */
+    void* acquireBlock(size_t size) const;
+
+    /**
+     * Return a block to the pool, deallocating it if the cache is full
+     * @param block Block from acquireBlock()
+     * @param size Block size in bytes
+     */
+    void releaseBlock(void* block, size_t size) const;
+};
+
 /**
  * Memory-mapped frame chunk for efficient large-scale frame storage
  * Uses memory mapping to handle large frame sequences without excessive RAM usage
@@ -449,4 +546,64 @@ public:
     void release();
 };
 
+/**
+ * Process-wide byte budget shared by concurrent processing pipelines
+ * Producers reserve the size of a decoded chunk before queueing it and consumers
+ * release it once the chunk is processed, so the total amount of decoded frame data
+ * held across all pipelines stays below the limit
+ */
+class MemoryBudget {
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_released;
+    size_t m_limit;                          // Budget in bytes (0 = unlimited)
+    size_t m_inUse;                          // Currently reserved bytes
+
+public:
+    /**
+     * Constructor
+     * @param limitBytes Budget in bytes, 0 for unlimited
+     */
+    explicit MemoryBudget(size_t limitBytes = 0);
+
+    /**
+     * Change the budget limit
+     * @param limitBytes Budget in bytes, 0 for unlimited
+     */
+    void setLimit(size_t limitBytes);
+
+    /**
+     * Get the budget limit
+     * @return Budget in bytes (0 = unlimited)
+     */
+    size_t limit() const;
+
+    /**
+     * Get the number of currently reserved bytes
+     * @return Reserved bytes
+     */
+    size_t inUse() const;
+
+    /**
+     * Reserve bytes, blocking until they fit in the budget
+     * A reservation larger than the whole budget is granted when nothing else is reserved,
+     * so a single oversized chunk cannot deadlock the pipeline
+     * @param bytes Number of bytes to reserve
+     * @param shouldAbort Polled while waiting; returning true abandons the reservation
+     * @return true if the bytes were reserved, false if aborted
+     */
+    bool acquire(size_t bytes, const std::function<bool()>& shouldAbort);
+
+    /**
+     * Release previously reserved bytes
+     * @param bytes Number of bytes to release
+     */
+    void release(size_t bytes);
+
+    /**
+     * Wake all waiting reservations so they can re-check their abort condition
+     */
+    void wakeAll();
+};
+
 #endif // MEMORYOPTIMIZER_H
\ No newline at end of file
@@ -1,13 +1,21 @@
 #include "mlclassifier.h"
 #include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QCoreApplication>
+#include <QSysInfo>
 #include <QDebug>
 #include <QImage>
 #include <algorithm>
 #include <cmath>
 #include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <opencv2/opencv.hpp>
 
 #ifdef ONNX_AVAILABLE
-#include <opencv2/opencv.hpp>
 #include "imageiohelper.h"
 #endif
 
@@ -18,12 +26,15 @@ const QString MLClassifier::PREFIX_SLIDE = "slide";
 const QString MLClassifier::PREFIX_NOT_SLIDE = "not_slide";
 const QString MLClassifier::PREFIX_MAYBE_SLIDE = "may_be_slide";
 
-MLClassifier::MLClassifier(const QString& modelPath, ExecutionProvider preferredProvider)
+MLClassifier::MLClassifier(const QString& modelPath, ExecutionProvider preferredProvider,
+                           const MLClassifierOptions& options)
     : m_initialized(false)
 #ifdef ONNX_AVAILABLE
     , m_memoryInfo(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault))
 #endif
 {
+    setOptions(options);
+
 #ifdef ONNX_AVAILABLE
     m_initialized = initializeSession(modelPath, preferredProvider);
     if (!m_initialized) {
@@ -68,73 +79,185 @@ QString MLClassifier::getActiveExecutionProvider() const {
 }
 
 ClassificationResult MLClassifier::classifySingle(const QString& imagePath) {
-    ClassificationResult result;
-    result.imagePath = imagePath;
+    return classifyBatch(QStringList{imagePath}).first();
+}
 
-#ifdef ONNX_AVAILABLE
-    if (!m_initialized) {
-        result.error = true;
-        result.errorMessage = "Classifier not initialized: " + m_errorMessage;
-        return result;
+ClassificationResult MLClassifier::classifyPrepared(const QString& imagePath, const cv::Mat& modelInput) {
+    return classifyPreparedBatch(QStringList{imagePath}, QVector<cv::Mat>{modelInput}).first();
+}
+
+cv::Mat MLClassifier::prepareModelInput(const cv::Mat& bgrImage, bool reducedScale) {
+    if (bgrImage.empty()) {
+        return cv::Mat();
     }
 
     try {
-        // Preprocess image
-        std::vector<float> inputTensor;
-        if (!preprocessImage(imagePath, inputTensor)) {
-            result.error = true;
-            result.errorMessage = "Failed to preprocess image";
-            return result;
+        // Reduced JPEG decoding scales by 1/2, 1/4 or 1/8 in the DCT domain (output size rounded up);
+        // an integer INTER_AREA reduction is the equivalent box average for an in-memory frame
+        cv::Mat source = bgrImage;
+        if (reducedScale) {
+            int scale = ImageIOHelper::reducedDecodeScale(bgrImage.cols, bgrImage.rows, INPUT_WIDTH, INPUT_HEIGHT);
+            if (scale > 1) {
+                cv::resize(bgrImage, source, cv::Size((bgrImage.cols + scale - 1) / scale,
+                                                      (bgrImage.rows + scale - 1) / scale),
+                           0, 0, cv::INTER_AREA);
+            }
         }
 
-        // Run inference
-        std::vector<float> outputTensor;
-        if (!runInference(inputTensor, outputTensor)) {
-            result.error = true;
-            result.errorMessage = "Failed to run inference";
-            return result;
+        // Convert BGR to RGB
+        cv::Mat imageRGB;
+        if (source.channels() == 1) {
+            cv::cvtColor(source, imageRGB, cv::COLOR_GRAY2RGB);
+        } else if (source.channels() == 4) {
+            cv::cvtColor(source, imageRGB, cv::COLOR_BGRA2RGB);
+        } else {
+            cv::cvtColor(source, imageRGB, cv::COLOR_BGR2RGB);
         }
 
-        // Apply softmax to get probabilities
-        std::vector<float> probabilities = softmax(outputTensor);
+        // Resize to 256x256 using INTER_AREA interpolation
+        // INTER_AREA is the correct method for downsampling to match PIL's LANCZOS and Sharp's lanczos3
+        // Testing confirmed: INTER_AREA produces RGB(141,55,43) vs Sharp's RGB(140,55,43) - nearly identical!
+        // Other methods produce significantly different results (CUBIC: 168,59,48 / LANCZOS4: 168,62,50)
+        cv::Mat imageResized;
+        cv::resize(imageRGB, imageResized, cv::Size(INPUT_WIDTH, INPUT_HEIGHT), 0, 0, cv::INTER_AREA);
+        return imageResized;
+
+    } catch (const std::exception& e) {
+        qWarning() << "MLClassifier: Exception in prepareModelInput:" << e.what();
+        return cv::Mat();
+    }
+}
+
+QVector<ClassificationResult> MLClassifier::classifyBatch(const QStringList& imagePaths) {
+#ifdef ONNX_AVAILABLE
+    return classifyInBatches(imagePaths, [this, &imagePaths](int index, float* tensorData) {
+        return preprocessImage(imagePaths[index], tensorData);
+    });
+#else
+    return unavailableResults(imagePaths);
+#endif
+}
 
-        // Find predicted class (highest probability)
-        auto maxIt = std::max_element(probabilities.begin(), probabilities.end());
-        int predictedIdx = std::distance(probabilities.begin(), maxIt);
-        float confidence = *maxIt;
+QVector<ClassificationResult> MLClassifier::classifyPreparedBatch(const QStringList& imagePaths,
+                                                                 const QVector<cv::Mat>& modelInputs) {
+#ifdef ONNX_AVAILABLE
+    return classifyInBatches(imagePaths, [this, &modelInputs](int index, float* tensorData) {
+        return index < modelInputs.size() && tensorFromModelInput(modelInputs[index], tensorData);
+    });
+#else
+    Q_UNUSED(modelInputs);
+    return unavailableResults(imagePaths);
+#endif
+}
 
-        // Fill result
-        result.predictedClass = m_classNames[predictedIdx];
-        result.confidence = confidence;
+namespace {
+
+// Process-wide classifier reused by MLClassifier::shared()
+std::mutex g_sharedClassifierMutex;
+std::shared_ptr<MLClassifier> g_sharedClassifier;
+QString g_sharedClassifierKey;
+
+/**
+ * @brief Build the cache key for a shared classifier configuration
+ * Batching options are excluded since they can change without rebuilding the session
+ */
+QString sharedClassifierKey(const QString& modelPath, MLClassifier::ExecutionProvider provider,
+                            const MLClassifierOptions& options) {
+    return QString("%1|%2|%3|%4|%5|%6|%7")
+        .arg(modelPath)
+        .arg(static_cast<int>(provider))
+        .arg(options.intraOpThreads)
+        .arg(options.interOpThreads)
+        .arg(options.parallelExecution)
+        .arg(options.enableMemoryArena)
+        .arg(options.cacheOptimizedModel);
+}
 
-        // Fill all class probabilities
-        for (int i = 0; i < m_classNames.size(); ++i) {
-            result.classProbabilities[m_classNames[i]] = probabilities[i];
-        }
+} // namespace
 
-        result.error = false;
+std::shared_ptr<MLClassifier> MLClassifier::shared(const QString& modelPath,
+                                                   ExecutionProvider preferredProvider,
+                                                   const MLClassifierOptions& options) {
+    std::lock_guard<std::mutex> lock(g_sharedClassifierMutex);
 
-    } catch (const std::exception& e) {
-        result.error = true;
-        result.errorMessage = QString("Exception during classification: %1").arg(e.what());
-        qWarning() << "MLClassifier::classifySingle:" << result.errorMessage;
+    QString key = sharedClassifierKey(modelPath, preferredProvider, options);
+    if (g_sharedClassifier && g_sharedClassifierKey == key) {
+        g_sharedClassifier->setOptions(options);
+        return g_sharedClassifier;
     }
+
+    // Release the previous session before loading the new one
+    g_sharedClassifier.reset();
+    g_sharedClassifierKey.clear();
+
+    auto classifier = std::make_shared<MLClassifier>(modelPath, preferredProvider, options);
+    if (!classifier->isInitialized()) {
+        // Do not cache failures so a later call can retry (e.g. after the model file is fixed)
+        return classifier;
+    }
+
+    if (!classifier->warmUp()) {
+        qWarning() << "MLClassifier: Warm-up inference failed";
+    }
+
+    g_sharedClassifier = classifier;
+    g_sharedClassifierKey = key;
+    return classifier;
+}
+
+void MLClassifier::releaseShared() {
+    std::lock_guard<std::mutex> lock(g_sharedClassifierMutex);
+    g_sharedClassifier.reset();
+    g_sharedClassifierKey.clear();
+}
+
+bool MLClassifier::warmUp() {
+#ifdef ONNX_AVAILABLE
+    if (!m_initialized) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_classifyMutex);
+
+    // Warm up at the batch size real runs will use, so buffers are sized for it
+    const size_t batchCount = static_cast<size_t>(effectiveBatchSize());
+    std::vector<float> input(batchCount * INPUT_CHANNELS * INPUT_HEIGHT * INPUT_WIDTH, 0.0f);
+    std::vector<float> logits;
+    return runInference(input.data(), batchCount, logits);
 #else
-    result.error = true;
-    result.errorMessage = "ONNX Runtime not available";
+    return false;
 #endif
+}
 
-    return result;
+void MLClassifier::setOptions(const MLClassifierOptions& options) {
+    std::lock_guard<std::mutex> lock(m_classifyMutex);
+    m_options = options;
+    m_options.batchSize = std::max(1, m_options.batchSize);
+    m_options.preprocessThreads = std::max(0, m_options.preprocessThreads);
+    m_options.intraOpThreads = std::max(0, m_options.intraOpThreads);
+    m_options.interOpThreads = std::max(0, m_options.interOpThreads);
 }
 
-QVector<ClassificationResult> MLClassifier::classifyBatch(const QStringList& imagePaths) {
+QString MLClassifier::optimizedModelCacheDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/onnx";
+}
+
+const MLClassifierOptions& MLClassifier::getOptions() const {
+    return m_options;
+}
+
+QVector<ClassificationResult> MLClassifier::unavailableResults(const QStringList& imagePaths) const {
     QVector<ClassificationResult> results;
     results.reserve(imagePaths.size());
 
-    // Process images one by one
-    // TODO: Implement true batch processing for better performance
     for (const QString& imagePath : imagePaths) {
-        results.append(classifySingle(imagePath));
+        ClassificationResult result;
+        result.imagePath = imagePath;
+        result.error = true;
+        result.errorMessage = MLClassifier::isAvailable()
+            ? "Classifier not initialized: " + m_errorMessage
+            : QString("ONNX Runtime not available");
+        results.append(result);
     }
 
     return results;
@@ -229,6 +352,53 @@ MLClassifier::ExecutionProvider MLClassifier::stringToExecutionProvider(const QS
 
 #ifdef ONNX_AVAILABLE
 
+namespace {
+
+/**
+ * @brief Convert a path to the ONNX Runtime native path string
+ * @param path File path
+ * @return Wide string on Windows, UTF-8 elsewhere
+ */
+std::basic_string<ORTCHAR_T> toOrtPath(const QString& path) {
+#ifdef _WIN32
+    return path.toStdWString();
+#else
+    return path.toStdString();
+#endif
+}
+
+} // namespace
+
+void MLClassifier::applySessionOptions() {
+    if (m_options.intraOpThreads > 0) {
+        m_sessionOptions->SetIntraOpNumThreads(m_options.intraOpThreads);
+    }
+    if (m_options.interOpThreads > 0) {
+        m_sessionOptions->SetInterOpNumThreads(m_options.interOpThreads);
+    }
+    m_sessionOptions->SetExecutionMode(m_options.parallelExecution ? ExecutionMode::ORT_PARALLEL
+                                                                   : ExecutionMode::ORT_SEQUENTIAL);
+    if (!m_options.enableMemoryArena) {
+        m_sessionOptions->DisableCpuMemArena();
+    }
+    m_sessionOptions->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+}
+
+QString MLClassifier::optimizedModelCachePath(const QByteArray& modelData) const {
+    // Core ML and DirectML compile fused nodes that cannot be serialized to an ONNX file
+    if (m_activeProvider != "CPU" && m_activeProvider != "CUDA") {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(modelData);
+    hash.addData(m_activeProvider.toUtf8());
+    hash.addData(QByteArray(OrtGetApiBase()->GetVersionString()));
+    hash.addData(QSysInfo::currentCpuArchitecture().toUtf8());
+
+    return optimizedModelCacheDirectory() + "/" + QString::fromLatin1(hash.result().toHex()) + ".onnx";
+}
+
 bool MLClassifier::initializeSession(const QString& modelPath, ExecutionProvider preferredProvider) {
     try {
         // Create ONNX Runtime environment
@@ -236,8 +406,7 @@ bool MLClassifier::initializeSession(const QString& modelPath, ExecutionProvider
 
         // Create session options
         m_sessionOptions = std::make_unique<Ort::SessionOptions>();
-        m_sessionOptions->SetIntraOpNumThreads(4);
-        m_sessionOptions->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        applySessionOptions();
 
         // Get execution provider priority
         std::vector<std::string> providers = getExecutionProviderPriority(preferredProvider);
@@ -312,33 +481,59 @@ bool MLClassifier::initializeSession(const QString& modelPath, ExecutionProvider
             qInfo() << "MLClassifier: Using CPU execution provider (fallback)";
         }
 
-        // Handle Qt resource paths
-        QString actualModelPath = modelPath;
+        // Qt resource models are loaded from memory; file models are only read
+        // into memory when their bytes are needed for the optimized-model cache key
+        bool isResource = modelPath.startsWith(":/") || modelPath.startsWith("qrc:");
         QByteArray modelData;
-        if (modelPath.startsWith(":/") || modelPath.startsWith("qrc:")) {
-            // Load from Qt resources into memory
+        if (isResource || m_options.cacheOptimizedModel) {
             QFile modelFile(modelPath);
             if (!modelFile.open(QIODevice::ReadOnly)) {
-                m_errorMessage = QString("Failed to open model file from resources: %1").arg(modelPath);
+                m_errorMessage = QString("Failed to open model file: %1").arg(modelPath);
                 return false;
             }
             modelData = modelFile.readAll();
             modelFile.close();
+        }
 
-            // Create session from memory
-            m_session = std::make_unique<Ort::Session>(*m_env,
-                                                       modelData.constData(),
-                                                       modelData.size(),
-                                                       *m_sessionOptions);
-        } else {
-            // Load from file system
-#ifdef _WIN32
-            std::wstring wModelPath = modelPath.toStdWString();
-            m_session = std::make_unique<Ort::Session>(*m_env, wModelPath.c_str(), *m_sessionOptions);
-#else
-            std::string stdModelPath = modelPath.toStdString();
-            m_session = std::make_unique<Ort::Session>(*m_env, stdModelPath.c_str(), *m_sessionOptions);
-#endif
+        QString cachePath = m_options.cacheOptimizedModel ? optimizedModelCachePath(modelData) : QString();
+
+        // Reuse a previously optimized model; graph optimization has already been applied
+        if (!cachePath.isEmpty() && QFileInfo::exists(cachePath)) {
+            try {
+                Ort::SessionOptions cachedOptions = m_sessionOptions->Clone();
+                cachedOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+                m_session = std::make_unique<Ort::Session>(*m_env, toOrtPath(cachePath).c_str(), cachedOptions);
+                qInfo() << "MLClassifier: Loaded optimized model from cache" << cachePath;
+            } catch (const Ort::Exception& e) {
+                qWarning() << "MLClassifier: Discarding unusable optimized model cache:" << e.what();
+                QFile::remove(cachePath);
+                m_session.reset();
+            }
+        }
+
+        if (!m_session) {
+            // Serialize the optimized graph to a temporary file and publish it atomically,
+            // so concurrent processes never load a partially written cache entry
+            QString tempCachePath;
+            if (!cachePath.isEmpty() && QDir().mkpath(QFileInfo(cachePath).absolutePath())) {
+                tempCachePath = QString("%1.%2.tmp").arg(cachePath).arg(QCoreApplication::applicationPid());
+                m_sessionOptions->SetOptimizedModelFilePath(toOrtPath(tempCachePath).c_str());
+            }
+
+            if (!modelData.isEmpty()) {
+                m_session = std::make_unique<Ort::Session>(*m_env,
+                                                           modelData.constData(),
+                                                           modelData.size(),
+                                                           *m_sessionOptions);
+            } else {
+                m_session = std::make_unique<Ort::Session>(*m_env, toOrtPath(modelPath).c_str(), *m_sessionOptions);
+            }
+
+            if (!tempCachePath.isEmpty() && QFileInfo::exists(tempCachePath)) {
+                if (!QFile::rename(tempCachePath, cachePath)) {
+                    QFile::remove(tempCachePath);
+                }
+            }
         }
 
         // Get input/output names and shapes
@@ -484,45 +679,187 @@ std::vector<std::string> MLClassifier::getExecutionProviderPriority(ExecutionPro
     return providers;
 }
 
-bool MLClassifier::preprocessImage(const QString& imagePath, std::vector<float>& inputTensor) {
-    try {
-        // Load image using OpenCV with Unicode support
-        cv::Mat image = ImageIOHelper::imreadUnicode(imagePath);
-        if (image.empty()) {
-            qWarning() << "MLClassifier: Failed to load image:" << imagePath;
-            return false;
+QVector<ClassificationResult> MLClassifier::classifyInBatches(const QStringList& imagePaths,
+                                                             const std::function<bool(int, float*)>& fillInput) {
+    if (!m_initialized) {
+        return unavailableResults(imagePaths);
+    }
+
+    std::lock_guard<std::mutex> lock(m_classifyMutex);
+
+    const int total = imagePaths.size();
+    std::vector<ClassificationResult> results(total);
+    for (int i = 0; i < total; ++i) {
+        results[i].imagePath = imagePaths[i];
+    }
+    if (total == 0) {
+        return QVector<ClassificationResult>();
+    }
+
+    const size_t imageSize = static_cast<size_t>(INPUT_CHANNELS) * INPUT_HEIGHT * INPUT_WIDTH;
+    const int batchCapacity = effectiveBatchSize();
+    const int batchCount = (total + batchCapacity - 1) / batchCapacity;
+    const int preprocessThreads = effectivePreprocessThreads();
+
+    // Reuse the input buffers across calls; they only grow when the batch size increases
+    for (std::vector<float>& buffer : m_inputBuffers) {
+        if (buffer.size() < imageSize * batchCapacity) {
+            buffer.resize(imageSize * batchCapacity);
         }
+    }
 
-        // Convert BGR to RGB
-        cv::Mat imageRGB;
-        cv::cvtColor(image, imageRGB, cv::COLOR_BGR2RGB);
+    // Preprocess one batch into a buffer using the thread pool, then pack the
+    // successfully preprocessed images to the front. Returns their indices in slot order.
+    auto prepareBatch = [&](int batch, std::vector<float>& buffer) {
+        const int first = batch * batchCapacity;
+        const int count = std::min(batchCapacity, total - first);
+        std::vector<char> prepared(count, 0);
+        std::atomic<int> nextImage(0);
+
+        auto worker = [&]() {
+            int i;
+            while ((i = nextImage.fetch_add(1)) < count) {
+                prepared[i] = fillInput(first + i, buffer.data() + i * imageSize) ? 1 : 0;
+            }
+        };
 
-        // Resize to 256x256 using INTER_AREA interpolation
-        // INTER_AREA is the correct method for downsampling to match PIL's LANCZOS and Sharp's lanczos3
-        // Testing confirmed: INTER_AREA produces RGB(141,55,43) vs Sharp's RGB(140,55,43) - nearly identical!
-        // Other methods produce significantly different results (CUBIC: 168,59,48 / LANCZOS4: 168,62,50)
-        cv::Mat imageResized;
-        cv::resize(imageRGB, imageResized, cv::Size(INPUT_WIDTH, INPUT_HEIGHT), 0, 0, cv::INTER_AREA);
+        std::vector<std::thread> helpers;
+        for (int t = 1; t < std::min(preprocessThreads, count); ++t) {
+            helpers.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& helper : helpers) {
+            helper.join();
+        }
 
+        std::vector<int> packed;
+        packed.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            if (!prepared[i]) {
+                results[first + i].error = true;
+                results[first + i].errorMessage = "Failed to preprocess image";
+                continue;
+            }
+            size_t slot = packed.size();
+            if (slot != static_cast<size_t>(i)) {
+                std::copy_n(buffer.data() + i * imageSize, imageSize, buffer.data() + slot * imageSize);
+            }
+            packed.push_back(first + i);
+        }
+        return packed;
+    };
+
+    std::vector<int> current = prepareBatch(0, m_inputBuffers[0]);
+    std::vector<float> logits;
+
+    for (int batch = 0; batch < batchCount; ++batch) {
+        // Preprocess the next batch into the other buffer while this one runs inference
+        std::vector<int> next;
+        std::thread prefetch;
+        if (batch + 1 < batchCount) {
+            prefetch = std::thread([&, batch]() {
+                next = prepareBatch(batch + 1, m_inputBuffers[(batch + 1) % 2]);
+            });
+        }
+
+        if (!current.empty()) {
+            if (runInference(m_inputBuffers[batch % 2].data(), current.size(), logits)) {
+                const size_t numClasses = static_cast<size_t>(m_classNames.size());
+                for (size_t i = 0; i < current.size(); ++i) {
+                    fillResultFromLogits(logits.data() + i * numClasses, results[current[i]]);
+                }
+            } else {
+                for (int index : current) {
+                    results[index].error = true;
+                    results[index].errorMessage = "Failed to run inference";
+                }
+            }
+        }
+
+        if (prefetch.joinable()) {
+            prefetch.join();
+        }
+        current = std::move(next);
+    }
+
+    return QVector<ClassificationResult>(results.begin(), results.end());
+}
+
+int MLClassifier::effectiveBatchSize() const {
+    // Models exported with a fixed batch dimension can only take that many images per run
+    if (!m_inputShape.empty() && m_inputShape[0] > 0) {
+        return static_cast<int>(std::min<int64_t>(m_inputShape[0], m_options.batchSize));
+    }
+    return m_options.batchSize;
+}
+
+int MLClassifier::effectivePreprocessThreads() const {
+    if (m_options.preprocessThreads > 0) {
+        return m_options.preprocessThreads;
+    }
+
+    // Leave most cores to ONNX Runtime's own intra-op threads
+    unsigned int cores = std::thread::hardware_concurrency();
+    return std::clamp(static_cast<int>(cores / 2), 1, 8);
+}
+
+void MLClassifier::fillResultFromLogits(const float* logits, ClassificationResult& result) {
+    // Apply softmax to get probabilities
+    std::vector<float> probabilities = softmax(std::vector<float>(logits, logits + m_classNames.size()));
+
+    // Find predicted class (highest probability)
+    auto maxIt = std::max_element(probabilities.begin(), probabilities.end());
+    int predictedIdx = std::distance(probabilities.begin(), maxIt);
+
+    // Fill result
+    result.predictedClass = m_classNames[predictedIdx];
+    result.confidence = *maxIt;
+
+    // Fill all class probabilities
+    for (int i = 0; i < m_classNames.size(); ++i) {
+        result.classProbabilities[m_classNames[i]] = probabilities[i];
+    }
+
+    result.error = false;
+}
+
+bool MLClassifier::preprocessImage(const QString& imagePath, float* tensorData) {
+    // Load image using OpenCV with Unicode support; the model only needs 256x256,
+    // so large JPEGs are decoded at a reduced scale when enabled
+    cv::Mat image = m_options.reducedDecode
+        ? ImageIOHelper::imreadUnicodeReduced(imagePath, INPUT_WIDTH, INPUT_HEIGHT)
+        : ImageIOHelper::imreadUnicode(imagePath);
+    if (image.empty()) {
+        qWarning() << "MLClassifier: Failed to load image:" << imagePath;
+        return false;
+    }
+
+    return tensorFromModelInput(prepareModelInput(image), tensorData);
+}
+
+bool MLClassifier::tensorFromModelInput(const cv::Mat& modelInput, float* tensorData) {
+    if (modelInput.empty() || modelInput.cols != INPUT_WIDTH || modelInput.rows != INPUT_HEIGHT ||
+        modelInput.channels() != INPUT_CHANNELS) {
+        return false;
+    }
+
+    try {
         // Convert to float and normalize to [0, 1]
         cv::Mat imageFloat;
-        imageResized.convertTo(imageFloat, CV_32F, 1.0 / 255.0);
-
-        // Allocate tensor (NCHW format: 1 x 3 x 256 x 256)
-        inputTensor.resize(1 * INPUT_CHANNELS * INPUT_HEIGHT * INPUT_WIDTH);
+        modelInput.convertTo(imageFloat, CV_32F, 1.0 / 255.0);
 
-        // Convert HWC to CHW and copy to tensor
+        // Convert HWC to CHW directly into the tensor slot (3 x 256 x 256)
         for (int c = 0; c < INPUT_CHANNELS; ++c) {
             for (int h = 0; h < INPUT_HEIGHT; ++h) {
                 for (int w = 0; w < INPUT_WIDTH; ++w) {
                     int tensorIdx = c * INPUT_HEIGHT * INPUT_WIDTH + h * INPUT_WIDTH + w;
-                    inputTensor[tensorIdx] = imageFloat.at<cv::Vec3f>(h, w)[c];
+                    tensorData[tensorIdx] = imageFloat.at<cv::Vec3f>(h, w)[c];
                 }
             }
         }
 
         // Apply ImageNet normalization
-        normalizeImageNet(inputTensor);
+        normalizeImageNet(tensorData);
 
         return true;
 
@@ -532,7 +869,7 @@ bool MLClassifier::preprocessImage(const QString& imagePath, std::vector<float>&
     }
 }
 
-void MLClassifier::normalizeImageNet(std::vector<float>& tensor) {
+void MLClassifier::normalizeImageNet(float* tensor) {
     int pixelsPerChannel = INPUT_HEIGHT * INPUT_WIDTH;
 
     for (int c = 0; c < INPUT_CHANNELS; ++c) {
@@ -546,15 +883,15 @@ void MLClassifier::normalizeImageNet(std::vector<float>& tensor) {
     }
 }
 
-bool MLClassifier::runInference(const std::vector<float>& inputTensor,
-                               std::vector<float>& outputTensor) {
+bool MLClassifier::runInference(float* inputData, size_t batchCount, std::vector<float>& outputLogits) {
     try {
-        // Create input tensor
-        std::vector<int64_t> inputShape = {1, INPUT_CHANNELS, INPUT_HEIGHT, INPUT_WIDTH};
+        // Wrap the first batchCount slots of the preallocated buffer (dynamic batch dimension)
+        std::vector<int64_t> inputShape = {static_cast<int64_t>(batchCount), INPUT_CHANNELS, INPUT_HEIGHT, INPUT_WIDTH};
+        size_t inputSize = batchCount * INPUT_CHANNELS * INPUT_HEIGHT * INPUT_WIDTH;
         Ort::Value inputOrtTensor = Ort::Value::CreateTensor<float>(
             m_memoryInfo,
-            const_cast<float*>(inputTensor.data()),
-            inputTensor.size(),
+            inputData,
+            inputSize,
             inputShape.data(),
             inputShape.size()
         );
@@ -569,10 +906,10 @@ bool MLClassifier::runInference(const std::vector<float>& inputTensor,
             1
         );
 
-        // Extract output
+        // Extract output (batchCount x num_classes)
         float* outputData = outputTensors[0].GetTensorMutableData<float>();
-        size_t outputSize = m_classNames.size();
-        outputTensor.assign(outputData, outputData + outputSize);
+        size_t outputSize = batchCount * m_classNames.size();
+        outputLogits.assign(outputData, outputData + outputSize);
 
         return true;
 
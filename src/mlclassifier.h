@@ -8,6 +8,9 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <memory>
+#include <functional>
+#include <mutex>
+#include <opencv2/core.hpp>
 
 #ifdef ONNX_AVAILABLE
 #include <onnxruntime_cxx_api.h>
@@ -28,6 +31,28 @@ struct ClassificationResult {
         : confidence(0.0f), error(false) {}
 };
 
+/**
+ * @brief Runtime options for batched classification and the ONNX Runtime session
+ *
+ * Session fields (thread counts, execution mode, arena, model caching) are only
+ * read when the classifier is constructed.
+ */
+struct MLClassifierOptions {
+    int batchSize;            // Images per inference run (capped by a fixed model batch dimension)
+    int preprocessThreads;    // Threads decoding/resizing images ahead of inference, 0 = automatic
+    bool reducedDecode;       // Decode JPEGs at reduced resolution (IMREAD_REDUCED_*) when large enough
+    int intraOpThreads;       // Threads used within an operator, 0 = ONNX Runtime default (physical cores)
+    int interOpThreads;       // Threads used across operators in parallel mode, 0 = ONNX Runtime default
+    bool parallelExecution;   // ORT_PARALLEL instead of ORT_SEQUENTIAL execution mode
+    bool enableMemoryArena;   // Keep the CPU memory arena allocator enabled
+    bool cacheOptimizedModel; // Serialize the graph-optimized model and reuse it on later runs
+
+    MLClassifierOptions()
+        : batchSize(1), preprocessThreads(0), reducedDecode(true),
+          intraOpThreads(0), interOpThreads(0), parallelExecution(false),
+          enableMemoryArena(true), cacheOptimizedModel(true) {}
+};
+
 /**
  * @brief ML-based slide classifier using ONNX Runtime
  *
@@ -60,9 +85,11 @@ public:
      * @brief Constructor
      * @param modelPath Path to ONNX model file (can be Qt resource path)
      * @param preferredProvider Preferred execution provider (default: Auto)
+     * @param options Batching and session options
      */
     explicit MLClassifier(const QString& modelPath,
-                         ExecutionProvider preferredProvider = ExecutionProvider::Auto);
+                         ExecutionProvider preferredProvider = ExecutionProvider::Auto,
+                         const MLClassifierOptions& options = MLClassifierOptions());
 
     /**
      * @brief Destructor
@@ -100,13 +127,57 @@ public:
      */
     ClassificationResult classifySingle(const QString& imagePath);
 
+    /**
+     * @brief Classify an image that was already prepared with prepareModelInput()
+     * Skips decoding the image file, e.g. for slides still held in memory after extraction
+     * @param imagePath Path reported in the result
+     * @param modelInput RGB image at model input size
+     * @return Classification result with predicted class and probabilities
+     */
+    ClassificationResult classifyPrepared(const QString& imagePath, const cv::Mat& modelInput);
+
+    /**
+     * @brief Convert a BGR image to the RGB model input size used for classification
+     * Applies the same color conversion and INTER_AREA resize as file-based preprocessing.
+     * With reducedScale, a full-resolution frame is first box-averaged by the JPEG DCT scaling
+     * divisor that reduced decoding would pick, so in-memory frames take the same resampling
+     * chain as reduced-decoded files. The two paths still differ by the JPEG compression itself.
+     * @param bgrImage Source image in OpenCV BGR order
+     * @param reducedScale Mirror MLClassifierOptions::reducedDecode for a full-resolution frame
+     * @return RGB 8-bit image at model input size (empty on error)
+     */
+    static cv::Mat prepareModelInput(const cv::Mat& bgrImage, bool reducedScale = false);
+
     /**
      * @brief Classify multiple images in batch
+     * Images are grouped into inference batches; the next batch is decoded and
+     * preprocessed on a thread pool while the current one runs inference
      * @param imagePaths List of image file paths
-     * @return List of classification results
+     * @return List of classification results, in input order
      */
     QVector<ClassificationResult> classifyBatch(const QStringList& imagePaths);
 
+    /**
+     * @brief Classify multiple images prepared with prepareModelInput() in batch
+     * @param imagePaths Paths reported in the results
+     * @param modelInputs RGB images at model input size, one per path
+     * @return List of classification results, in input order
+     */
+    QVector<ClassificationResult> classifyPreparedBatch(const QStringList& imagePaths,
+                                                        const QVector<cv::Mat>& modelInputs);
+
+    /**
+     * @brief Set batching and preprocessing options
+     * @param options Options to apply to subsequent classification calls
+     */
+    void setOptions(const MLClassifierOptions& options);
+
+    /**
+     * @brief Get batching and preprocessing options
+     * @return Current options
+     */
+    const MLClassifierOptions& getOptions() const;
+
     /**
      * @brief 2-stage classification thresholds for a category
      */
@@ -171,6 +242,42 @@ public:
      */
     static ExecutionProvider stringToExecutionProvider(const QString& providerStr);
 
+    /**
+     * @brief Get a long-lived classifier shared across post-processing runs
+     *
+     * Loading the model and building the ONNX Runtime session dominates the cost of
+     * classifying a short video's slides, so one warmed-up instance is kept per
+     * process and reused while the model path, provider and session options match.
+     * Requesting a different configuration replaces the cached instance. Batching
+     * options are applied to the shared instance on every call.
+     * @param modelPath Path to ONNX model file (can be Qt resource path)
+     * @param preferredProvider Preferred execution provider
+     * @param options Batching and session options
+     * @return Shared classifier; check isInitialized() before use
+     */
+    static std::shared_ptr<MLClassifier> shared(const QString& modelPath,
+                                                ExecutionProvider preferredProvider,
+                                                const MLClassifierOptions& options = MLClassifierOptions());
+
+    /**
+     * @brief Drop the cached shared classifier, freeing its session
+     * Callers still holding the instance keep it alive until they release it.
+     */
+    static void releaseShared();
+
+    /**
+     * @brief Run one inference on a blank batch so allocations and kernel setup
+     * happen before the first real images are classified
+     * @return true if the warm-up inference succeeded
+     */
+    bool warmUp();
+
+    /**
+     * @brief Get the directory holding serialized optimized models
+     * @return Cache directory path
+     */
+    static QString optimizedModelCacheDirectory();
+
 private:
 #ifdef ONNX_AVAILABLE
     /**
@@ -181,6 +288,21 @@ private:
      */
     bool initializeSession(const QString& modelPath, ExecutionProvider preferredProvider);
 
+    /**
+     * @brief Apply thread, execution mode and arena settings to the session options
+     */
+    void applySessionOptions();
+
+    /**
+     * @brief Build the cache file path for the optimized form of a model
+     *
+     * The key covers the model bytes, the active execution provider, the ONNX Runtime
+     * version and the CPU architecture, since optimized graphs are specific to all four.
+     * @param modelData Raw model bytes
+     * @return Cache file path, or empty if the active provider cannot be serialized
+     */
+    QString optimizedModelCachePath(const QByteArray& modelData) const;
+
     /**
      * @brief Get available execution providers for current platform
      * @param preferredProvider Preferred provider
@@ -188,28 +310,65 @@ private:
      */
     std::vector<std::string> getExecutionProviderPriority(ExecutionProvider preferredProvider);
 
+    /**
+     * @brief Classify images in batches, filling each batch slot through a callback
+     * @param imagePaths Paths reported in the results
+     * @param fillInput Writes the normalized 3x256x256 tensor for image `index`; returns false on failure.
+     *                  Called concurrently from preprocessing threads.
+     * @return List of classification results, in input order
+     */
+    QVector<ClassificationResult> classifyInBatches(const QStringList& imagePaths,
+                                                    const std::function<bool(int, float*)>& fillInput);
+
+    /**
+     * @brief Get the batch size usable with the loaded model
+     * @return Configured batch size, capped by a fixed model batch dimension
+     */
+    int effectiveBatchSize() const;
+
+    /**
+     * @brief Get the number of preprocessing threads to use
+     * @return Configured thread count, or an automatic choice when 0
+     */
+    int effectivePreprocessThreads() const;
+
+    /**
+     * @brief Fill a classification result from one row of output logits
+     * @param logits Logits for a single image (num_classes values)
+     * @param result Result to fill
+     */
+    void fillResultFromLogits(const float* logits, ClassificationResult& result);
+
     /**
      * @brief Preprocess image for model input
      * @param imagePath Path to image file
-     * @param inputTensor Output tensor data (1x3x256x256)
+     * @param tensorData Output tensor slot (3x256x256)
      * @return true if preprocessing successful
      */
-    bool preprocessImage(const QString& imagePath, std::vector<float>& inputTensor);
+    bool preprocessImage(const QString& imagePath, float* tensorData);
+
+    /**
+     * @brief Convert a prepared model input image to a normalized CHW tensor
+     * @param modelInput RGB image at model input size
+     * @param tensorData Output tensor slot (3x256x256)
+     * @return true if conversion successful
+     */
+    bool tensorFromModelInput(const cv::Mat& modelInput, float* tensorData);
 
     /**
      * @brief Apply ImageNet normalization to image tensor
-     * @param tensor Input/output tensor data
+     * @param tensor Input/output tensor slot (3x256x256)
      */
-    void normalizeImageNet(std::vector<float>& tensor);
+    void normalizeImageNet(float* tensor);
 
     /**
-     * @brief Run inference on preprocessed input
-     * @param inputTensor Input tensor data
-     * @param outputTensor Output tensor data (7 class logits)
+     * @brief Run inference on a packed batch of input tensors
+     * @param inputData First of batchCount consecutive 3x256x256 tensors
+     * @param batchCount Number of images in the batch
+     * @param outputLogits Output logits (batchCount x num_classes)
      * @return true if inference successful
      */
-    bool runInference(const std::vector<float>& inputTensor,
-                     std::vector<float>& outputTensor);
+    bool runInference(float* inputData, size_t batchCount, std::vector<float>& outputLogits);
 
     /**
      * @brief Apply softmax to convert logits to probabilities
@@ -229,8 +388,12 @@ private:
     std::string m_outputName;  // Store actual string
     std::vector<const char*> m_inputNames;   // Pointers to m_inputName
     std::vector<const char*> m_outputNames;  // Pointers to m_outputName
-    std::vector<int64_t> m_inputShape;   // [1, 3, 256, 256]
-    std::vector<int64_t> m_outputShape;  // [1, num_classes]
+    std::vector<int64_t> m_inputShape;   // [N, 3, 256, 256], N = -1 for a dynamic batch dimension
+    std::vector<int64_t> m_outputShape;  // [N, num_classes]
+
+    // Preallocated input tensor storage reused across inference runs (batch x 3 x 256 x 256);
+    // two buffers so one batch is preprocessed while the other runs inference
+    std::vector<float> m_inputBuffers[2];
 
     // Class names from model (populated during initialization)
     QStringList m_classNames;
@@ -256,6 +419,19 @@ private:
     // Default threshold for classification decisions
     static constexpr float DEFAULT_THRESHOLD = 0.8f;
 
+    /**
+     * @brief Build error results for every path when classification cannot run
+     * @param imagePaths Paths reported in the results
+     * @return One error result per path
+     */
+    QVector<ClassificationResult> unavailableResults(const QStringList& imagePaths) const;
+
+    // Batching and preprocessing options
+    MLClassifierOptions m_options;
+
+    // Serializes classification on shared instances (input buffers and options)
+    std::mutex m_classifyMutex;
+
     // Initialization state
     bool m_initialized;
     QString m_errorMessage;
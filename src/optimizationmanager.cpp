@@ -1,4 +1,5 @@
 #include "optimizationmanager.h"
+#include "gpuacceleration.h"
 #include <iostream>
 #include <algorithm>
 #include <random>
@@ -6,9 +7,12 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <set>
 
-// Platform-specific SIMD includes
-#ifdef __x86_64__
+// Platform-specific SIMD includes (x86 kernels are compiled per function with SIMD_TARGET)
+#if defined(__x86_64__) || defined(_M_X64)
     #include <immintrin.h>
 #elif defined(__aarch64__)
     #include <arm_neon.h>
@@ -29,6 +33,7 @@ CPUSSIMCalculator::CPUSSIMCalculator(SIMDInstructionSet instructionSet)
         return;
     }
 
+    m_momentsKernel = SSIMKernels::tableFor(instructionSet).moments;
     m_isReady = true;
 }
 
@@ -56,6 +61,12 @@ double CPUSSIMCalculator::calculateSSIM(const cv::Mat& img1, const cv::Mat& img2
         cv::resize(gray2, gray2, gray1.size());
     }
 
+    // 8-bit pairs (what the detection pipeline scores) take the fused integer kernel
+    SSIMMoments moments;
+    if (m_momentsKernel && SSIMKernels::computeMoments(gray1, gray2, moments, m_momentsKernel)) {
+        return moments.globalSSIM(6.5025, 58.5225);
+    }
+
     // Convert to floating point
     cv::Mat float1, float2;
     gray1.convertTo(float1, CV_64F);
@@ -70,6 +81,8 @@ double CPUSSIMCalculator::calculateSSIM(const cv::Mat& img1, const cv::Mat& img2
         case SIMDInstructionSet::AVX512F:
         case SIMDInstructionSet::AVX512BW:
         case SIMDInstructionSet::AVX512VL:
+        case SIMDInstructionSet::AVX512VNNI:
+        case SIMDInstructionSet::AVX512VPOPCNTDQ:
             return calculateSSIM_AVX512(float1, float2);
         case SIMDInstructionSet::NEON:
             return calculateSSIM_NEON(float1, float2);
@@ -98,6 +111,8 @@ OptimizationType CPUSSIMCalculator::getOptimizationType() const {
         case SIMDInstructionSet::AVX512F:
         case SIMDInstructionSet::AVX512BW:
         case SIMDInstructionSet::AVX512VL:
+        case SIMDInstructionSet::AVX512VNNI:
+        case SIMDInstructionSet::AVX512VPOPCNTDQ:
             return OptimizationType::SIMD_AVX512;
         case SIMDInstructionSet::NEON:
             return OptimizationType::SIMD_NEON;
@@ -137,7 +152,7 @@ double CPUSSIMCalculator::calculateSSIM_Generic(const cv::Mat& img1, const cv::M
 }
 
 double CPUSSIMCalculator::calculateSSIM_SSE4_2(const cv::Mat& img1, const cv::Mat& img2) {
-#ifdef __SSE4_2__
+#if defined(__x86_64__) || defined(_M_X64)
     double mean1, mean2, var1, var2;
     calculateMeanVariance_SSE4_2(img1, mean1, var1);
     calculateMeanVariance_SSE4_2(img2, mean2, var2);
@@ -157,7 +172,7 @@ double CPUSSIMCalculator::calculateSSIM_SSE4_2(const cv::Mat& img1, const cv::Ma
 }
 
 double CPUSSIMCalculator::calculateSSIM_AVX2(const cv::Mat& img1, const cv::Mat& img2) {
-#ifdef __AVX2__
+#if defined(__x86_64__) || defined(_M_X64)
     double mean1, mean2, var1, var2;
     calculateMeanVariance_AVX2(img1, mean1, var1);
     calculateMeanVariance_AVX2(img2, mean2, var2);
@@ -177,7 +192,7 @@ double CPUSSIMCalculator::calculateSSIM_AVX2(const cv::Mat& img1, const cv::Mat&
 }
 
 double CPUSSIMCalculator::calculateSSIM_AVX512(const cv::Mat& img1, const cv::Mat& img2) {
-#ifdef __AVX512F__
+#if defined(__x86_64__) || defined(_M_X64)
     double mean1, mean2, var1, var2;
     calculateMeanVariance_AVX512(img1, mean1, var1);
     calculateMeanVariance_AVX512(img2, mean2, var2);
@@ -216,8 +231,9 @@ double CPUSSIMCalculator::calculateSSIM_NEON(const cv::Mat& img1, const cv::Mat&
 #endif
 }
 
+SIMD_TARGET("sse4.2")
 void CPUSSIMCalculator::calculateMeanVariance_SSE4_2(const cv::Mat& gray, double& mean, double& variance) {
-#ifdef __SSE4_2__
+#if defined(__x86_64__) || defined(_M_X64)
     const double* data = reinterpret_cast<const double*>(gray.data);
     int total = gray.rows * gray.cols;
 
@@ -257,8 +273,9 @@ void CPUSSIMCalculator::calculateMeanVariance_SSE4_2(const cv::Mat& gray, double
 #endif
 }
 
+SIMD_TARGET("avx2")
 void CPUSSIMCalculator::calculateMeanVariance_AVX2(const cv::Mat& gray, double& mean, double& variance) {
-#ifdef __AVX2__
+#if defined(__x86_64__) || defined(_M_X64)
     const double* data = reinterpret_cast<const double*>(gray.data);
     int total = gray.rows * gray.cols;
 
@@ -292,8 +309,9 @@ void CPUSSIMCalculator::calculateMeanVariance_AVX2(const cv::Mat& gray, double&
 #endif
 }
 
+SIMD_TARGET("avx512f")
 void CPUSSIMCalculator::calculateMeanVariance_AVX512(const cv::Mat& gray, double& mean, double& variance) {
-#ifdef __AVX512F__
+#if defined(__x86_64__) || defined(_M_X64)
     const double* data = reinterpret_cast<const double*>(gray.data);
     int total = gray.rows * gray.cols;
 
@@ -360,8 +378,9 @@ void CPUSSIMCalculator::calculateMeanVariance_NEON(const cv::Mat& gray, double&
 #endif
 }
 
+SIMD_TARGET("sse4.2")
 double CPUSSIMCalculator::calculateCovariance_SSE4_2(const cv::Mat& gray1, const cv::Mat& gray2, double mean1, double mean2) {
-#ifdef __SSE4_2__
+#if defined(__x86_64__) || defined(_M_X64)
     const double* data1 = reinterpret_cast<const double*>(gray1.data);
     const double* data2 = reinterpret_cast<const double*>(gray2.data);
     int total = gray1.rows * gray1.cols;
@@ -401,8 +420,9 @@ double CPUSSIMCalculator::calculateCovariance_SSE4_2(const cv::Mat& gray1, const
 #endif
 }
 
+SIMD_TARGET("avx2")
 double CPUSSIMCalculator::calculateCovariance_AVX2(const cv::Mat& gray1, const cv::Mat& gray2, double mean1, double mean2) {
-#ifdef __AVX2__
+#if defined(__x86_64__) || defined(_M_X64)
     const double* data1 = reinterpret_cast<const double*>(gray1.data);
     const double* data2 = reinterpret_cast<const double*>(gray2.data);
     int total = gray1.rows * gray1.cols;
@@ -437,8 +457,9 @@ double CPUSSIMCalculator::calculateCovariance_AVX2(const cv::Mat& gray1, const c
 #endif
 }
 
+SIMD_TARGET("avx512f")
 double CPUSSIMCalculator::calculateCovariance_AVX512(const cv::Mat& gray1, const cv::Mat& gray2, double mean1, double mean2) {
-#ifdef __AVX512F__
+#if defined(__x86_64__) || defined(_M_X64)
     const double* data1 = reinterpret_cast<const double*>(gray1.data);
     const double* data2 = reinterpret_cast<const double*>(gray2.data);
     int total = gray1.rows * gray1.cols;
@@ -510,6 +531,29 @@ double CPUSSIMCalculator::calculateCovariance_NEON(const cv::Mat& gray1, const c
 #endif
 }
 
+// ============================================================================
+// SerializedSSIMCalculator Implementation
+// ============================================================================
+
+SerializedSSIMCalculator::SerializedSSIMCalculator(SSIMCalculatorBase* calculator)
+    : m_calculator(calculator) {
+}
+
+double SerializedSSIMCalculator::calculateSSIM(const cv::Mat& img1, const cv::Mat& img2) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_calculator->calculateSSIM(img1, img2);
+}
+
+std::vector<double> SerializedSSIMCalculator::calculateBatchSSIM(const std::vector<cv::Mat>& images) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_calculator->calculateBatchSSIM(images);
+}
+
+void SerializedSSIMCalculator::warmUp(int warmupIterations) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calculator->warmUp(warmupIterations);
+}
+
 // ============================================================================
 // PerformanceBenchmark Implementation
 // ============================================================================
@@ -718,11 +762,12 @@ void OptimizationManager::createAvailableCalculators() {
 void OptimizationManager::createCPUCalculators() {
     const auto& supportedSIMD = m_platformDetector.getSupportedSIMD();
 
-    // Create calculators in order of preference (best to worst)
+    // Create one calculator per optimization type; several instruction sets map to the same kernels
+    std::set<OptimizationType> createdTypes;
     for (auto simd : supportedSIMD) {
         try {
             auto calculator = std::make_unique<CPUSSIMCalculator>(simd);
-            if (calculator->isReady()) {
+            if (calculator->isReady() && createdTypes.insert(calculator->getOptimizationType()).second) {
                 m_availableCalculators.push_back(std::move(calculator));
             }
         } catch (const std::exception& e) {
@@ -732,7 +777,7 @@ void OptimizationManager::createCPUCalculators() {
     }
 
     // Always add a generic fallback calculator
-    if (std::find(supportedSIMD.begin(), supportedSIMD.end(), SIMDInstructionSet::None) == supportedSIMD.end()) {
+    if (createdTypes.count(OptimizationType::None) == 0) {
         try {
             auto calculator = std::make_unique<CPUSSIMCalculator>(SIMDInstructionSet::None);
             if (calculator->isReady()) {
@@ -745,14 +790,17 @@ void OptimizationManager::createCPUCalculators() {
 }
 
 void OptimizationManager::createGPUCalculators() {
-    // GPU calculators would be implemented here
-    // For now, we focus on CPU optimizations
-
-    // TODO: Implement GPU calculators for:
-    // - CUDA (NVIDIA GPUs)
-    // - OpenCL (Cross-platform)
-    // - Metal (Apple GPUs)
-    // - DirectX Compute (Windows)
+    for (auto type : GPUCalculatorFactory::getAvailableGPUTypes()) {
+        try {
+            auto calculator = GPUCalculatorFactory::createGPUCalculator(type);
+            if (calculator && calculator->isReady()) {
+                m_availableCalculators.push_back(std::move(calculator));
+            }
+        } catch (const std::exception& e) {
+            logOptimization("Failed to create " + PlatformDetector::toString(type) +
+                           " calculator: " + e.what());
+        }
+    }
 }
 
 void OptimizationManager::selectBestCalculator() {
@@ -760,15 +808,55 @@ void OptimizationManager::selectBestCalculator() {
         return;
     }
 
-    // If benchmarking is enabled, run benchmarks to find the best calculator
+    m_bestCalculator = nullptr;
+
+    // If benchmarking is enabled, reuse the cached winner or benchmark every validated calculator
     if (m_config.enableBenchmarking) {
-        auto testImages = m_benchmark->generateTestImages(5, 640, 480);
-        int bestIndex = m_benchmark->findBestCalculator(m_availableCalculators, testImages, m_config.benchmarkIterations);
+        if (loadCachedSelection()) {
+            return;
+        }
 
-        if (bestIndex >= 0) {
-            m_bestCalculator = m_availableCalculators[bestIndex].get();
-            m_activeOptimization = m_bestCalculator->getOptimizationType();
-            m_performanceMetrics = m_benchmark->getBenchmarkResults();
+        // Score grayscale frames at the default downsample size, as the detection pipeline does
+        auto testImages = m_benchmark->generateTestImages(5, 480, 270);
+        for (auto& image : testImages) {
+            cv::cvtColor(image, image, cv::COLOR_BGR2GRAY);
+        }
+
+        m_performanceMetrics.clear();
+        SSIMCalculatorBase* fastestStable = nullptr;
+        SSIMCalculatorBase* fastest = nullptr;
+        double fastestStableThroughput = 0.0;
+        double fastestThroughput = 0.0;
+
+        for (auto& calculator : m_availableCalculators) {
+            if (!validateCalculator(calculator.get())) {
+                logOptimization(toString(calculator->getOptimizationType()) + " failed validation");
+                continue;
+            }
+
+            OptimizationMetrics metrics = m_benchmark->benchmarkCalculator(calculator.get(), testImages,
+                                                                           m_config.benchmarkIterations);
+            m_performanceMetrics[metrics.type] = metrics;
+            if (!metrics.errorMessage.empty()) {
+                continue;
+            }
+
+            if (metrics.throughput > fastestThroughput) {
+                fastestThroughput = metrics.throughput;
+                fastest = calculator.get();
+            }
+            if (metrics.isStable && metrics.throughput > fastestStableThroughput) {
+                fastestStableThroughput = metrics.throughput;
+                fastestStable = calculator.get();
+            }
+        }
+
+        // Timing noise at startup can mark every run unstable; the fastest valid one still wins then
+        SSIMCalculatorBase* winner = fastestStable ? fastestStable : fastest;
+        if (winner) {
+            m_bestCalculator = winner;
+            m_activeOptimization = winner->getOptimizationType();
+            saveCachedSelection();
             return;
         }
     }
@@ -801,30 +889,134 @@ bool OptimizationManager::validateCalculator(SSIMCalculatorBase* calculator) {
             return false;
         }
 
-        return true;
+        // The backend must reproduce the global SSIM the detection thresholds were tuned on
+        cv::RNG rng(0x5513);
+        cv::Mat textured(90, 160, CV_8UC1);
+        rng.fill(textured, cv::RNG::UNIFORM, 0, 256);
+        cv::Mat shifted = textured * 0.8 + 20;
+
+        SSIMMoments moments;
+        SSIMKernels::computeMoments(textured, shifted, moments, SSIMKernels::momentsScalar);
+        double reference = moments.globalSSIM(SSIM_C1, SSIM_C2);
+
+        ssim = calculator->calculateSSIM(textured, shifted);
+        return !std::isnan(ssim) && std::abs(ssim - reference) <= VALIDATION_TOLERANCE;
     } catch (const std::exception&) {
         return false;
     }
 }
 
+std::string OptimizationManager::machineFingerprint() const {
+    const CPUInfo& cpu = m_platformDetector.getCPUInfo();
+    const PlatformInfo& platform = m_platformDetector.getPlatformInfo();
+    std::ostringstream oss;
+
+    oss << PlatformDetector::toString(cpu.architecture) << "|" << cpu.vendor << "|" << cpu.model
+        << "|" << cpu.logicalCores << "|";
+    for (const auto& simd : cpu.supportedSIMD) {
+        oss << PlatformDetector::toString(simd) << " ";
+    }
+    oss << "|" << platform.compilerName << " " << platform.compilerVersion << "|";
+    for (const auto& calculator : m_availableCalculators) {
+        oss << toString(calculator->getOptimizationType()) << ",";
+    }
+
+    std::string fingerprint = oss.str();
+    std::replace(fingerprint.begin(), fingerprint.end(), '\n', ' ');
+    return fingerprint;
+}
+
+bool OptimizationManager::loadCachedSelection() {
+    if (m_config.benchmarkCachePath.empty()) {
+        return false;
+    }
+
+    std::ifstream file(std::filesystem::u8path(m_config.benchmarkCachePath));
+    if (!file) {
+        return false;
+    }
+
+    std::string machine, backend, line;
+    while (std::getline(file, line)) {
+        if (line.rfind("machine=", 0) == 0) {
+            machine = line.substr(8);
+        } else if (line.rfind("backend=", 0) == 0) {
+            backend = line.substr(8);
+        }
+    }
+
+    // A different CPU, driver set or build invalidates the cached result
+    if (machine != machineFingerprint()) {
+        return false;
+    }
+
+    for (auto& calculator : m_availableCalculators) {
+        if (toString(calculator->getOptimizationType()) == backend && validateCalculator(calculator.get())) {
+            m_bestCalculator = calculator.get();
+            m_activeOptimization = m_bestCalculator->getOptimizationType();
+            logOptimization("Using cached benchmark result: " + backend);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void OptimizationManager::saveCachedSelection() const {
+    if (m_config.benchmarkCachePath.empty() || !m_bestCalculator) {
+        return;
+    }
+
+    const std::filesystem::path path = std::filesystem::u8path(m_config.benchmarkCachePath);
+    std::error_code error;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        logOptimization("Failed to write benchmark cache " + m_config.benchmarkCachePath);
+        return;
+    }
+
+    file << "machine=" << machineFingerprint() << "\n";
+    file << "backend=" << toString(m_activeOptimization) << "\n";
+}
+
 SSIMCalculatorBase* OptimizationManager::getBestCalculator() {
     return m_bestCalculator;
 }
 
+SSIMCalculatorBase* OptimizationManager::getSharedCalculator() {
+    SSIMCalculatorBase* calculator = m_bestCalculator;
+    if (!calculator || calculator->isThreadSafe()) {
+        return calculator;
+    }
+
+    std::lock_guard<std::mutex> lock(m_serializedCalculatorsMutex);
+    std::unique_ptr<SerializedSSIMCalculator>& serialized = m_serializedCalculators[calculator];
+    if (!serialized) {
+        serialized = std::make_unique<SerializedSSIMCalculator>(calculator);
+    }
+    return serialized.get();
+}
+
 double OptimizationManager::calculateSSIM(const cv::Mat& img1, const cv::Mat& img2) {
-    if (!m_bestCalculator) {
+    SSIMCalculatorBase* calculator = getSharedCalculator();
+    if (!calculator) {
         throw std::runtime_error("OptimizationManager not initialized or no calculator available");
     }
 
-    return m_bestCalculator->calculateSSIM(img1, img2);
+    return calculator->calculateSSIM(img1, img2);
 }
 
 std::vector<double> OptimizationManager::calculateBatchSSIM(const std::vector<cv::Mat>& images) {
-    if (!m_bestCalculator) {
+    SSIMCalculatorBase* calculator = getSharedCalculator();
+    if (!calculator) {
         throw std::runtime_error("OptimizationManager not initialized or no calculator available");
     }
 
-    return m_bestCalculator->calculateBatchSSIM(images);
+    return calculator->calculateBatchSSIM(images);
 }
 
 std::vector<OptimizationType> OptimizationManager::getAvailableOptimizations() const {
@@ -932,9 +1124,10 @@ std::string OptimizationManager::generateOptimizationReport() const {
     return oss.str();
 }
 
-void OptimizationManager::logOptimization(const std::string& message) {
+void OptimizationManager::logOptimization(const std::string& message) const {
     if (m_config.enablePerformanceLogging) {
-        std::cout << "[OptimizationManager] " << message << std::endl;
+        // stderr keeps stdout clean for the CLI's JSON output
+        std::cerr << "[OptimizationManager] " << message << std::endl;
     }
 }
 
@@ -2,12 +2,14 @@
 #define OPTIMIZATIONMANAGER_H
 
 #include "platformdetector.h"
+#include "ssimkernels.h"
 #include <memory>
 #include <functional>
 #include <chrono>
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 
 // Forward declarations
@@ -61,6 +63,7 @@ struct OptimizationConfig {
     bool enablePerformanceLogging = true;
     bool enableBenchmarking = false;
     int benchmarkIterations = 10;
+    std::string benchmarkCachePath;      // file remembering the benchmark winner (empty = always benchmark)
     double performanceThreshold = 1.0;   // minimum performance multiplier to use optimization
 
     // Memory constraints
@@ -106,6 +109,12 @@ public:
      */
     virtual bool isReady() const = 0;
 
+    /**
+     * Check if calculateSSIM may be called from several threads at once
+     * @return true if concurrent calls are safe
+     */
+    virtual bool isThreadSafe() const { return false; }
+
     /**
      * Get initialization error message if any
      * @return Error message or empty string if no error
@@ -137,10 +146,12 @@ public:
     std::vector<double> calculateBatchSSIM(const std::vector<cv::Mat>& images) override;
     OptimizationType getOptimizationType() const override;
     bool isReady() const override { return m_isReady; }
+    bool isThreadSafe() const override { return true; }
     std::string getErrorMessage() const override { return m_errorMessage; }
 
 private:
     SIMDInstructionSet m_instructionSet;
+    SSIMMomentsFunction m_momentsKernel = nullptr;  // Fused kernel for 8-bit grayscale pairs
     bool m_isReady = false;
     std::string m_errorMessage;
 
@@ -163,6 +174,31 @@ private:
     double calculateCovariance_NEON(const cv::Mat& gray1, const cv::Mat& gray2, double mean1, double mean2);
 };
 
+/**
+ * Serializes calls into a backend that is not thread-safe
+ *
+ * Every pipeline scores through the same process-wide backend; this wrapper holds the one
+ * lock all of them share, so a GPU queue is never driven from two threads at once.
+ */
+class SerializedSSIMCalculator : public SSIMCalculatorBase {
+public:
+    explicit SerializedSSIMCalculator(SSIMCalculatorBase* calculator);
+    ~SerializedSSIMCalculator() override = default;
+
+    double calculateSSIM(const cv::Mat& img1, const cv::Mat& img2) override;
+    std::vector<double> calculateBatchSSIM(const std::vector<cv::Mat>& images) override;
+    OptimizationType getOptimizationType() const override { return m_calculator->getOptimizationType(); }
+    bool isReady() const override { return m_calculator->isReady(); }
+    bool isThreadSafe() const override { return m_calculator->isThreadSafe(); }
+    std::string getErrorMessage() const override { return m_calculator->getErrorMessage(); }
+    void warmUp(int warmupIterations = 3) override;
+    size_t getMemoryUsage() const override { return m_calculator->getMemoryUsage(); }
+
+private:
+    SSIMCalculatorBase* m_calculator;  // Owned by OptimizationManager
+    std::mutex m_mutex;
+};
+
 /**
  * Performance benchmarking system for optimization selection
  */
@@ -257,6 +293,13 @@ public:
      */
     SSIMCalculatorBase* getBestCalculator();
 
+    /**
+     * Get the best calculator in a form several pipelines may share. Backends that are not
+     * thread-safe are wrapped so all callers serialize on one lock per backend.
+     * @return Pointer to the shared scorer, or nullptr if none available
+     */
+    SSIMCalculatorBase* getSharedCalculator();
+
     /**
      * Calculate SSIM using the best available optimization
      * @param img1 First image
@@ -394,17 +437,34 @@ private:
     void selectBestCalculator();
 
     /**
-     * Validate calculator functionality
+     * Validate calculator functionality against the scalar reference scores
      * @param calculator Calculator to validate
      * @return true if calculator is functional
      */
     bool validateCalculator(SSIMCalculatorBase* calculator);
 
+    /**
+     * Describe this machine and build for keying the benchmark cache
+     * @return Fingerprint string (single line)
+     */
+    std::string machineFingerprint() const;
+
+    /**
+     * Activate the backend recorded in the benchmark cache for this machine
+     * @return true if a cached backend was found and validated
+     */
+    bool loadCachedSelection();
+
+    /**
+     * Record the active backend in the benchmark cache
+     */
+    void saveCachedSelection() const;
+
     /**
      * Log optimization selection and performance
      * @param message Log message
      */
-    void logOptimization(const std::string& message);
+    void logOptimization(const std::string& message) const;
 
     // Member variables
     PlatformDetector& m_platformDetector;
@@ -415,6 +475,11 @@ private:
     std::unordered_map<OptimizationType, OptimizationMetrics> m_performanceMetrics;
     std::unique_ptr<PerformanceBenchmark> m_benchmark;
 
+    // Serializing wrappers handed out by getSharedCalculator(), one per backend; kept for
+    // the lifetime of the manager since pipelines hold on to them
+    std::unordered_map<SSIMCalculatorBase*, std::unique_ptr<SerializedSSIMCalculator>> m_serializedCalculators;
+    std::mutex m_serializedCalculatorsMutex;
+
     bool m_isInitialized = false;
     bool m_forcedOptimization = false;
     std::string m_errorMessage;
@@ -422,6 +487,7 @@ private:
     // Constants
     static constexpr double SSIM_C1 = 6.5025;   // (0.01 * 255)^2
     static constexpr double SSIM_C2 = 58.5225;  // (0.03 * 255)^2
+    static constexpr double VALIDATION_TOLERANCE = 1e-4;  // Max deviation from the reference score
 };
 
 #endif // OPTIMIZATIONMANAGER_H
\ No newline at end of file
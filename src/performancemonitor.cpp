@@ -138,6 +138,23 @@ void PerformanceMonitor::addMeasurement(const PerformanceMeasurement& measuremen
     }
 }
 
+void PerformanceMonitor::recordSample(const std::string& name, double value, const std::string& category) {
+    if (!m_monitoringEnabled) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_performanceMutex);
+
+    auto& stats = m_performanceStats[name];
+    if (stats.name.empty()) {
+        stats.name = name;
+        stats.category = category;
+    }
+    stats.addMeasurement(value);
+
+    emit statsUpdated(name, stats);
+}
+
 const PerformanceStats* PerformanceMonitor::getStats(const std::string& name) const {
     std::lock_guard<std::mutex> lock(m_performanceMutex);
 
@@ -161,6 +161,15 @@ public:
      */
     void addMeasurement(const PerformanceMeasurement& measurement);
 
+    /**
+     * Record a sampled value (e.g. queue occupancy or stall time) into the statistics
+     * Unlike addMeasurement, samples are not stored individually or logged
+     * @param name Statistic name
+     * @param value Sampled value
+     * @param category Optional category
+     */
+    void recordSample(const std::string& name, double value, const std::string& category = "");
+
     /**
      * Get performance statistics for a specific measurement name
      * @param name Measurement name
@@ -0,0 +1,137 @@
+#include "phashcache.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+
+PHashCache::PHashCache(const QString& directory, quint32 algorithm)
+    : m_directory(directory), m_dirty(false), m_algorithm(algorithm)
+{
+}
+
+QString PHashCache::cacheFilePath(const QString& directory)
+{
+    return QDir(directory).filePath(".phashCache");
+}
+
+bool PHashCache::load()
+{
+    m_entries.clear();
+    m_used.clear();
+    m_dirty = false;
+
+    QFile file(cacheFilePath(m_directory));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0, version = 0, algorithm = 0, count = 0;
+    in >> magic >> version >> algorithm >> count;
+    if (in.status() != QDataStream::Ok || magic != FILE_MAGIC ||
+        version != FORMAT_VERSION || algorithm != m_algorithm) {
+        // Outdated or foreign file: rewrite it on the next save
+        m_dirty = true;
+        return false;
+    }
+
+    for (quint32 i = 0; i < count; i++) {
+        QString fileName;
+        Entry entry;
+        quint64 words[4];
+        in >> fileName >> entry.size >> entry.modifiedMs >> words[0] >> words[1] >> words[2] >> words[3];
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "PHashCache: Discarding truncated cache file" << file.fileName();
+            m_entries.clear();
+            m_dirty = true;
+            return false;
+        }
+
+        for (int k = 0; k < 4; k++) {
+            entry.hash.words[k] = words[k];
+        }
+        entry.hash.valid = true;
+        m_entries.insert(fileName, entry);
+    }
+
+    return true;
+}
+
+bool PHashCache::save()
+{
+    // Drop entries for images that are gone (deleted or moved to trash)
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!m_used.contains(it.key())) {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (!m_dirty) {
+        return true;
+    }
+
+    QSaveFile file(cacheFilePath(m_directory));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "PHashCache: Failed to open cache file for writing:" << file.fileName();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << FILE_MAGIC << FORMAT_VERSION << m_algorithm << static_cast<quint32>(m_entries.size());
+
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        const Entry& entry = it.value();
+        out << it.key() << entry.size << entry.modifiedMs
+            << static_cast<quint64>(entry.hash.words[0]) << static_cast<quint64>(entry.hash.words[1])
+            << static_cast<quint64>(entry.hash.words[2]) << static_cast<quint64>(entry.hash.words[3]);
+    }
+
+    if (!file.commit()) {
+        qWarning() << "PHashCache: Failed to write cache file:" << file.fileName();
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+bool PHashCache::lookup(const QFileInfo& fileInfo, PHash& hash)
+{
+    auto it = m_entries.constFind(fileInfo.fileName());
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+
+    if (it->size != fileInfo.size() ||
+        it->modifiedMs != fileInfo.lastModified().toMSecsSinceEpoch()) {
+        return false;
+    }
+
+    m_used.insert(fileInfo.fileName());
+    hash = it->hash;
+    return true;
+}
+
+void PHashCache::insert(const QFileInfo& fileInfo, const PHash& hash)
+{
+    if (!hash.valid) {
+        return;
+    }
+
+    Entry entry;
+    entry.size = fileInfo.size();
+    entry.modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry.hash = hash;
+
+    m_entries.insert(fileInfo.fileName(), entry);
+    m_used.insert(fileInfo.fileName());
+    m_dirty = true;
+}
@@ -0,0 +1,84 @@
+#ifndef PHASHCACHE_H
+#define PHASHCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QFileInfo>
+#include "phashcalculator.h"
+
+/**
+ * @brief Per-folder on-disk cache of image pHashes
+ *
+ * Stored as a compact binary file (.phashCache) next to the images it
+ * describes. Entries are keyed by file name and validated against the file
+ * size and modification time, so edited or replaced images are rehashed.
+ * Only entries looked up or inserted since load() are written back, which
+ * drops images that were deleted or moved to trash in the meantime.
+ */
+class PHashCache
+{
+public:
+    // Hash algorithm identifiers; bump when the corresponding PHashCalculator output changes
+    static constexpr quint32 ALGORITHM_REFERENCE = 1;    // calculatePHash()
+    static constexpr quint32 ALGORITHM_FAST = 2;         // calculatePHashFast()
+
+    /**
+     * @brief Constructor
+     * @param directory Folder containing the images and the cache file
+     * @param algorithm Hash algorithm the cached values must have been produced with
+     */
+    PHashCache(const QString& directory, quint32 algorithm);
+
+    /**
+     * @brief Load the cache file; a missing, corrupt or outdated file yields an empty cache
+     * @return true if cached entries were loaded
+     */
+    bool load();
+
+    /**
+     * @brief Save the entries used since load()
+     * @return true if saved successfully (or nothing changed)
+     */
+    bool save();
+
+    /**
+     * @brief Look up a cached hash
+     * @param fileInfo Image file (must be inside the cache directory)
+     * @param hash Output hash
+     * @return true if a hash for this exact file version is cached
+     */
+    bool lookup(const QFileInfo& fileInfo, PHash& hash);
+
+    /**
+     * @brief Add or replace the hash of an image
+     * @param fileInfo Image file (must be inside the cache directory)
+     * @param hash Hash to store; invalid hashes are ignored
+     */
+    void insert(const QFileInfo& fileInfo, const PHash& hash);
+
+    /**
+     * @brief Get the cache file path for a folder
+     * @param directory Image folder
+     * @return Path of the cache file
+     */
+    static QString cacheFilePath(const QString& directory);
+
+private:
+    struct Entry {
+        qint64 size;
+        qint64 modifiedMs;
+        PHash hash;
+    };
+
+    QString m_directory;
+    QHash<QString, Entry> m_entries;    // File name -> cached hash
+    QSet<QString> m_used;               // Entries looked up or inserted since load()
+    bool m_dirty;
+    quint32 m_algorithm;
+
+    static constexpr quint32 FILE_MAGIC = 0x50484331;    // "PHC1"
+    static constexpr quint32 FORMAT_VERSION = 1;
+};
+
+#endif // PHASHCACHE_H
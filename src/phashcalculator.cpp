@@ -3,21 +3,21 @@
 #include <algorithm>
 #include <cmath>
 
-std::vector<uint8_t> PHashCalculator::calculatePHash(const QString& imagePath)
+PHash PHashCalculator::calculatePHash(const QString& imagePath)
 {
     // Load image using Unicode-safe helper
     cv::Mat image = ImageIOHelper::imreadUnicode(imagePath, cv::IMREAD_COLOR);
     if (image.empty()) {
-        return std::vector<uint8_t>();
+        return PHash();
     }
 
     return calculatePHash(image);
 }
 
-std::vector<uint8_t> PHashCalculator::calculatePHash(const cv::Mat& image)
+PHash PHashCalculator::calculatePHash(const cv::Mat& image)
 {
     if (image.empty()) {
-        return std::vector<uint8_t>();
+        return PHash();
     }
 
     // Step 1: Convert to grayscale
@@ -25,9 +25,51 @@ std::vector<uint8_t> PHashCalculator::calculatePHash(const cv::Mat& image)
     if (image.channels() == 3 || image.channels() == 4) {
         cv::cvtColor(image, grayscale, cv::COLOR_BGR2GRAY);
     } else {
-        grayscale = image.clone();
+        grayscale = image;
     }
 
+    return hashGrayscale(grayscale);
+}
+
+PHash PHashCalculator::calculatePHashFast(const QString& imagePath)
+{
+    // Decode straight to grayscale at reduced scale; non-JPEG files are decoded in full
+    cv::Mat grayscale = ImageIOHelper::imreadUnicodeReduced(imagePath, FAST_MIN_SIDE, FAST_MIN_SIDE, true);
+    if (grayscale.empty()) {
+        return PHash();
+    }
+
+    return hashGrayscale(grayscale);
+}
+
+PHash PHashCalculator::calculatePHashFast(const cv::Mat& image)
+{
+    if (image.empty()) {
+        return PHash();
+    }
+
+    cv::Mat grayscale;
+    if (image.channels() == 3 || image.channels() == 4) {
+        cv::cvtColor(image, grayscale, cv::COLOR_BGR2GRAY);
+    } else {
+        grayscale = image;
+    }
+
+    // Mirror libjpeg DCT scaling, which rounds the reduced size up
+    int scale = ImageIOHelper::reducedDecodeScale(grayscale.cols, grayscale.rows, FAST_MIN_SIDE, FAST_MIN_SIDE);
+    if (scale > 1) {
+        cv::Mat reduced;
+        cv::resize(grayscale, reduced,
+                   cv::Size((grayscale.cols + scale - 1) / scale, (grayscale.rows + scale - 1) / scale),
+                   0, 0, cv::INTER_AREA);
+        grayscale = reduced;
+    }
+
+    return hashGrayscale(grayscale);
+}
+
+PHash PHashCalculator::hashGrayscale(const cv::Mat& grayscale)
+{
     // Step 2: Resize to DCT_SIDE_DIM x DCT_SIDE_DIM
     cv::Mat resized;
     cv::resize(grayscale, resized, cv::Size(DCT_SIDE_DIM, DCT_SIDE_DIM), 0, 0, cv::INTER_LINEAR);
@@ -36,12 +78,9 @@ std::vector<uint8_t> PHashCalculator::calculatePHash(const cv::Mat& image)
     cv::Mat floatImage;
     resized.convertTo(floatImage, CV_32F);
 
-    // Step 4: Apply DCT
-    cv::Mat dctCoeffs;
-    applyDCT(floatImage, dctCoeffs);
-
-    // Step 5: Extract low-frequency coefficients (top-left HASH_SIDE_DIM x HASH_SIDE_DIM)
-    cv::Mat lowFreq = dctCoeffs(cv::Rect(0, 0, HASH_SIDE_DIM, HASH_SIDE_DIM)).clone();
+    // Step 4-5: Low-frequency DCT coefficients (top-left HASH_SIDE_DIM x HASH_SIDE_DIM)
+    cv::Mat lowFreq;
+    lowFrequencyDCT(floatImage, lowFreq);
 
     // Step 6: Remove DC component (top-left coefficient)
     std::vector<float> acCoeffs;
@@ -53,27 +92,17 @@ std::vector<uint8_t> PHashCalculator::calculatePHash(const cv::Mat& image)
         }
     }
 
-    // Step 7: Calculate median
-    double median = 0.0;
-    if (!acCoeffs.empty()) {
-        std::vector<float> sortedCoeffs = acCoeffs;
-        std::sort(sortedCoeffs.begin(), sortedCoeffs.end());
-        size_t mid = sortedCoeffs.size() / 2;
-        if (sortedCoeffs.size() % 2 == 0) {
-            median = (sortedCoeffs[mid - 1] + sortedCoeffs[mid]) / 2.0;
-        } else {
-            median = sortedCoeffs[mid];
-        }
-    }
+    // Step 7: Calculate median (on a copy, bit order follows acCoeffs)
+    std::vector<float> medianScratch = acCoeffs;
+    double median = calculateMedian(medianScratch);
 
     // Step 8: Generate hash bits (compare each AC coefficient with median)
-    std::vector<uint8_t> hash(32, 0);  // 256 bits = 32 bytes
+    PHash hash;
+    hash.valid = true;
     int bitIndex = 0;
     for (float coeff : acCoeffs) {
         if (coeff >= median) {
-            int byteIndex = bitIndex / 8;
-            int bitOffset = 7 - (bitIndex % 8);  // MSB first
-            hash[byteIndex] |= (1 << bitOffset);
+            hash.words[bitIndex / 64] |= 1ULL << (63 - bitIndex % 64);  // MSB first
         }
         bitIndex++;
     }
@@ -81,87 +110,75 @@ std::vector<uint8_t> PHashCalculator::calculatePHash(const cv::Mat& image)
     return hash;
 }
 
-void PHashCalculator::applyDCT(const cv::Mat& input, cv::Mat& output)
+void PHashCalculator::lowFrequencyDCT(const cv::Mat& input, cv::Mat& output)
 {
-    // OpenCV's dct function performs 2D DCT
-    cv::dct(input, output);
+    // Rows of the orthonormal DCT-II matrix used by cv::dct, restricted to the
+    // lowest HASH_SIDE_DIM frequencies (thread-safe one-time initialization)
+    static const cv::Mat basis = []() {
+        cv::Mat b(HASH_SIDE_DIM, DCT_SIDE_DIM, CV_32F);
+        for (int k = 0; k < HASH_SIDE_DIM; k++) {
+            double scale = std::sqrt((k == 0 ? 1.0 : 2.0) / DCT_SIDE_DIM);
+            for (int n = 0; n < DCT_SIDE_DIM; n++) {
+                b.at<float>(k, n) = static_cast<float>(scale * std::cos(CV_PI * (2 * n + 1) * k / (2.0 * DCT_SIDE_DIM)));
+            }
+        }
+        return b;
+    }();
+    static const cv::Mat basisT = basis.t();
+
+    // Separable transform: rows first (16x64), then columns (16x16)
+    cv::Mat rowPass = basis * input;
+    output = rowPass * basisT;
 }
 
-double PHashCalculator::calculateMedian(const cv::Mat& mat)
+double PHashCalculator::calculateMedian(std::vector<float>& values)
 {
-    std::vector<float> values;
-    values.reserve(mat.rows * mat.cols);
-
-    for (int i = 0; i < mat.rows; i++) {
-        for (int j = 0; j < mat.cols; j++) {
-            values.push_back(mat.at<float>(i, j));
-        }
-    }
-
     if (values.empty()) return 0.0;
 
-    std::sort(values.begin(), values.end());
+    // Partial selection instead of a full sort
     size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
 
     if (values.size() % 2 == 0) {
-        return (values[mid - 1] + values[mid]) / 2.0;
-    } else {
-        return values[mid];
-    }
-}
-
-int PHashCalculator::hammingDistance(const std::vector<uint8_t>& hash1, const std::vector<uint8_t>& hash2)
-{
-    if (hash1.size() != 32 || hash2.size() != 32) {
-        return -1;  // Invalid hash size
+        // The lower middle value is the largest element of the left partition
+        double lower = *std::max_element(values.begin(), values.begin() + mid);
+        return (lower + upper) / 2.0;
     }
-
-    int distance = 0;
-    for (size_t i = 0; i < 32; i++) {
-        uint8_t xorResult = hash1[i] ^ hash2[i];
-        // Count set bits using Brian Kernighan's algorithm
-        while (xorResult) {
-            distance++;
-            xorResult &= (xorResult - 1);
-        }
-    }
-
-    return distance;
+    return upper;
 }
 
-QString PHashCalculator::hashToHexString(const std::vector<uint8_t>& hash)
+QString PHashCalculator::hashToHexString(const PHash& hash)
 {
-    if (hash.size() != 32) {
+    if (!hash.valid) {
         return QString();
     }
 
     QString hexString;
-    hexString.reserve(64);  // 32 bytes = 64 hex characters
+    hexString.reserve(64);  // 4 words = 64 hex characters
 
-    for (uint8_t byte : hash) {
-        hexString.append(QString("%1").arg(byte, 2, 16, QChar('0')));
+    for (uint64_t word : hash.words) {
+        hexString.append(QString("%1").arg(static_cast<qulonglong>(word), 16, 16, QChar('0')));
     }
 
     return hexString;
 }
 
-std::vector<uint8_t> PHashCalculator::hexStringToHash(const QString& hexString)
+PHash PHashCalculator::hexStringToHash(const QString& hexString)
 {
     if (hexString.length() != 64) {
-        return std::vector<uint8_t>();
+        return PHash();
     }
 
-    std::vector<uint8_t> hash;
-    hash.reserve(32);
-
-    for (int i = 0; i < 64; i += 2) {
+    PHash hash;
+    for (int i = 0; i < 4; i++) {
         bool ok;
-        uint8_t byte = hexString.mid(i, 2).toUInt(&ok, 16);
+        hash.words[i] = hexString.mid(i * 16, 16).toULongLong(&ok, 16);
         if (!ok) {
-            return std::vector<uint8_t>();
+            return PHash();
         }
-        hash.push_back(byte);
     }
+    hash.valid = true;
 
     return hash;
 }
@@ -3,9 +3,27 @@
 
 #include <opencv2/opencv.hpp>
 #include <QString>
+#include <array>
 #include <cstdint>
 #include <vector>
 
+#if defined(_MSC_VER) && defined(__AVX__)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief 256-bit perceptual hash packed into four 64-bit words
+ *
+ * Hash bit i is bit (63 - i % 64) of words[i / 64], i.e. the MSB-first order
+ * of the 64-character hex representation. A default-constructed hash is invalid.
+ */
+struct PHash {
+    std::array<uint64_t, 4> words;
+    bool valid;     // false if the hash could not be computed or parsed
+
+    PHash() : words{}, valid(false) {}
+};
+
 /**
  * @brief 256-bit Perceptual Hash (pHash) Calculator
  *
@@ -19,57 +37,117 @@ public:
     /**
      * @brief Calculate 256-bit perceptual hash of an image
      * @param imagePath Path to the image file
-     * @return 256-bit hash as a 32-byte array (returns empty vector on error)
+     * @return 256-bit hash (invalid on error)
      */
-    static std::vector<uint8_t> calculatePHash(const QString& imagePath);
+    static PHash calculatePHash(const QString& imagePath);
 
     /**
      * @brief Calculate 256-bit perceptual hash from OpenCV Mat
      * @param image OpenCV Mat image (will be converted to grayscale if needed)
-     * @return 256-bit hash as a 32-byte array (returns empty vector on error)
+     * @return 256-bit hash (invalid on error)
+     */
+    static PHash calculatePHash(const cv::Mat& image);
+
+    /**
+     * @brief Calculate the pHash of an image file without decoding it at full resolution
+     *
+     * JPEGs are decoded to grayscale with libjpeg DCT scaling (1/2, 1/4 or 1/8) while
+     * keeping at least FAST_MIN_SIDE pixels per side, then hashed like calculatePHash().
+     * The box-filtered reduced image is sampled slightly differently from a full decode,
+     * so a few bits may differ from calculatePHash(); hashes from both paths should not
+     * be mixed within one comparison set.
+     * @param imagePath Path to the image file
+     * @return 256-bit hash (invalid on error)
      */
-    static std::vector<uint8_t> calculatePHash(const cv::Mat& image);
+    static PHash calculatePHashFast(const QString& imagePath);
+
+    /**
+     * @brief Calculate the fast-path pHash of an in-memory image
+     * Area-averages the image to the size calculatePHashFast() would decode a JPEG of the
+     * same dimensions to, so hashes of frames and of their saved files stay comparable.
+     * @param image OpenCV Mat image (will be converted to grayscale if needed)
+     * @return 256-bit hash (invalid on error)
+     */
+    static PHash calculatePHashFast(const cv::Mat& image);
 
     /**
      * @brief Calculate Hamming distance between two pHashes
-     * @param hash1 First hash (32 bytes)
-     * @param hash2 Second hash (32 bytes)
-     * @return Hamming distance (number of differing bits), or -1 on error
+     * @param hash1 First hash
+     * @param hash2 Second hash
+     * @return Hamming distance (number of differing bits), or -1 if either hash is invalid
+     */
+    static int hammingDistance(const PHash& hash1, const PHash& hash2)
+    {
+        if (!hash1.valid || !hash2.valid) {
+            return -1;
+        }
+        return popcount64(hash1.words[0] ^ hash2.words[0]) + popcount64(hash1.words[1] ^ hash2.words[1]) +
+               popcount64(hash1.words[2] ^ hash2.words[2]) + popcount64(hash1.words[3] ^ hash2.words[3]);
+    }
+
+    /**
+     * @brief Count the set bits of a 64-bit word (POPCNT where the build enables it)
+     * @param value Word to count
+     * @return Number of set bits
      */
-    static int hammingDistance(const std::vector<uint8_t>& hash1, const std::vector<uint8_t>& hash2);
+    static int popcount64(uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(value);
+#elif defined(_MSC_VER) && defined(__AVX__) && (defined(_M_X64) || defined(_M_AMD64))
+        return static_cast<int>(__popcnt64(value));
+#else
+        value = value - ((value >> 1) & 0x5555555555555555ULL);
+        value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+        value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+#endif
+    }
 
     /**
-     * @brief Convert hash bytes to hex string
-     * @param hash Hash as byte array
-     * @return Hex string representation
+     * @brief Convert a hash to hex string
+     * @param hash Hash to convert
+     * @return Hex string representation (64 characters), empty if the hash is invalid
      */
-    static QString hashToHexString(const std::vector<uint8_t>& hash);
+    static QString hashToHexString(const PHash& hash);
 
     /**
-     * @brief Convert hex string to hash bytes
+     * @brief Convert hex string to hash
      * @param hexString Hex string representation
-     * @return Hash as byte array (returns empty vector on error)
+     * @return Parsed hash (invalid on error)
      */
-    static std::vector<uint8_t> hexStringToHash(const QString& hexString);
+    static PHash hexStringToHash(const QString& hexString);
 
 private:
     /**
-     * @brief Apply 2D Discrete Cosine Transform
-     * @param input Input matrix (grayscale image)
-     * @param output Output DCT coefficients
+     * @brief Hash a grayscale image: resize to DCT_SIDE_DIM, low-frequency DCT, median threshold
+     * @param grayscale Single-channel 8-bit image
+     * @return 256-bit hash
+     */
+    static PHash hashGrayscale(const cv::Mat& grayscale);
+
+    /**
+     * @brief Compute the top-left HASH_SIDE_DIM x HASH_SIDE_DIM block of the 2D DCT
+     *
+     * Equivalent to cropping cv::dct() of the full DCT_SIDE_DIM x DCT_SIDE_DIM input,
+     * but multiplies by a precomputed 16x64 orthonormal DCT-II basis on both sides
+     * (B * X * B^T) instead of computing all 4096 coefficients.
+     * @param input Input matrix (CV_32F, DCT_SIDE_DIM x DCT_SIDE_DIM)
+     * @param output Output coefficients (CV_32F, HASH_SIDE_DIM x HASH_SIDE_DIM)
      */
-    static void applyDCT(const cv::Mat& input, cv::Mat& output);
+    static void lowFrequencyDCT(const cv::Mat& input, cv::Mat& output);
 
     /**
-     * @brief Calculate median of a matrix
-     * @param mat Input matrix
+     * @brief Calculate median of a set of values
+     * @param values Values (reordered in place)
      * @return Median value
      */
-    static double calculateMedian(const cv::Mat& mat);
+    static double calculateMedian(std::vector<float>& values);
 
     // Constants for pHash calculation
     static constexpr int HASH_SIDE_DIM = 16;  // 16x16 = 256 bits
     static constexpr int DCT_SIDE_DIM = 64;   // 64x64 DCT (4x hash dimension)
+    static constexpr int FAST_MIN_SIDE = 2 * DCT_SIDE_DIM;  // Reduced decodes keep 2x the DCT input size
 };
 
 #endif // PHASHCALCULATOR_H
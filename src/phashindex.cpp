@@ -0,0 +1,267 @@
+#include "phashindex.h"
+#include "platformdetector.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define PHASH_KERNELS_X86 1
+#endif
+
+namespace {
+
+/**
+ * Batch kernel signature: distances from one query to `count` hashes stored as four word arrays
+ */
+using HammingKernel = void (*)(const uint64_t* const words[4], size_t count, const PHash& query, int* distances);
+
+/**
+ * Portable kernel, also used for the tails of the SIMD kernels
+ */
+inline void hammingDistancesScalar(const uint64_t* const words[4], size_t begin, size_t count, const PHash& query, int* distances)
+{
+    for (size_t i = begin; i < count; ++i) {
+        distances[i] = PHashCalculator::popcount64(words[0][i] ^ query.words[0]) +
+                       PHashCalculator::popcount64(words[1][i] ^ query.words[1]) +
+                       PHashCalculator::popcount64(words[2][i] ^ query.words[2]) +
+                       PHashCalculator::popcount64(words[3][i] ^ query.words[3]);
+    }
+}
+
+void hammingScalar(const uint64_t* const words[4], size_t count, const PHash& query, int* distances)
+{
+    hammingDistancesScalar(words, 0, count, query, distances);
+}
+
+#if PHASH_KERNELS_X86
+
+/**
+ * Scalar loop compiled with the POPCNT instruction
+ */
+SIMD_TARGET("popcnt")
+void hammingPopcnt(const uint64_t* const words[4], size_t count, const PHash& query, int* distances)
+{
+    hammingDistancesScalar(words, 0, count, query, distances);
+}
+
+/**
+ * Per-byte popcount of a 256-bit vector using a nibble lookup table
+ */
+SIMD_TARGET("avx2")
+inline __m256i popcountBytes(__m256i value)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_and_si256(value, lowMask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), lowMask);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+}
+
+SIMD_TARGET("avx2,popcnt")
+void hammingAVX2(const uint64_t* const words[4], size_t count, const PHash& query, int* distances)
+{
+    // 4 hashes per iteration; byte counts of all four words fit in a byte (max 32) before the final SAD
+    const __m256i q0 = _mm256_set1_epi64x(static_cast<long long>(query.words[0]));
+    const __m256i q1 = _mm256_set1_epi64x(static_cast<long long>(query.words[1]));
+    const __m256i q2 = _mm256_set1_epi64x(static_cast<long long>(query.words[2]));
+    const __m256i q3 = _mm256_set1_epi64x(static_cast<long long>(query.words[3]));
+    alignas(32) uint64_t sums[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i bytes = popcountBytes(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words[0] + i)), q0));
+        bytes = _mm256_add_epi8(bytes, popcountBytes(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words[1] + i)), q1)));
+        bytes = _mm256_add_epi8(bytes, popcountBytes(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words[2] + i)), q2)));
+        bytes = _mm256_add_epi8(bytes, popcountBytes(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words[3] + i)), q3)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+        for (int lane = 0; lane < 4; ++lane) {
+            distances[i + lane] = static_cast<int>(sums[lane]);
+        }
+    }
+    hammingDistancesScalar(words, i, count, query, distances);
+}
+
+SIMD_TARGET("avx512f,avx512vpopcntdq,popcnt")
+void hammingAVX512(const uint64_t* const words[4], size_t count, const PHash& query, int* distances)
+{
+    // 8 hashes per iteration with native 64-bit popcount
+    const __m512i q0 = _mm512_set1_epi64(static_cast<long long>(query.words[0]));
+    const __m512i q1 = _mm512_set1_epi64(static_cast<long long>(query.words[1]));
+    const __m512i q2 = _mm512_set1_epi64(static_cast<long long>(query.words[2]));
+    const __m512i q3 = _mm512_set1_epi64(static_cast<long long>(query.words[3]));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i sum = _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(words[0] + i), q0));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(words[1] + i), q1)));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(words[2] + i), q2)));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(words[3] + i), q3)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(distances + i), _mm512_cvtepi64_epi32(sum));
+    }
+    hammingDistancesScalar(words, i, count, query, distances);
+}
+
+#endif // PHASH_KERNELS_X86
+
+/**
+ * Selected batch kernel and its name for logging
+ */
+struct HammingKernelEntry {
+    HammingKernel kernel;
+    const char* name;
+};
+
+/**
+ * Pick the widest kernel the CPU supports
+ */
+HammingKernelEntry selectHammingKernel()
+{
+#if PHASH_KERNELS_X86
+    const PlatformDetector& detector = PlatformDetector::getInstance();
+    if (detector.isSIMDSupported(SIMDInstructionSet::AVX512F) &&
+        detector.isSIMDSupported(SIMDInstructionSet::AVX512VPOPCNTDQ)) {
+        return {hammingAVX512, "AVX-512 VPOPCNTDQ"};
+    }
+    if (detector.isSIMDSupported(SIMDInstructionSet::AVX2)) {
+        return {hammingAVX2, "AVX2"};
+    }
+    if (detector.isSIMDSupported(SIMDInstructionSet::SSE4_2)) {
+        return {hammingPopcnt, "POPCNT"};   // POPCNT ships with every SSE4.2 CPU
+    }
+#endif
+    return {hammingScalar, "Scalar"};
+}
+
+/**
+ * Kernel used by every table, selected once per process
+ */
+const HammingKernelEntry& activeHammingKernel()
+{
+    static const HammingKernelEntry entry = selectHammingKernel();
+    return entry;
+}
+
+} // namespace
+
+void PHashTable::append(const PHash& hash)
+{
+    for (int k = 0; k < 4; ++k) {
+        m_words[k].push_back(hash.words[k]);
+    }
+}
+
+void PHashTable::reserve(size_t count)
+{
+    for (std::vector<uint64_t>& words : m_words) {
+        words.reserve(count);
+    }
+}
+
+PHash PHashTable::at(size_t index) const
+{
+    PHash hash;
+    for (int k = 0; k < 4; ++k) {
+        hash.words[k] = m_words[k][index];
+    }
+    hash.valid = true;
+    return hash;
+}
+
+void PHashTable::hammingDistances(const PHash& query, int* distances) const
+{
+    const uint64_t* const words[4] = {m_words[0].data(), m_words[1].data(), m_words[2].data(), m_words[3].data()};
+    activeHammingKernel().kernel(words, size(), query, distances);
+}
+
+const char* PHashTable::kernelName()
+{
+    return activeHammingKernel().name;
+}
+
+PHashIndex::PHashIndex(int radius)
+    : m_radius(radius)
+{
+    int chunks = std::max(radius + 1, MIN_CHUNKS);
+    m_chunkCount = chunks <= MAX_CHUNKS ? chunks : 0;
+    m_buckets.resize(m_chunkCount);
+}
+
+void PHashIndex::reserve(size_t count)
+{
+    m_hashes.reserve(count);
+    m_ids.reserve(count);
+    for (auto& buckets : m_buckets) {
+        buckets.reserve(count);
+    }
+}
+
+uint64_t PHashIndex::chunkKey(const PHash& hash, int chunk) const
+{
+    // Substring k covers bits [k * 256 / m, (k + 1) * 256 / m), at most 64 bits spanning up to two words
+    const int begin = chunk * HASH_BITS / m_chunkCount;
+    const int end = (chunk + 1) * HASH_BITS / m_chunkCount;
+
+    uint64_t key = 0;
+    int bit = begin;
+    while (bit < end) {
+        const int offset = bit % 64;
+        const int take = std::min(64 - offset, end - bit);
+        const uint64_t part = (hash.words[bit / 64] << offset) >> (64 - take);
+        key = take == 64 ? part : (key << take) | part;
+        bit += take;
+    }
+    return key;
+}
+
+void PHashIndex::insert(int id, const PHash& hash)
+{
+    if (!hash.valid) {
+        return;
+    }
+
+    const int entry = static_cast<int>(m_hashes.size());
+    m_hashes.append(hash);
+    m_ids.push_back(id);
+
+    for (int chunk = 0; chunk < m_chunkCount; ++chunk) {
+        m_buckets[chunk][chunkKey(hash, chunk)].push_back(entry);
+    }
+}
+
+std::vector<int> PHashIndex::radiusSearch(const PHash& query) const
+{
+    std::vector<int> matches;
+    if (m_hashes.size() == 0 || !query.valid || m_radius < 0) {
+        return matches;
+    }
+
+    // Small tables and unsplittable radii: compare against everything in one batch
+    if (m_chunkCount == 0 || m_hashes.size() < SCAN_THRESHOLD) {
+        std::vector<int> distances(m_hashes.size());
+        m_hashes.hammingDistances(query, distances.data());
+        for (size_t entry = 0; entry < distances.size(); ++entry) {
+            if (distances[entry] <= m_radius) {
+                matches.push_back(m_ids[entry]);
+            }
+        }
+        return matches;
+    }
+
+    // Gather entries sharing at least one substring with the query
+    std::vector<int> candidates;
+    for (int chunk = 0; chunk < m_chunkCount; ++chunk) {
+        auto bucket = m_buckets[chunk].find(chunkKey(query, chunk));
+        if (bucket != m_buckets[chunk].end()) {
+            candidates.insert(candidates.end(), bucket->second.begin(), bucket->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Verify the full distance
+    for (int entry : candidates) {
+        if (PHashCalculator::hammingDistance(m_hashes.at(entry), query) <= m_radius) {
+            matches.push_back(m_ids[entry]);
+        }
+    }
+
+    return matches;
+}
@@ -0,0 +1,138 @@
+#ifndef PHASHINDEX_H
+#define PHASHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "phashcalculator.h"
+
+/**
+ * @brief Contiguous structure-of-arrays table of 256-bit pHashes
+ *
+ * Word k of every hash is stored in its own array so one query can be compared
+ * against many hashes with wide loads (AVX-512 VPOPCNTQ, AVX2 nibble-table
+ * popcount or POPCNT, selected at runtime for the running CPU).
+ */
+class PHashTable
+{
+public:
+    /**
+     * @brief Append a valid hash
+     * @param hash Hash to append
+     */
+    void append(const PHash& hash);
+
+    /**
+     * @brief Reserve storage for a number of hashes
+     * @param count Expected number of hashes
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Get a stored hash
+     * @param index Hash index
+     * @return Hash at index
+     */
+    PHash at(size_t index) const;
+
+    /**
+     * @brief Compute the Hamming distance from one query to every stored hash
+     * @param query Valid query hash
+     * @param distances Output, one distance per stored hash (size() entries)
+     */
+    void hammingDistances(const PHash& query, int* distances) const;
+
+    /**
+     * @brief Get the number of stored hashes
+     * @return Hash count
+     */
+    size_t size() const { return m_words[0].size(); }
+
+    /**
+     * @brief Get the name of the batch kernel selected for this CPU
+     * @return Kernel name, e.g. "AVX2"
+     */
+    static const char* kernelName();
+
+private:
+    std::vector<uint64_t> m_words[4];
+};
+
+/**
+ * @brief Multi-index hash table over 256-bit pHashes for Hamming radius queries
+ *
+ * Each hash is split into at least radius + 1 disjoint substrings. Two hashes
+ * within the radius differ in at most radius bits, so by the pigeonhole
+ * principle at least one substring matches exactly; a query only has to look
+ * up its own substrings and verify the hashes sharing a bucket. This keeps
+ * near-duplicate search close to linear for the small thresholds used in
+ * post-processing, where a BK-tree barely prunes because distances between
+ * unrelated 256-bit hashes concentrate around 128.
+ *
+ * Small indexes (e.g. exclusion lists) and radii too large to split into useful
+ * substrings are answered with a batch scan of the whole table instead.
+ */
+class PHashIndex
+{
+public:
+    /**
+     * @brief Constructor
+     * @param radius Maximum Hamming distance (inclusive) answered by radiusSearch()
+     */
+    explicit PHashIndex(int radius);
+
+    /**
+     * @brief Add a hash to the index
+     * @param id Caller-defined identifier returned by queries
+     * @param hash Hash to add; invalid hashes are ignored
+     */
+    void insert(int id, const PHash& hash);
+
+    /**
+     * @brief Find every indexed hash within the index radius
+     * @param query Query hash
+     * @return Identifiers of the matching hashes, in no particular order
+     */
+    std::vector<int> radiusSearch(const PHash& query) const;
+
+    /**
+     * @brief Reserve storage for a number of hashes
+     * @param count Expected number of hashes
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Get the number of indexed hashes
+     * @return Hash count
+     */
+    size_t size() const { return m_hashes.size(); }
+
+    /**
+     * @brief Check whether the index is empty
+     * @return true if no hash has been inserted
+     */
+    bool empty() const { return m_hashes.size() == 0; }
+
+private:
+    /**
+     * @brief Extract one substring of a hash as a bucket key
+     * @param hash Hash to split
+     * @param chunk Substring index
+     * @return Substring bits
+     */
+    uint64_t chunkKey(const PHash& hash, int chunk) const;
+
+    int m_radius;
+    int m_chunkCount;   // 0 = always scan
+    PHashTable m_hashes;
+    std::vector<int> m_ids;
+    std::vector<std::unordered_map<uint64_t, std::vector<int>>> m_buckets;  // Per substring: key -> entry indices
+
+    static constexpr int HASH_BITS = 256;
+    static constexpr int MIN_CHUNKS = 4;            // Keeps every substring within 64 bits
+    static constexpr int MAX_CHUNKS = 32;           // Below 8 bits per substring buckets stop being selective
+    static constexpr size_t SCAN_THRESHOLD = 256;   // Below this size a batch scan beats bucket lookups
+};
+
+#endif // PHASHINDEX_H
@@ -316,11 +316,18 @@ void PlatformDetector::detectSIMDSupport() {
         if (detectSSSE3()) simdSupport.push_back(SIMDInstructionSet::SSSE3);
         if (detectSSE4_1()) simdSupport.push_back(SIMDInstructionSet::SSE4_1);
         if (detectSSE4_2()) simdSupport.push_back(SIMDInstructionSet::SSE4_2);
-        if (detectAVX()) simdSupport.push_back(SIMDInstructionSet::AVX);
-        if (detectAVX2()) simdSupport.push_back(SIMDInstructionSet::AVX2);
-        if (detectAVX512F()) simdSupport.push_back(SIMDInstructionSet::AVX512F);
-        if (detectAVX512BW()) simdSupport.push_back(SIMDInstructionSet::AVX512BW);
-        if (detectAVX512VL()) simdSupport.push_back(SIMDInstructionSet::AVX512VL);
+
+        // Runtime-dispatched kernels rely on this list, so AVX and AVX-512 are only
+        // reported when the OS also saves the wider register state
+        const bool osAVX = detectOSAVXSupport();
+        const bool osAVX512 = osAVX && detectOSAVX512Support();
+        if (osAVX && detectAVX()) simdSupport.push_back(SIMDInstructionSet::AVX);
+        if (osAVX && detectAVX2()) simdSupport.push_back(SIMDInstructionSet::AVX2);
+        if (osAVX512 && detectAVX512F()) simdSupport.push_back(SIMDInstructionSet::AVX512F);
+        if (osAVX512 && detectAVX512BW()) simdSupport.push_back(SIMDInstructionSet::AVX512BW);
+        if (osAVX512 && detectAVX512VL()) simdSupport.push_back(SIMDInstructionSet::AVX512VL);
+        if (osAVX512 && detectAVX512VNNI()) simdSupport.push_back(SIMDInstructionSet::AVX512VNNI);
+        if (osAVX512 && detectAVX512VPOPCNTDQ()) simdSupport.push_back(SIMDInstructionSet::AVX512VPOPCNTDQ);
     }
 
     if (simdSupport.empty()) {
@@ -515,6 +522,77 @@ bool PlatformDetector::detectAVX512VL() {
     return false;
 }
 
+bool PlatformDetector::detectAVX512VNNI() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #ifdef _WIN32
+        int cpuInfo[4];
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[2] & (1 << 11)) != 0;
+    #elif defined(__GNUC__)
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            return (ecx & (1 << 11)) != 0;
+        }
+    #endif
+#endif
+    return false;
+}
+
+bool PlatformDetector::detectAVX512VPOPCNTDQ() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #ifdef _WIN32
+        int cpuInfo[4];
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[2] & (1 << 14)) != 0;
+    #elif defined(__GNUC__)
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            return (ecx & (1 << 14)) != 0;
+        }
+    #endif
+#endif
+    return false;
+}
+
+namespace {
+
+/**
+ * Read XCR0 (the register state enabled by the OS), or 0 if XGETBV is unavailable
+ */
+unsigned long long readXCR0() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #ifdef _WIN32
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 1);
+        if ((cpuInfo[2] & (1 << 27)) == 0) {
+            return 0;   // OSXSAVE not set
+        }
+        return _xgetbv(0);
+    #elif defined(__GNUC__)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & (1 << 27)) == 0) {
+            return 0;   // OSXSAVE not set
+        }
+        unsigned int xcr0Low, xcr0High;
+        __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        return (static_cast<unsigned long long>(xcr0High) << 32) | xcr0Low;
+    #endif
+#endif
+    return 0;
+}
+
+} // namespace
+
+bool PlatformDetector::detectOSAVXSupport() {
+    // XMM and YMM state
+    return (readXCR0() & 0x6) == 0x6;
+}
+
+bool PlatformDetector::detectOSAVX512Support() {
+    // XMM, YMM, opmask and both halves of the ZMM state
+    return (readXCR0() & 0xE6) == 0xE6;
+}
+
 void PlatformDetector::detectGPUAcceleration() {
     // Platform-specific GPU detection
     switch (m_platformInfo.operatingSystem) {
@@ -996,6 +1074,8 @@ std::string PlatformDetector::toString(SIMDInstructionSet simd) {
         case SIMDInstructionSet::AVX512F: return "AVX512F";
         case SIMDInstructionSet::AVX512BW: return "AVX512BW";
         case SIMDInstructionSet::AVX512VL: return "AVX512VL";
+        case SIMDInstructionSet::AVX512VNNI: return "AVX512VNNI";
+        case SIMDInstructionSet::AVX512VPOPCNTDQ: return "AVX512VPOPCNTDQ";
         case SIMDInstructionSet::AltiVec: return "AltiVec";
         default: return "None";
     }
@@ -6,6 +6,16 @@
 #include <memory>
 #include <unordered_map>
 
+/**
+ * Compile a single function for an instruction set beyond the build baseline.
+ * Such functions must only be called after PlatformDetector reports the set as supported.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define SIMD_TARGET(features) __attribute__((target(features)))
+#else
+    #define SIMD_TARGET(features)
+#endif
+
 /**
  * Enumeration of supported CPU architectures
  */
@@ -50,6 +60,8 @@ enum class SIMDInstructionSet {
     AVX512F,
     AVX512BW,
     AVX512VL,
+    AVX512VNNI,
+    AVX512VPOPCNTDQ,
     // Other architectures
     AltiVec    // PowerPC
 };
@@ -346,6 +358,10 @@ private:
     bool detectAVX512F();
     bool detectAVX512BW();
     bool detectAVX512VL();
+    bool detectAVX512VNNI();
+    bool detectAVX512VPOPCNTDQ();
+    bool detectOSAVXSupport();
+    bool detectOSAVX512Support();
 
     // GPU detection helpers
     bool detectCUDA();
@@ -1,12 +1,18 @@
 #include "postprocessor.h"
 #include "trashmanager.h"
 #include "mlclassifier.h"
+#include "phashindex.h"
 #include <QDir>
 #include <QFileInfo>
 #include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 PostProcessor::PostProcessor(QObject *parent)
-    : QObject(parent), m_totalProcessed(0)
+    : QObject(parent), m_totalProcessed(0), m_hashThreads(0), m_hashCacheEnabled(true), m_fastPHash(false)
 {
 }
 
@@ -25,7 +31,8 @@ PostProcessingResult PostProcessor::processDirectory(const QString& imageDir,
                                                     bool mlDeleteMaybeSlides,
                                                     const QString& mlExecutionProvider,
                                                     bool useApplicationTrash,
-                                                    const QString& baseOutputDir)
+                                                    const QString& baseOutputDir,
+                                                    const QList<SlideFeatures>& precomputedFeatures)
 {
     m_movedToTrash.clear();
     m_totalProcessed = 0;
@@ -50,9 +57,29 @@ PostProcessingResult PostProcessor::processDirectory(const QString& imageDir,
 
     m_totalProcessed = imageFiles.size();
 
+    // Index features computed during extraction so those slides are not decoded again
+    QHash<QString, PHash> precomputedHashes;
+    QHash<QString, cv::Mat> modelInputs;
+    for (const SlideFeatures& features : precomputedFeatures) {
+        if (features.pHash.valid) {
+            precomputedHashes.insert(features.fileName, features.pHash);
+        }
+        if (!features.modelInput.empty()) {
+            modelInputs.insert(features.fileName, features.modelInput);
+        }
+    }
+
     // Calculate pHash for all images
     emit progressUpdated(0, imageFiles.size());
-    QMap<QString, std::vector<uint8_t>> imageHashes = calculateHashes(imageFiles);
+    PHashCache hashCache(imageDir, m_fastPHash ? PHashCache::ALGORITHM_FAST : PHashCache::ALGORITHM_REFERENCE);
+    if (m_hashCacheEnabled) {
+        hashCache.load();
+    }
+    QMap<QString, PHash> imageHashes = calculateHashes(imageFiles, precomputedHashes,
+                                                       m_hashCacheEnabled ? &hashCache : nullptr);
+    if (m_hashCacheEnabled) {
+        hashCache.save();
+    }
 
     // Remove duplicates if enabled
     if (deleteRedundant) {
@@ -89,7 +116,8 @@ PostProcessingResult PostProcessor::processDirectory(const QString& imageDir,
                                                   mlMaybeSlideLowThreshold,
                                                   mlSlideMaxThreshold,
                                                   mlDeleteMaybeSlides,
-                                                  mlExecutionProvider, useApplicationTrash, baseOutputDir);
+                                                  mlExecutionProvider, useApplicationTrash, baseOutputDir,
+                                                  modelInputs);
         m_movedToTrash.append(mlRemoved);
         result.removedByML = mlRemoved.size();
     }
@@ -100,54 +128,156 @@ PostProcessingResult PostProcessor::processDirectory(const QString& imageDir,
     return result;
 }
 
-QMap<QString, std::vector<uint8_t>> PostProcessor::calculateHashes(const QStringList& imageFiles)
+QMap<QString, PHash> PostProcessor::calculateHashes(const QStringList& imageFiles,
+                                                    const QHash<QString, PHash>& precomputedHashes,
+                                                    PHashCache* cache)
 {
-    QMap<QString, std::vector<uint8_t>> hashes;
-    int current = 0;
+    QMap<QString, PHash> hashes;
+    const int total = imageFiles.size();
+    std::vector<PHash> results(total);
+
+    // Hashes computed during extraction or cached by earlier runs need no decoding
+    std::vector<int> pending;
+    for (int i = 0; i < total; i++) {
+        QFileInfo fileInfo(imageFiles[i]);
+        auto precomputed = precomputedHashes.constFind(fileInfo.fileName());
+        if (precomputed != precomputedHashes.constEnd()) {
+            // Hashed from the frame before JPEG encoding, so it is not what hashing the file gives;
+            // only hashes read from the file on disk go into the cache
+            results[i] = precomputed.value();
+        } else if (!cache || !cache->lookup(fileInfo, results[i])) {
+            pending.push_back(i);
+        }
+    }
+
+    int completed = total - static_cast<int>(pending.size());
+    if (completed > 0) {
+        emit progressUpdated(completed, total);
+    }
+
+    // Runs on the worker threads below: an exception must not escape, and every file has to
+    // be counted as finished so the ordered progress loop keeps advancing
+    auto hashFile = [this](const QString& filePath) {
+        try {
+            return m_fastPHash ? PHashCalculator::calculatePHashFast(filePath)
+                               : PHashCalculator::calculatePHash(filePath);
+        } catch (const std::exception& e) {
+            qWarning() << "PostProcessor: Failed to hash" << filePath << ":" << e.what();
+        } catch (...) {
+            qWarning() << "PostProcessor: Failed to hash" << filePath;
+        }
+        return PHash();
+    };
+
+    int threadCount = m_hashThreads > 0 ? m_hashThreads
+                                         : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::clamp(threadCount, 1, std::max(1, static_cast<int>(pending.size())));
+
+    if (threadCount == 1) {
+        for (int index : pending) {
+            results[index] = hashFile(imageFiles[index]);
+            emit progressUpdated(++completed, total);
+        }
+    } else {
+        std::atomic<size_t> nextPending(0);
+        std::mutex progressMutex;
+        std::condition_variable progressChanged;
+        int finished = 0;
+
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount);
+        for (int t = 0; t < threadCount; t++) {
+            workers.emplace_back([&]() {
+                size_t slot;
+                while ((slot = nextPending.fetch_add(1)) < pending.size()) {
+                    const int index = pending[slot];
+                    results[index] = hashFile(imageFiles[index]);
+                    {
+                        std::lock_guard<std::mutex> lock(progressMutex);
+                        finished++;
+                    }
+                    progressChanged.notify_one();
+                }
+            });
+        }
+
+        // Report progress from this thread so receivers see signals in order
+        int reported = 0;
+        while (reported < static_cast<int>(pending.size())) {
+            {
+                std::unique_lock<std::mutex> lock(progressMutex);
+                progressChanged.wait(lock, [&]() { return finished > reported; });
+                reported = finished;
+            }
+            emit progressUpdated(completed + reported, total);
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
 
-    for (const QString& filePath : imageFiles) {
-        std::vector<uint8_t> hash = PHashCalculator::calculatePHash(filePath);
-        if (!hash.empty()) {
-            hashes[filePath] = hash;
+    if (cache) {
+        for (int index : pending) {
+            // Failed hashes are retried on the next run instead of being cached
+            if (results[index].valid) {
+                cache->insert(QFileInfo(imageFiles[index]), results[index]);
+            }
+        }
+    }
+
+    for (int i = 0; i < total; i++) {
+        if (results[i].valid) {
+            hashes[imageFiles[i]] = results[i];
         }
-        current++;
-        emit progressUpdated(current, imageFiles.size());
     }
 
     return hashes;
 }
 
-QStringList PostProcessor::removeDuplicates(const QMap<QString, std::vector<uint8_t>>& imageHashes,
+QStringList PostProcessor::removeDuplicates(const QMap<QString, PHash>& imageHashes,
                                            int hammingThreshold,
                                            bool useApplicationTrash,
                                            const QString& baseOutputDir)
 {
     QStringList movedFiles;
     QStringList processedFiles = imageHashes.keys();
+    std::vector<const PHash*> hashes;
+    hashes.reserve(processedFiles.size());
 
-    // Compare each image with subsequent images
+    // Index all hashes so each image only visits its near neighbours instead of every later image
+    PHashIndex index(hammingThreshold);
+    index.reserve(processedFiles.size());
     for (int i = 0; i < processedFiles.size(); i++) {
-        const QString& file1 = processedFiles[i];
+        hashes.push_back(&imageHashes.find(processedFiles[i]).value());
+        index.insert(i, *hashes.back());
+    }
 
+    std::vector<bool> moved(processedFiles.size(), false);
+
+    // Compare each image with subsequent images
+    for (int i = 0; i < processedFiles.size(); i++) {
         // Skip if already moved to trash
-        if (movedFiles.contains(file1)) {
+        if (moved[i]) {
             continue;
         }
 
-        const std::vector<uint8_t>& hash1 = imageHashes[file1];
+        const PHash& hash1 = *hashes[i];
 
-        for (int j = i + 1; j < processedFiles.size(); j++) {
-            const QString& file2 = processedFiles[j];
+        // Visit matches in file order so the earliest image of each group is kept
+        std::vector<int> neighbours = index.radiusSearch(hash1);
+        std::sort(neighbours.begin(), neighbours.end());
 
-            // Skip if already moved to trash
-            if (movedFiles.contains(file2)) {
+        for (int j : neighbours) {
+            // Only later images that have not been moved yet
+            if (j <= i || moved[j]) {
                 continue;
             }
 
-            const std::vector<uint8_t>& hash2 = imageHashes[file2];
+            const QString& file2 = processedFiles[j];
 
             // Calculate Hamming distance
-            int distance = PHashCalculator::hammingDistance(hash1, hash2);
+            int distance = PHashCalculator::hammingDistance(hash1, *hashes[j]);
 
             if (distance >= 0 && distance <= hammingThreshold) {
                 // Images are similar - move to trash
@@ -160,6 +290,7 @@ QStringList PostProcessor::removeDuplicates(const QMap<QString, std::vector<uint
                 }
 
                 if (success) {
+                    moved[j] = true;
                     movedFiles.append(file2);
                     emit imageMovedToTrash(file2, QString("Duplicate (distance: %1)").arg(distance));
                 }
@@ -170,7 +301,7 @@ QStringList PostProcessor::removeDuplicates(const QMap<QString, std::vector<uint
     return movedFiles;
 }
 
-QStringList PostProcessor::removeExcluded(const QMap<QString, std::vector<uint8_t>>& imageHashes,
+QStringList PostProcessor::removeExcluded(const QMap<QString, PHash>& imageHashes,
                                          const QList<ExclusionEntry>& exclusionList,
                                          int hammingThreshold,
                                          bool useApplicationTrash,
@@ -178,17 +309,25 @@ QStringList PostProcessor::removeExcluded(const QMap<QString, std::vector<uint8_
 {
     QStringList movedFiles;
 
+    // Index the exclusion list once instead of scanning it for every image
+    PHashIndex index(hammingThreshold);
+    index.reserve(exclusionList.size());
+    for (int i = 0; i < exclusionList.size(); i++) {
+        index.insert(i, exclusionList[i].hash);
+    }
+    if (index.empty()) {
+        return movedFiles;
+    }
+
     for (auto it = imageHashes.constBegin(); it != imageHashes.constEnd(); ++it) {
         const QString& filePath = it.key();
-        const std::vector<uint8_t>& imageHash = it.value();
-
-        // Compare with each entry in exclusion list
-        for (const ExclusionEntry& entry : exclusionList) {
-            if (entry.hashBytes.empty()) {
-                continue;
-            }
+        const PHash& imageHash = it.value();
 
-            int distance = PHashCalculator::hammingDistance(imageHash, entry.hashBytes);
+        // The first matching entry in list order names the reason, as with a linear scan
+        std::vector<int> matches = index.radiusSearch(imageHash);
+        if (!matches.empty()) {
+            const ExclusionEntry& entry = exclusionList[*std::min_element(matches.begin(), matches.end())];
+            int distance = PHashCalculator::hammingDistance(imageHash, entry.hash);
 
             if (distance >= 0 && distance <= hammingThreshold) {
                 // Image matches exclusion list - move to trash
@@ -205,7 +344,6 @@ QStringList PostProcessor::removeExcluded(const QMap<QString, std::vector<uint8_
                     movedFiles.append(filePath);
                     emit imageMovedToTrash(filePath, reason);
                 }
-                break;  // No need to check other exclusion entries
             }
         }
     }
@@ -213,7 +351,7 @@ QStringList PostProcessor::removeExcluded(const QMap<QString, std::vector<uint8_
     return movedFiles;
 }
 
-QStringList PostProcessor::classifyAndRemove(const QMap<QString, std::vector<uint8_t>>& imageHashes,
+QStringList PostProcessor::classifyAndRemove(const QMap<QString, PHash>& imageHashes,
                                             const QString& mlModelPath,
                                             float mlNotSlideHighThreshold,
                                             float mlNotSlideLowThreshold,
@@ -223,7 +361,8 @@ QStringList PostProcessor::classifyAndRemove(const QMap<QString, std::vector<uin
                                             bool mlDeleteMaybeSlides,
                                             const QString& mlExecutionProvider,
                                             bool useApplicationTrash,
-                                            const QString& baseOutputDir)
+                                            const QString& baseOutputDir,
+                                            const QHash<QString, cv::Mat>& modelInputs)
 {
     QStringList movedFiles;
 
@@ -240,17 +379,17 @@ QStringList PostProcessor::classifyAndRemove(const QMap<QString, std::vector<uin
     // Convert execution provider string to enum
     MLClassifier::ExecutionProvider provider = MLClassifier::stringToExecutionProvider(mlExecutionProvider);
 
-    // Initialize ML classifier
-    MLClassifier classifier(mlModelPath, provider);
+    // Reuse the warmed-up classifier from earlier runs when the configuration is unchanged
+    std::shared_ptr<MLClassifier> classifier = MLClassifier::shared(mlModelPath, provider, m_mlOptions);
 
-    if (!classifier.isInitialized()) {
-        QString errorMsg = classifier.getErrorMessage();
+    if (!classifier->isInitialized()) {
+        QString errorMsg = classifier->getErrorMessage();
         qWarning() << "PostProcessor: Failed to initialize ML classifier:" << errorMsg;
         emit mlClassificationFailed(errorMsg);
         return movedFiles;
     }
 
-    QString activeProvider = classifier.getActiveExecutionProvider();
+    QString activeProvider = classifier->getActiveExecutionProvider();
     qInfo() << "PostProcessor: ML classification using" << activeProvider;
 
     // Emit signal with execution provider info
@@ -263,8 +402,27 @@ QStringList PostProcessor::classifyAndRemove(const QMap<QString, std::vector<uin
         return movedFiles;
     }
 
-    // Classify all images
-    QVector<ClassificationResult> results = classifier.classifyBatch(imagePaths);
+    // Classify all images; slides prepared during extraction skip the JPEG decode
+    QStringList preparedPaths;
+    QVector<cv::Mat> preparedInputs;
+    QStringList pathsToDecode;
+    for (const QString& imagePath : imagePaths) {
+        auto modelInput = modelInputs.constFind(QFileInfo(imagePath).fileName());
+        if (modelInput != modelInputs.constEnd()) {
+            preparedPaths.append(imagePath);
+            preparedInputs.append(modelInput.value());
+        } else {
+            pathsToDecode.append(imagePath);
+        }
+    }
+
+    QVector<ClassificationResult> results;
+    if (!preparedPaths.isEmpty()) {
+        results.append(classifier->classifyPreparedBatch(preparedPaths, preparedInputs));
+    }
+    if (!pathsToDecode.isEmpty()) {
+        results.append(classifier->classifyBatch(pathsToDecode));
+    }
 
     // Process results and remove unwanted images
     for (const ClassificationResult& result : results) {
@@ -323,12 +481,12 @@ QList<ExclusionEntry> PostProcessor::getDefaultExclusionList()
     ExclusionEntry entry1("No_Signal_1", "99c799ce6638663399c799ce6638663199c799ce6638663199c799ce66386630");
     ExclusionEntry entry2("No_Signal_2", "2ddb2658d224d1a72ddb2e58d264d1a7299b2f58d664d4a7299b091ad664f6e4");
 
-    // Only add entries with valid hash bytes
-    if (!entry1.hashBytes.empty()) {
+    // Only add entries with valid hashes
+    if (entry1.hash.valid) {
         list.append(entry1);
     }
 
-    if (!entry2.hashBytes.empty()) {
+    if (entry2.hash.valid) {
         list.append(entry2);
     }
 
@@ -5,8 +5,12 @@
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QHash>
 #include <vector>
 #include "phashcalculator.h"
+#include "phashcache.h"
+#include "slidefeatures.h"
+#include "mlclassifier.h"
 
 /**
  * @brief Structure to hold exclusion list entry
@@ -14,11 +18,11 @@
 struct ExclusionEntry {
     QString remark;
     QString hashHex;
-    std::vector<uint8_t> hashBytes;
+    PHash hash;
 
     ExclusionEntry() = default;
     ExclusionEntry(const QString& rem, const QString& hex)
-        : remark(rem), hashHex(hex), hashBytes(PHashCalculator::hexStringToHash(hex)) {}
+        : remark(rem), hashHex(hex), hash(PHashCalculator::hexStringToHash(hex)) {}
 };
 
 /**
@@ -65,6 +69,8 @@ public:
      * @param mlExecutionProvider Preferred execution provider
      * @param useApplicationTrash Use application trash instead of system trash
      * @param baseOutputDir Base output directory (for application trash)
+     * @param precomputedFeatures pHashes / ML inputs computed during extraction, matched by file name;
+     *                            images without an entry are decoded from disk as usual
      * @return PostProcessingResult with breakdown of removals
      */
     PostProcessingResult processDirectory(const QString& imageDir,
@@ -82,7 +88,32 @@ public:
                                          bool mlDeleteMaybeSlides = true,
                                          const QString& mlExecutionProvider = "Auto",
                                          bool useApplicationTrash = true,
-                                         const QString& baseOutputDir = QString());
+                                         const QString& baseOutputDir = QString(),
+                                         const QList<SlideFeatures>& precomputedFeatures = QList<SlideFeatures>());
+
+    /**
+     * @brief Set batching and preprocessing options for ML classification
+     * @param options Options applied to the classifier
+     */
+    void setMLOptions(const MLClassifierOptions& options) { m_mlOptions = options; }
+
+    /**
+     * @brief Set the number of threads computing pHashes
+     * @param threads Thread count, 0 = one per core
+     */
+    void setHashThreads(int threads) { m_hashThreads = threads; }
+
+    /**
+     * @brief Enable the per-folder on-disk pHash cache
+     * @param enabled Reuse hashes of unchanged images from earlier runs
+     */
+    void setHashCacheEnabled(bool enabled) { m_hashCacheEnabled = enabled; }
+
+    /**
+     * @brief Select the pHash decode path
+     * @param fast Use PHashCalculator::calculatePHashFast() (reduced-resolution decode)
+     */
+    void setFastPHash(bool fast) { m_fastPHash = fast; }
 
     /**
      * @brief Get list of images that were moved to trash
@@ -139,10 +170,18 @@ signals:
 private:
     /**
      * @brief Calculate pHash for all images in directory
+     *
+     * Images are decoded and hashed on a pool of worker threads; each worker holds
+     * at most one decoded image, so the thread count also bounds decode memory.
+     * Progress is reported from the calling thread with a monotonically increasing count.
      * @param imageFiles List of image file paths
+     * @param precomputedHashes Hashes already known, keyed by file name (skip decoding these)
+     * @param cache On-disk hash cache consulted first and updated with hashes read from files (may be null)
      * @return Map of file path to pHash
      */
-    QMap<QString, std::vector<uint8_t>> calculateHashes(const QStringList& imageFiles);
+    QMap<QString, PHash> calculateHashes(const QStringList& imageFiles,
+                                         const QHash<QString, PHash>& precomputedHashes,
+                                         PHashCache* cache);
 
     /**
      * @brief Find and remove duplicate images
@@ -152,7 +191,7 @@ private:
      * @param baseOutputDir Base output directory (for application trash)
      * @return List of files moved to trash
      */
-    QStringList removeDuplicates(const QMap<QString, std::vector<uint8_t>>& imageHashes,
+    QStringList removeDuplicates(const QMap<QString, PHash>& imageHashes,
                                  int hammingThreshold,
                                  bool useApplicationTrash,
                                  const QString& baseOutputDir);
@@ -166,7 +205,7 @@ private:
      * @param baseOutputDir Base output directory (for application trash)
      * @return List of files moved to trash
      */
-    QStringList removeExcluded(const QMap<QString, std::vector<uint8_t>>& imageHashes,
+    QStringList removeExcluded(const QMap<QString, PHash>& imageHashes,
                                const QList<ExclusionEntry>& exclusionList,
                                int hammingThreshold,
                                bool useApplicationTrash,
@@ -185,9 +224,10 @@ private:
      * @param mlExecutionProvider Preferred execution provider
      * @param useApplicationTrash Use application trash instead of system trash
      * @param baseOutputDir Base output directory (for application trash)
+     * @param modelInputs Prepared ML inputs keyed by file name (skip decoding these)
      * @return List of files moved to trash
      */
-    QStringList classifyAndRemove(const QMap<QString, std::vector<uint8_t>>& imageHashes,
+    QStringList classifyAndRemove(const QMap<QString, PHash>& imageHashes,
                                   const QString& mlModelPath,
                                   float mlNotSlideHighThreshold,
                                   float mlNotSlideLowThreshold,
@@ -197,10 +237,15 @@ private:
                                   bool mlDeleteMaybeSlides,
                                   const QString& mlExecutionProvider,
                                   bool useApplicationTrash,
-                                  const QString& baseOutputDir);
+                                  const QString& baseOutputDir,
+                                  const QHash<QString, cv::Mat>& modelInputs);
 
     QStringList m_movedToTrash;
     int m_totalProcessed;
+    MLClassifierOptions m_mlOptions;
+    int m_hashThreads;
+    bool m_hashCacheEnabled;
+    bool m_fastPHash;
 };
 
 #endif // POSTPROCESSOR_H
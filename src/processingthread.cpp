@@ -1,5 +1,7 @@
 #include "processingthread.h"
 #include "imageiohelper.h"
+#include "mlclassifier.h"
+#include "videoanalysiscache.h"
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -8,6 +10,27 @@
 #include <QElapsedTimer>
 #include <thread>
 #include <functional>
+#include <algorithm>
+
+namespace {
+
+/**
+ * Releases a chunk's reservation in the shared memory budget when it goes out of scope
+ */
+class BudgetRelease {
+public:
+    BudgetRelease(MemoryBudget& budget, size_t bytes) : m_budget(budget), m_bytes(bytes) {}
+    ~BudgetRelease() { m_budget.release(m_bytes); }
+
+    BudgetRelease(const BudgetRelease&) = delete;
+    BudgetRelease& operator=(const BudgetRelease&) = delete;
+
+private:
+    MemoryBudget& m_budget;
+    size_t m_bytes;
+};
+
+} // namespace
 
 ProcessingThread::ProcessingThread(VideoQueue* videoQueue, QObject *parent)
     : QThread(parent),
@@ -15,12 +38,9 @@ ProcessingThread::ProcessingThread(VideoQueue* videoQueue, QObject *parent)
       m_shouldStop(false),
       m_shouldPause(false),
       m_isProcessing(false),
-      m_currentVideoIndex(-1),
-      m_producerFinished(false),
-      m_currentDecoder(nullptr)
+      m_currentVideoIndex(-1)
 {
     m_videoProcessor = std::make_unique<VideoProcessor>(this);
-    m_slideDetector = std::make_unique<SlideDetector>(this);
 
     // Connect signals
     connect(m_videoProcessor.get(), &VideoProcessor::frameExtracted,
@@ -29,13 +49,6 @@ ProcessingThread::ProcessingThread(VideoQueue* videoQueue, QObject *parent)
             this, &ProcessingThread::onExtractionProgress);
     connect(m_videoProcessor.get(), &VideoProcessor::extractionError,
             this, &ProcessingThread::onExtractionError);
-
-    connect(m_slideDetector.get(), &SlideDetector::ssimCalculationProgress,
-            this, &ProcessingThread::onSSIMCalculationProgress);
-    connect(m_slideDetector.get(), &SlideDetector::slideDetectionProgress,
-            this, &ProcessingThread::onSlideDetectionProgress);
-    connect(m_slideDetector.get(), &SlideDetector::detectionError,
-            this, &ProcessingThread::onDetectionError);
 }
 
 ProcessingThread::~ProcessingThread()
@@ -79,23 +92,22 @@ void ProcessingThread::forceStop()
         m_shouldPause = false;
     }
 
-    // Cancel the current decoder if it exists
+    // Cancel every active decoder and mark its video as error
     {
-        QMutexLocker locker(&m_decoderMutex);
-        if (m_currentDecoder) {
-            m_currentDecoder->requestCancellation();
-        }
-    }
+        QMutexLocker locker(&m_pipelinesMutex);
+        for (VideoPipeline* pipeline : m_activePipelines) {
+            if (pipeline->decoder) {
+                pipeline->decoder->requestCancellation();
+            }
+            m_videoQueue->updateStatus(pipeline->videoIndex, ProcessingStatus::Error);
 
-    // Mark current video as error if processing
-    if (m_currentVideoIndex >= 0) {
-        m_videoQueue->updateStatus(m_currentVideoIndex, ProcessingStatus::Error);
+            pipeline->chunkQueue.wakeAll();
+        }
     }
 
     // Wake up all waiting threads
     m_condition.wakeAll();
-    m_queueNotFull.wakeAll();
-    m_queueNotEmpty.wakeAll();
+    m_memoryBudget.wakeAll();
 }
 
 bool ProcessingThread::isProcessing() const
@@ -110,6 +122,12 @@ void ProcessingThread::updateConfig(const AppConfig& config)
     m_config = config;
 }
 
+QList<SlideFeatures> ProcessingThread::takeSlideFeatures(int videoIndex)
+{
+    QMutexLocker locker(&m_slideFeaturesMutex);
+    return m_slideFeatures.take(videoIndex);
+}
+
 void ProcessingThread::run()
 {
     {
@@ -120,6 +138,8 @@ void ProcessingThread::run()
     emit processingStarted();
 
     while (true) {
+        int concurrentVideos = 1;
+        int writerThreads = 1;
         {
             QMutexLocker locker(&m_mutex);
             if (m_shouldStop) {
@@ -134,29 +154,33 @@ void ProcessingThread::run()
                 m_shouldPause = false;
                 continue;
             }
+
+            concurrentVideos = std::max(1, m_config.maxConcurrentVideos);
+            writerThreads = std::max(1, m_config.slideWriterThreads);
+            m_memoryBudget.setLimit(static_cast<size_t>(std::max(0, m_config.memoryBudgetMB)) * 1024 * 1024);
         }
 
-        // Get next video to process
-        int videoIndex = m_videoQueue->getNextToProcess();
-        if (videoIndex == -1) {
-            // No more videos to process
+        // No more videos to process
+        if (m_videoQueue->getNextToProcess() == -1) {
             break;
         }
 
-        // Process the video
-        bool success = processVideo(videoIndex);
-
-        if (!success) {
-            QMutexLocker locker(&m_mutex);
-            if (m_shouldStop || m_shouldPause) {
-                break;
-            }
+        // Run the worker pool until the queue is drained or processing is interrupted
+        m_slideWriter = std::make_unique<SlideWriter>(writerThreads);
+        std::vector<std::thread> workers;
+        workers.reserve(concurrentVideos);
+        for (int i = 0; i < concurrentVideos; ++i) {
+            workers.emplace_back(&ProcessingThread::videoWorker, this);
         }
-
-        // Pause between videos
-        QThread::msleep(INTER_VIDEO_PAUSE_MS);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        m_slideWriter.reset();
     }
 
+    // Decoded frame buffers are only recycled while videos are being decoded
+    FrameBufferPool::instance().trim();
+
     {
         QMutexLocker locker(&m_mutex);
         m_isProcessing = false;
@@ -165,22 +189,56 @@ void ProcessingThread::run()
     emit processingStopped();
 }
 
+void ProcessingThread::videoWorker()
+{
+    while (!shouldInterrupt()) {
+        int videoIndex = claimNextVideo();
+        if (videoIndex == -1) {
+            // No more videos to process
+            return;
+        }
+
+        // Process the video
+        bool success = processVideo(videoIndex);
+
+        if (!success && shouldInterrupt()) {
+            return;
+        }
+    }
+}
+
+int ProcessingThread::claimNextVideo()
+{
+    // The queue leaves the Queued state under its own lock so other workers skip this video
+    return m_videoQueue->claimNextToProcess();
+}
+
+bool ProcessingThread::shouldInterrupt() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_shouldStop || m_shouldPause;
+}
+
 bool ProcessingThread::processVideo(int videoIndex)
 {
-    VideoQueueItem* video = m_videoQueue->getVideo(videoIndex);
-    if (!video) {
+    QString videoPath = m_videoQueue->getFilePath(videoIndex);
+    if (videoPath.isEmpty()) {
         return false;
     }
 
     // Always use chunk-based processing for memory optimization
-    return processVideoWithChunks(video, videoIndex);
+    return processVideoWithChunks(videoPath, videoIndex);
 }
 
 
-bool ProcessingThread::processVideoWithChunks(VideoQueueItem* video, int videoIndex)
+bool ProcessingThread::processVideoWithChunks(const QString& videoPath, int videoIndex)
 {
-    m_currentVideoIndex = videoIndex;
-    m_currentError.clear();
+    AppConfig config;
+    {
+        QMutexLocker locker(&m_mutex);
+        config = m_config;
+        m_currentVideoIndex = videoIndex;
+    }
 
     emit videoProcessingStarted(videoIndex);
 
@@ -191,16 +249,26 @@ bool ProcessingThread::processVideoWithChunks(VideoQueueItem* video, int videoIn
         // Step 1: Analyze video and display info immediately
         m_videoQueue->updateStatus(videoIndex, ProcessingStatus::FFmpegHandling);
 
+        // Reuse the stream info and keyframe index of a video analyzed in an earlier run
+        VideoAnalysisCache analysisCache(videoPath);
+        HardwareDecoder::VideoAnalysis cachedAnalysis;
+        bool analysisCached = config.enableVideoAnalysisCache && analysisCache.load(cachedAnalysis);
+
         // Create a temporary decoder just to get video information quickly
         HardwareDecoder tempDecoder;
         // Use toUtf8() for proper cross-platform path encoding
-        std::string videoPathStr = video->filePath.toUtf8().toStdString();
-        if (!tempDecoder.openVideo(videoPathStr)) {
+        std::string videoPathStr = videoPath.toUtf8().toStdString();
+        if (!tempDecoder.openVideo(videoPathStr, analysisCached ? &cachedAnalysis : nullptr)) {
             throw std::runtime_error("Failed to open video for analysis");
         }
 
+        HardwareDecoder::VideoAnalysis analysis = tempDecoder.getAnalysis();
+        if (config.enableVideoAnalysisCache && !analysisCached) {
+            analysisCache.save(analysis);
+        }
+
         // Get video information and hardware acceleration method
-        HardwareDecoder::VideoInfo videoInfo = tempDecoder.getVideoInfo();
+        HardwareDecoder::VideoInfo videoInfo = analysis.info;
         QString hwMethod = QString::fromStdString(tempDecoder.getHardwareAccelerationMethod());
 
         // Log video information immediately
@@ -217,54 +285,114 @@ bool ProcessingThread::processVideoWithChunks(VideoQueueItem* video, int videoIn
         // Close temporary decoder
         tempDecoder.close();
 
-        // Step 2: Initialize processing state for chunk-based processing
-        m_processingState.reset();
-        m_producerFinished = false;
-        m_currentExtractionProgress = 0.0;
+        // Step 2: Initialize a dedicated pipeline for chunk-based processing
+        VideoPipeline pipeline(videoIndex, config);
+        pipeline.analysis = std::move(analysis);
+        pipeline.slideDetector = std::make_unique<SlideDetector>();
+        pipeline.slideDetector->setTiledSSIM(config.ssimMode == SSIMMode::Tiled);
+
+        // Forward detector progress tagged with this pipeline's video index
+        connect(pipeline.slideDetector.get(), &SlideDetector::ssimCalculationProgress, this,
+                [this, videoIndex](int current, int total) {
+                    emit ssimCalculationProgress(videoIndex, current, total);
+                }, Qt::DirectConnection);
+        connect(pipeline.slideDetector.get(), &SlideDetector::slideDetectionProgress, this,
+                [this, videoIndex](int current, int total) {
+                    emit slideDetectionProgress(videoIndex, current, total);
+                }, Qt::DirectConnection);
+        connect(pipeline.slideDetector.get(), &SlideDetector::detectionError, this,
+                [this, &pipeline](const QString& error) {
+                    QMutexLocker locker(&m_mutex);
+                    pipeline.error = error;
+                }, Qt::DirectConnection);
 
         // Estimate total frames that will be extracted (duration / 2 second interval)
         // This is an estimate used for progress calculation
-        int estimatedTotalFrames = static_cast<int>(videoInfo.duration / 2.0);
-        m_totalFramesExtracted = estimatedTotalFrames;
-
-        m_sharedQueue.reset();
+        pipeline.totalFramesExtracted = static_cast<int>(videoInfo.duration / 2.0);
 
         // Prepare output directory
-        QString outputDir = createOutputDirectory(video->filePath, m_config.outputDirectory);
-        video->outputDirectory = outputDir;  // Store for post-processing
-        QFileInfo videoFileInfo(video->filePath);
+        QString outputDir = createOutputDirectory(videoPath, config.outputDirectory);
+        m_videoQueue->setOutputDirectory(videoIndex, outputDir);  // Store for post-processing
+        QFileInfo videoFileInfo(videoPath);
         QString videoName = videoFileInfo.baseName();
 
+        // Register pipeline for cancellation support
+        {
+            QMutexLocker locker(&m_pipelinesMutex);
+            m_activePipelines.push_back(&pipeline);
+        }
+
         // Step 3: Start producer-consumer threads
         // videoPathStr already declared above, reuse it
         std::thread producer(&ProcessingThread::producerThread, this,
+                           std::ref(pipeline),
                            videoPathStr,
-                           m_config.chunkSize);
+                           config.chunkSize);
 
-        std::thread consumer(&ProcessingThread::consumerThread, this,
-                           videoIndex, outputDir, videoName);
+        std::thread consumer([this, &pipeline, outputDir, videoName]() {
+            consumerThread(pipeline, outputDir, videoName);
+            // A consumer that bailed out early must not leave the producer blocked on a full queue
+            pipeline.consumerExited = true;
+        });
 
         // Wait for both threads to complete
         producer.join();
         consumer.join();
 
+        // Unregister pipeline and return any budget still held by an unconsumed chunk
+        {
+            QMutexLocker locker(&m_pipelinesMutex);
+            m_activePipelines.erase(std::remove(m_activePipelines.begin(), m_activePipelines.end(), &pipeline),
+                                    m_activePipelines.end());
+        }
+        for (auto& leftover : pipeline.chunkQueue.drain()) {
+            m_memoryBudget.release(leftover->getMemoryUsage());
+        }
+
+        // Wait for queued slide writes so the output directory is complete before post-processing
+        SlideWriteResult writeResult = m_slideWriter->waitForVideo(videoIndex);
+        for (const QString& failedPath : writeResult.failedPaths) {
+            emit videoInfoLogged(videoIndex, QString("Failed to save slide: %1").arg(failedPath));
+        }
+        // Slides that never reached the writer because no frame could be produced count as failures too
+        m_videoQueue->setSlideWriteFailures(videoIndex, writeResult.failed + pipeline.slideDecodeFailures);
+        if (pipeline.slideDecodeFallbacks > 0 || pipeline.slideDecodeFailures > 0) {
+            emit videoInfoLogged(videoIndex, QString("Slide Re-Decode - Saved at detection resolution: %1, Lost: %2")
+                                 .arg(pipeline.slideDecodeFallbacks)
+                                 .arg(pipeline.slideDecodeFailures));
+        }
+
+        // Report how well the handoff kept both stages busy
+        emit videoInfoLogged(videoIndex, QString("Chunk Queue - Depth: %1 (%2), Peak Occupancy: %3, Decoder Stall: %4s, Detector Stall: %5s")
+                             .arg(pipeline.chunkQueue.capacity())
+                             .arg(pipeline.chunkQueue.isLockFree() ? "lock-free" : "blocking")
+                             .arg(pipeline.chunkQueue.peakOccupancy())
+                             .arg(pipeline.chunkQueue.producerStallMs() / 1000.0, 0, 'f', 2)
+                             .arg(pipeline.chunkQueue.consumerStallMs() / 1000.0, 0, 'f', 2));
+
         // Check for errors during processing
         {
             QMutexLocker locker(&m_mutex);
             if (m_shouldStop || m_shouldPause) {
                 return false;
             }
-            if (!m_currentError.isEmpty()) {
-                throw std::runtime_error(m_currentError.toStdString());
+            if (!pipeline.error.isEmpty()) {
+                throw std::runtime_error(pipeline.error.toStdString());
             }
         }
 
         // Step 4: Final statistics and completion
-        int slidesSaved = static_cast<int>(m_processingState.savedSlideIndices.size());
+        int slidesSaved = writeResult.written;
         double totalTime = totalTimer.elapsed() / 1000.0;
         m_videoQueue->updateStatistics(videoIndex, slidesSaved, totalTime);
         m_videoQueue->updateStatus(videoIndex, ProcessingStatus::Completed);
 
+        // Stash features before announcing completion so post-processing can pick them up
+        if (!writeResult.features.isEmpty()) {
+            QMutexLocker locker(&m_slideFeaturesMutex);
+            m_slideFeatures.insert(videoIndex, std::move(writeResult.features));
+        }
+
         emit videoProcessingCompleted(videoIndex, slidesSaved);
         return true;
 
@@ -367,232 +495,351 @@ QString ProcessingThread::getTempDirectory()
     return tempDir;
 }
 
-void ProcessingThread::producerThread(const std::string& videoPath, int chunkSize)
+void ProcessingThread::producerThread(VideoPipeline& pipeline, const std::string& videoPath, int chunkSize)
 {
+    const int videoIndex = pipeline.videoIndex;
+
     try {
         // Create hardware decoder for chunk-based extraction
         HardwareDecoder decoder;
 
         // Register decoder for cancellation support
         {
-            QMutexLocker locker(&m_decoderMutex);
-            m_currentDecoder = &decoder;
+            QMutexLocker locker(&m_pipelinesMutex);
+            pipeline.decoder = &decoder;
         }
 
-        if (!decoder.openVideo(videoPath)) {
-            QMutexLocker locker(&m_mutex);
-            m_currentError = "Failed to open video for chunk extraction";
+        if (!decoder.openVideo(videoPath, &pipeline.analysis)) {
+            {
+                QMutexLocker locker(&m_mutex);
+                pipeline.error = "Failed to open video for chunk extraction";
+            }
 
-            // Unregister decoder
-            QMutexLocker decoderLocker(&m_decoderMutex);
-            m_currentDecoder = nullptr;
+            // Unregister decoder and let the consumer exit
+            {
+                QMutexLocker locker(&m_pipelinesMutex);
+                pipeline.decoder = nullptr;
+            }
+            pipeline.chunkQueue.close();
             return;
         }
 
-        // Define chunk callback that puts chunks into the shared queue
-        auto chunkCallback = [this](const std::vector<cv::Mat>& frames, int startOffset, bool isLastChunk) {
+        // Put chunks into the shared queue
+        auto pushChunk = [this, &pipeline](std::unique_ptr<FrameChunk> chunk) {
+            // Reserve room in the global memory budget shared by all concurrent videos
+            size_t chunkBytes = chunk->getMemoryUsage();
+            if (!m_memoryBudget.acquire(chunkBytes, [this]() { return shouldInterrupt(); })) {
+                return;
+            }
+
+            // Wait for a free slot; on abort the chunk stays here and its budget is returned
+            auto abortPush = [this, &pipeline]() { return shouldInterrupt() || pipeline.consumerExited.load(); };
+            if (!pipeline.chunkQueue.push(chunk, abortPush)) {
+                m_memoryBudget.release(chunkBytes);
+            }
+        };
+
+        // Define chunk callback for full-resolution BGR frames
+        auto chunkCallback = [this, &pushChunk](const std::vector<cv::Mat>& frames, int startOffset, bool isLastChunk) {
             // Check for stop/pause conditions
-            {
-                QMutexLocker locker(&m_mutex);
-                if (m_shouldStop || m_shouldPause) {
-                    return;
-                }
+            if (shouldInterrupt()) {
+                return;
             }
 
-            // Create frame chunk
-            auto chunk = std::make_unique<FrameChunk>(frames, startOffset, isLastChunk);
+            pushChunk(std::make_unique<FrameChunk>(frames, startOffset, isLastChunk));
+        };
 
-            // Wait for queue to be empty (capacity = 1)
-            {
-                QMutexLocker locker(&m_queueMutex);
-                while (m_sharedQueue != nullptr) {
-                    // Check for stop/pause while waiting
-                    if (m_shouldStop || m_shouldPause) {
-                        return;
-                    }
-                    m_queueNotFull.wait(&m_queueMutex);
-                }
+        // Define chunk callback for detection-size luma frames; full-resolution BGR is only
+        // produced for frames selected as slides, from the retained frame or by decoding again
+        auto detectionChunkCallback = [this, &pipeline, &videoPath, &pushChunk](std::vector<cv::Mat>&& frames,
+                                                         std::vector<HardwareDecoder::FrameSource>&& sources,
+                                                         int startOffset, bool isLastChunk) {
+            // Check for stop/pause conditions
+            if (shouldInterrupt()) {
+                return;
+            }
 
-                // Put chunk into queue
-                m_sharedQueue = std::move(chunk);
-                m_queueNotEmpty.wakeOne();
+            auto chunk = std::make_unique<FrameChunk>(frames, startOffset, isLastChunk);
+            chunk->fullFrameLoaders.reserve(sources.size());
+            for (HardwareDecoder::FrameSource& source : sources) {
+                chunk->loaderMemoryUsage += HardwareDecoder::getSourceMemoryUsage(source);
+                chunk->fullFrameLoaders.emplace_back([this, &pipeline, videoPath, source = std::move(source)]() {
+                    return decodeSlideFrame(pipeline, videoPath, source);
+                });
             }
+
+            pushChunk(std::move(chunk));
         };
 
         // Define progress callback for frame extraction progress
         // Note: HardwareDecoder calls with (currentTime, totalTime, percentage)
-        auto progressCallback = [this](double currentTime, double totalTime, double percentage) {
+        auto progressCallback = [this, &pipeline, videoIndex](double currentTime, double totalTime, double percentage) {
             Q_UNUSED(currentTime)
             Q_UNUSED(totalTime)
 
             // Store current extraction progress for slide detection progress calculation
             {
-                QMutexLocker locker(&m_queueMutex);
-                m_currentExtractionProgress = percentage;
+                QMutexLocker locker(&pipeline.queueMutex);
+                pipeline.currentExtractionProgress = percentage;
             }
 
-            emit frameExtractionProgress(m_currentVideoIndex, percentage);
+            emit frameExtractionProgress(videoIndex, percentage);
         };
 
         // Extract frames in chunks using the hardware decoder
-        int totalFrames = decoder.extractFramesInChunks(
-            chunkCallback,
-            progressCallback,
-            chunkSize,
-            2.0  // Use 2 seconds as the ideal target interval
-        );
+        int totalFrames = 0;
+        if (pipeline.config.lumaDetection) {
+            // Detection frames come straight from the decoder's luma plane at detection size
+            totalFrames = decoder.extractDetectionFramesInChunks(
+                detectionChunkCallback,
+                progressCallback,
+                chunkSize,
+                pipeline.config.enableDownsampling ? pipeline.config.downsampleWidth : 0,
+                pipeline.config.enableDownsampling ? pipeline.config.downsampleHeight : 0,
+                pipeline.config.decoderThreads,
+                !pipeline.config.redecodeSlideFrames
+            );
+        } else if (pipeline.config.decoderThreads > 1) {
+            // Split the timeline at keyframes across several decoders; chunks still arrive in order
+            totalFrames = decoder.extractFramesInChunksParallel(
+                chunkCallback,
+                progressCallback,
+                chunkSize,
+                pipeline.config.decoderThreads
+            );
+        } else {
+            totalFrames = decoder.extractFramesInChunks(
+                chunkCallback,
+                progressCallback,
+                chunkSize,
+                2.0  // Use 2 seconds as the ideal target interval
+            );
+        }
 
         if (totalFrames <= 0) {
-            QMutexLocker locker(&m_mutex);
-            m_currentError = "No frames extracted from video";
+            {
+                QMutexLocker locker(&m_mutex);
+                pipeline.error = "No frames extracted from video";
+            }
 
-            // Unregister decoder
-            QMutexLocker decoderLocker(&m_decoderMutex);
-            m_currentDecoder = nullptr;
+            // Unregister decoder and let the consumer exit
+            {
+                QMutexLocker locker(&m_pipelinesMutex);
+                pipeline.decoder = nullptr;
+            }
+            pipeline.chunkQueue.close();
             return;
         }
 
         // Update total frames with actual count (replaces the estimate)
         {
-            QMutexLocker locker(&m_queueMutex);
-            m_totalFramesExtracted = totalFrames;
-            m_currentExtractionProgress = 100.0;
+            QMutexLocker locker(&pipeline.queueMutex);
+            pipeline.totalFramesExtracted = totalFrames;
+            pipeline.currentExtractionProgress = 100.0;
         }
 
         // Emit final 100% progress for frame extraction
-        emit frameExtractionProgress(m_currentVideoIndex, 100.0);
+        emit frameExtractionProgress(videoIndex, 100.0);
+
+        // Containers without an index get their keyframe index from this first full pass;
+        // the cache refuses it unless the scan reached the end of the stream
+        if (pipeline.config.enableVideoAnalysisCache && pipeline.analysis.keyframeIndex.empty() &&
+            !decoder.getKeyframeIndex().empty()) {
+            VideoAnalysisCache(QString::fromStdString(videoPath)).save(decoder.getAnalysis());
+        }
+
+        // Mark producer as finished; the consumer drains what is left
+        pipeline.chunkQueue.close();
 
-        // Mark producer as finished
+        // Unregister decoder before it goes out of scope
         {
-            QMutexLocker locker(&m_queueMutex);
-            m_producerFinished = true;
-            m_queueNotEmpty.wakeOne();  // Wake consumer in case it's waiting
+            QMutexLocker locker(&m_pipelinesMutex);
+            pipeline.decoder = nullptr;
         }
 
         decoder.close();
 
-        // Unregister decoder
+    } catch (const std::exception& e) {
         {
-            QMutexLocker locker(&m_decoderMutex);
-            m_currentDecoder = nullptr;
+            QMutexLocker locker(&m_mutex);
+            pipeline.error = QString("Producer thread error: %1").arg(e.what());
         }
 
-    } catch (const std::exception& e) {
-        QMutexLocker locker(&m_mutex);
-        m_currentError = QString("Producer thread error: %1").arg(e.what());
+        // Unregister decoder
+        {
+            QMutexLocker locker(&m_pipelinesMutex);
+            pipeline.decoder = nullptr;
+        }
 
         // Mark producer as finished even on error
-        QMutexLocker queueLocker(&m_queueMutex);
-        m_producerFinished = true;
-        m_queueNotEmpty.wakeOne();
+        pipeline.chunkQueue.close();
+    }
+}
 
-        // Unregister decoder
-        QMutexLocker decoderLocker(&m_decoderMutex);
-        m_currentDecoder = nullptr;
+cv::Mat ProcessingThread::decodeSlideFrame(VideoPipeline& pipeline, const std::string& videoPath,
+                                           const HardwareDecoder::FrameSource& source)
+{
+    cv::Mat frame;
+    if (source.frame) {
+        HardwareDecoder::convertSourceToMat(source, frame);
+        return frame;
     }
+
+    // The producer's decoder is busy extracting, so selected slides get a decoder of their own
+    if (!pipeline.slideDecoder) {
+        auto decoder = std::make_unique<HardwareDecoder>();
+        if (!decoder->openVideo(videoPath, &pipeline.analysis)) {
+            qWarning() << "ProcessingThread: Failed to open video for slide decoding:"
+                       << QString::fromStdString(decoder->getLastError());
+            return frame;
+        }
+        pipeline.slideDecoder = std::move(decoder);
+    }
+
+    if (pipeline.slideDecoder->decodeSourceFrame(source, frame)) {
+        return frame;
+    }
+    qWarning() << "ProcessingThread: Failed to decode slide frame:"
+               << QString::fromStdString(pipeline.slideDecoder->getLastError());
+
+    // A failed seek can leave the decoder in a bad state; retry once with a fresh one
+    pipeline.slideDecoder.reset();
+    auto decoder = std::make_unique<HardwareDecoder>();
+    if (decoder->openVideo(videoPath, &pipeline.analysis)) {
+        frame.release();
+        if (decoder->decodeSourceFrame(source, frame)) {
+            pipeline.slideDecoder = std::move(decoder);
+            return frame;
+        }
+    }
+    return cv::Mat();
 }
 
-void ProcessingThread::consumerThread(int videoIndex, const QString& outputDir, const QString& videoName)
+void ProcessingThread::consumerThread(VideoPipeline& pipeline, const QString& outputDir, const QString& videoName)
 {
+    const int videoIndex = pipeline.videoIndex;
+    const AppConfig& config = pipeline.config;
+    ProcessingState& processingState = pipeline.processingState;
+
     try {
         int processedChunks = 0;
 
         while (true) {
             std::unique_ptr<FrameChunk> chunk;
 
-            // Wait for a chunk to be available or producer to finish
-            {
-                QMutexLocker locker(&m_queueMutex);
-                while (m_sharedQueue == nullptr && !m_producerFinished) {
-                    // Check for stop/pause while waiting
-                    if (m_shouldStop || m_shouldPause) {
-                        return;
-                    }
-                    m_queueNotEmpty.wait(&m_queueMutex);
-                }
-
-                // If no chunk available and producer finished, we're done
-                if (m_sharedQueue == nullptr && m_producerFinished) {
-                    break;
-                }
-
-                // Take the chunk from the queue
-                chunk = std::move(m_sharedQueue);
-                m_sharedQueue.reset();
-                m_queueNotFull.wakeOne();  // Wake producer
+            // Wait for a chunk; false means the producer finished and the queue is drained
+            if (!pipeline.chunkQueue.pop(chunk, [this]() { return shouldInterrupt(); })) {
+                break;
             }
+            size_t chunkBytes = chunk->getMemoryUsage();
+
+            // Return the chunk's share of the memory budget once it is released,
+            // including on early returns
+            BudgetRelease budgetRelease(m_memoryBudget, chunkBytes);
 
             // Check for stop/pause before processing
-            {
-                QMutexLocker locker(&m_mutex);
-                if (m_shouldStop || m_shouldPause) {
-                    return;
-                }
+            if (shouldInterrupt()) {
+                return;
             }
 
             // Process the chunk
             if (chunk && !chunk->empty()) {
                 // Update globalFrameOffset before processing
-                m_processingState.globalFrameOffset = chunk->startOffset;
+                processingState.globalFrameOffset = chunk->startOffset;
 
                 // Update status for SSIM calculation
                 m_videoQueue->updateStatus(videoIndex, ProcessingStatus::SSIMCalculating);
 
                 // Get configuration parameters
-                double ssimThreshold = ConfigManager::getSSIMThreshold(m_config.ssimPreset, m_config.customSSIMThreshold);
+                double ssimThreshold = ConfigManager::getSSIMThreshold(config.ssimPreset, config.customSSIMThreshold,
+                                                                       config.ssimMode);
                 int verificationCount = 3;  // Hardcoded as per PLAN.md requirements
 
                 // Process chunk using slide detector
-                SlideDetectionResult result = m_slideDetector->detectSlidesFromChunk(
+                SlideDetectionResult result = pipeline.slideDetector->detectSlidesFromChunk(
                     chunk->frames,
-                    m_processingState,
+                    processingState,
                     chunk->isLastChunk,
                     ssimThreshold,
                     verificationCount,
-                    m_config.enableDownsampling,
-                    m_config.downsampleWidth,
-                    m_config.downsampleHeight
+                    config.enableDownsampling,
+                    config.downsampleWidth,
+                    config.downsampleHeight
                 );
 
                 // Check for stop/pause after processing
-                {
-                    QMutexLocker locker(&m_mutex);
-                    if (m_shouldStop || m_shouldPause) {
-                        return;
-                    }
+                if (shouldInterrupt()) {
+                    return;
                 }
 
                 // Save any new slides detected in this chunk
                 if (!result.selectedSlideIndices.empty()) {
                     m_videoQueue->updateStatus(videoIndex, ProcessingStatus::ImageProcessing);
 
+                    // Slide numbers continue from previous chunks and follow each slide's position in
+                    // the detection result, so a slide that cannot be produced leaves only its own number unused
+                    const int firstSlideNumber = static_cast<int>(processingState.savedSlideIndices.size())
+                                               - static_cast<int>(result.selectedSlideIndices.size()) + 1;
+
                     // Convert global indices to local indices for frame access
                     std::vector<cv::Mat> selectedFrames;
-                    for (int globalIndex : result.selectedSlideIndices) {
+                    std::vector<int> slideNumbers;
+                    for (size_t i = 0; i < result.selectedSlideIndices.size(); ++i) {
+                        int globalIndex = result.selectedSlideIndices[i];
+                        int slideNumber = firstSlideNumber + static_cast<int>(i);
+
                         // Convert global index to local index within current chunk
                         int localIndex = globalIndex - chunk->startOffset;
                         if (localIndex >= 0 && localIndex < static_cast<int>(chunk->frames.size())) {
-                            selectedFrames.push_back(chunk->frames[localIndex]);
+                            // Detection may have run on small luma frames; slides are saved at full resolution
+                            cv::Mat fullFrame = chunk->getFullFrame(localIndex);
+                            if (fullFrame.empty()) {
+                                // Keep the slide at detection resolution rather than losing it
+                                qWarning() << "ProcessingThread: Failed to produce full-resolution frame for slide" << globalIndex;
+                                cv::Mat detectionFrame = chunk->getFrame(localIndex);
+                                if (detectionFrame.empty()) {
+                                    emit videoInfoLogged(videoIndex, QString("Failed to decode slide %1 (frame %2)")
+                                                         .arg(slideNumber).arg(globalIndex));
+                                    pipeline.slideDecodeFailures++;
+                                    continue;
+                                }
+                                if (detectionFrame.channels() == 1) {
+                                    cv::cvtColor(detectionFrame, fullFrame, cv::COLOR_GRAY2BGR);
+                                } else {
+                                    fullFrame = detectionFrame.clone();
+                                }
+                                emit videoInfoLogged(videoIndex, QString("Slide %1 (frame %2) could not be re-decoded, saved at detection resolution")
+                                                     .arg(slideNumber).arg(globalIndex));
+                                pipeline.slideDecodeFallbacks++;
+                            }
+                            selectedFrames.push_back(fullFrame);
+                            slideNumbers.push_back(slideNumber);
                         }
                     }
 
-                    // Save slides with proper naming (continuing from previous slides)
-                    int startSlideNumber = static_cast<int>(m_processingState.savedSlideIndices.size()) - static_cast<int>(selectedFrames.size()) + 1;
+                    // Post-processing inputs are derived from the in-memory frames when enabled,
+                    // so saved slides never have to be decoded again
+                    bool inMemoryFeatures = config.enablePostProcessing && config.postProcessFromMemory;
+                    SlideWriter::HashMode hashMode = SlideWriter::HashMode::None;
+                    if (inMemoryFeatures && (config.deleteRedundant || config.compareExcluded)) {
+                        hashMode = config.fastPHash ? SlideWriter::HashMode::Fast : SlideWriter::HashMode::Reference;
+                    }
+                    SlideWriter::ModelInputMode modelInputMode = SlideWriter::ModelInputMode::None;
+                    if (inMemoryFeatures && config.enableMLClassification && MLClassifier::isAvailable()) {
+                        modelInputMode = config.mlReducedDecode ? SlideWriter::ModelInputMode::Reduced
+                                                                : SlideWriter::ModelInputMode::Full;
+                    }
+
+                    // Hand slides to the writer stage; encoding runs in the background while the next
+                    // chunk is detected
                     for (size_t i = 0; i < selectedFrames.size(); ++i) {
                         QString fileName = QString("slide_%1_%2.jpg")
                                           .arg(videoName)
-                                          .arg(startSlideNumber + static_cast<int>(i), 3, 10, QChar('0'));
+                                          .arg(slideNumbers[i], 3, 10, QChar('0'));
                         QString filePath = QDir(outputDir).filePath(fileName);
 
-                        // Save the OpenCV Mat as JPEG using Unicode-safe helper
-                        std::vector<int> compression_params;
-                        compression_params.push_back(cv::IMWRITE_JPEG_QUALITY);
-                        compression_params.push_back(m_config.jpegQuality);
-
-                        if (!ImageIOHelper::imwriteUnicode(filePath, selectedFrames[i], compression_params)) {
-                            QString errorMsg = QString("Failed to save slide: %1").arg(filePath);
-                            emit videoInfoLogged(videoIndex, errorMsg);
-                        }
+                        m_slideWriter->submit(videoIndex, filePath, selectedFrames[i], config.jpegQuality,
+                                              hashMode, modelInputMode);
                     }
                 }
 
@@ -603,8 +850,8 @@ void ProcessingThread::consumerThread(int videoIndex, const QString& outputDir,
                 // since we process chunks as they arrive
                 double extractionProgress = 0.0;
                 {
-                    QMutexLocker locker(&m_queueMutex);
-                    extractionProgress = m_currentExtractionProgress;
+                    QMutexLocker locker(&pipeline.queueMutex);
+                    extractionProgress = pipeline.currentExtractionProgress;
                 }
 
                 if (chunk->isLastChunk) {
@@ -621,11 +868,12 @@ void ProcessingThread::consumerThread(int videoIndex, const QString& outputDir,
             }
 
             // Chunk goes out of scope here, releasing memory
+            chunk.reset();
         }
 
     } catch (const std::exception& e) {
         QMutexLocker locker(&m_mutex);
-        m_currentError = QString("Consumer thread error: %1").arg(e.what());
+        pipeline.error = QString("Consumer thread error: %1").arg(e.what());
     }
 }
 
@@ -646,18 +894,3 @@ void ProcessingThread::onExtractionError(const QString& error)
 {
     m_currentError = error;
 }
-
-void ProcessingThread::onSSIMCalculationProgress(int current, int total)
-{
-    emit ssimCalculationProgress(m_currentVideoIndex, current, total);
-}
-
-void ProcessingThread::onSlideDetectionProgress(int current, int total)
-{
-    emit slideDetectionProgress(m_currentVideoIndex, current, total);
-}
-
-void ProcessingThread::onDetectionError(const QString& error)
-{
-    m_currentError = error;
-}
\ No newline at end of file
@@ -5,13 +5,18 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QTimer>
+#include <QHash>
 #include <memory>
+#include <vector>
+#include <atomic>
+#include <algorithm>
 #include "videoprocessor.h"
 #include "hardwaredecoder.h"
 #include "slidedetector.h"
 #include "configmanager.h"
 #include "videoqueue.h"
 #include "chunkprocessor.h"
+#include "slidewriter.h"
 
 class ProcessingThread : public QThread
 {
@@ -54,6 +59,14 @@ public:
      */
     void updateConfig(const AppConfig& config);
 
+    /**
+     * Take the post-processing features computed while a video's slides were written
+     * Call once after videoProcessingCompleted; the features are released afterwards
+     * @param videoIndex Index of the completed video
+     * @return Features keyed by slide file name (empty if none were computed)
+     */
+    QList<SlideFeatures> takeSlideFeatures(int videoIndex);
+
 signals:
     void processingStarted();
     void processingPaused();
@@ -73,11 +86,58 @@ private slots:
     void onFrameExtracted(int frameNumber, int totalFrames);
     void onExtractionProgress(double percentage);
     void onExtractionError(const QString& error);
-    void onSSIMCalculationProgress(int current, int total);
-    void onSlideDetectionProgress(int current, int total);
-    void onDetectionError(const QString& error);
 
 private:
+    /**
+     * Per-video producer/consumer state
+     * Each concurrently processed video owns one pipeline with its own decoder,
+     * slide detector, processing state and chunk handoff
+     */
+    struct VideoPipeline {
+        int videoIndex;
+        AppConfig config;                            // Configuration snapshot for this video
+        std::unique_ptr<SlideDetector> slideDetector;
+        ProcessingState processingState;
+
+        ChunkQueue chunkQueue;                       // Bounded decoder -> detector handoff
+        std::atomic<bool> consumerExited;            // Lets a blocked producer bail out
+
+        QMutex queueMutex;                           // Guards the extraction progress fields below
+        int totalFramesExtracted;                    // Total frames that will be extracted (set by producer)
+        double currentExtractionProgress;            // Current frame extraction progress (0-100)
+
+        QString error;                               // Guarded by ProcessingThread::m_mutex
+        HardwareDecoder* decoder;                    // Guarded by ProcessingThread::m_pipelinesMutex
+        HardwareDecoder::VideoAnalysis analysis;     // From the info pass, reused by the producer's decoder
+        std::unique_ptr<HardwareDecoder> slideDecoder; // Re-decodes selected slides, consumer thread only
+        int slideDecodeFallbacks;                    // Slides saved at detection resolution after a failed re-decode, consumer thread only
+        int slideDecodeFailures;                     // Slides that could not be produced at all, consumer thread only
+
+        VideoPipeline(int index, const AppConfig& cfg)
+            : videoIndex(index), config(cfg),
+              chunkQueue(static_cast<size_t>(std::max(1, cfg.chunkQueueDepth)), cfg.useLockFreeChunkQueue),
+              consumerExited(false), totalFramesExtracted(0), currentExtractionProgress(0.0),
+              decoder(nullptr), slideDecodeFallbacks(0), slideDecodeFailures(0) {}
+    };
+
+    /**
+     * Worker loop: claims queued videos and processes them until the queue is drained
+     * or processing is stopped/paused. Several workers run concurrently.
+     */
+    void videoWorker();
+
+    /**
+     * Atomically pick the next queued video and mark it as being processed
+     * @return Index of the claimed video, -1 if none available
+     */
+    int claimNextVideo();
+
+    /**
+     * Check whether processing should stop or pause
+     * @return true if workers should bail out
+     */
+    bool shouldInterrupt() const;
+
     /**
      * Process a single video
      * @param videoIndex Index of video in queue
@@ -87,27 +147,40 @@ private:
 
     /**
      * Process video with chunk-based memory-limited approach
-     * @param video Video item to process
+     * @param videoPath Path to video file
      * @param videoIndex Index of video in queue
      * @return true if successful
      */
-    bool processVideoWithChunks(VideoQueueItem* video, int videoIndex);
+    bool processVideoWithChunks(const QString& videoPath, int videoIndex);
 
 
     /**
      * Producer thread function for frame extraction
+     * @param pipeline Pipeline of the video being processed
      * @param videoPath Path to video file
      * @param chunkSize Size of each chunk
      */
-    void producerThread(const std::string& videoPath, int chunkSize);
+    void producerThread(VideoPipeline& pipeline, const std::string& videoPath, int chunkSize);
 
     /**
      * Consumer thread function for slide detection and processing
-     * @param videoIndex Index of video in queue
+     * @param pipeline Pipeline of the video being processed
      * @param outputDir Output directory for slides
      * @param videoName Video file name (without extension)
      */
-    void consumerThread(int videoIndex, const QString& outputDir, const QString& videoName);
+    void consumerThread(VideoPipeline& pipeline, const QString& outputDir, const QString& videoName);
+
+    /**
+     * Produce the full-resolution frame of a selected slide from its detection frame source
+     * Frames that were not retained are decoded again by the pipeline's slide decoder, which
+     * is opened on first use. Called from the consumer thread.
+     * @param pipeline Pipeline of the video being processed
+     * @param videoPath Path to video file
+     * @param source Source of the detection frame
+     * @return Full-resolution BGR frame, empty on failure
+     */
+    cv::Mat decodeSlideFrame(VideoPipeline& pipeline, const std::string& videoPath,
+                             const HardwareDecoder::FrameSource& source);
 
     /**
      * Create output directory for slides
@@ -155,7 +228,6 @@ private:
 
     VideoQueue* m_videoQueue;
     std::unique_ptr<VideoProcessor> m_videoProcessor;
-    std::unique_ptr<SlideDetector> m_slideDetector;
     AppConfig m_config;
 
     mutable QMutex m_mutex;
@@ -164,25 +236,22 @@ private:
     bool m_shouldPause;
     bool m_isProcessing;
 
-    int m_currentVideoIndex;
-    QString m_currentError;
-
-    // Producer-consumer model for chunk-based processing
-    ProcessingState m_processingState;
-    QMutex m_queueMutex;
-    QWaitCondition m_queueNotFull;
-    QWaitCondition m_queueNotEmpty;
-    std::unique_ptr<FrameChunk> m_sharedQueue;  // Capacity = 1 queue
-    bool m_producerFinished;
-    int m_totalFramesExtracted;  // Total frames that will be extracted (set by producer)
-    double m_currentExtractionProgress;  // Current frame extraction progress (0-100)
-
-    // Current decoder for cancellation support
-    HardwareDecoder* m_currentDecoder;
-    QMutex m_decoderMutex;
-
-    // Pause between videos (in milliseconds)
-    static const int INTER_VIDEO_PAUSE_MS = 2000;
+    int m_currentVideoIndex;     // Most recently started video (legacy VideoProcessor path)
+    QString m_currentError;      // Error reported by the legacy VideoProcessor path
+
+    // Active per-video pipelines, registered for cancellation support
+    std::vector<VideoPipeline*> m_activePipelines;
+    QMutex m_pipelinesMutex;
+
+    // Budget for decoded chunks held across all concurrent pipelines
+    MemoryBudget m_memoryBudget;
+
+    // Background JPEG encoding shared by all pipelines (alive while workers run)
+    std::unique_ptr<SlideWriter> m_slideWriter;
+
+    // In-memory post-processing features of completed videos, until taken
+    QHash<int, QList<SlideFeatures>> m_slideFeatures;
+    QMutex m_slideFeaturesMutex;
 };
 
 #endif // PROCESSINGTHREAD_H
\ No newline at end of file
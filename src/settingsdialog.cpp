@@ -67,6 +67,8 @@ void SettingsDialog::setupUI()
     // Connect signals
     connect(m_ssimPresetCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &SettingsDialog::onSSIMPresetChanged);
+    connect(m_ssimModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &SettingsDialog::onSSIMModeChanged);
     connect(m_enableDownsamplingCheckBox, &QCheckBox::toggled,
             this, &SettingsDialog::onDownsamplingToggled);
     connect(m_downsamplePresetCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -120,6 +122,14 @@ void SettingsDialog::setupProcessingTab()
     ssimLayout->setContentsMargins(12, 12, 12, 12);
     ssimLayout->setSpacing(8);
 
+    // SSIM Mode
+    QLabel* ssimModeLabel = new QLabel("Mode:", m_processingTab);
+    m_ssimModeCombo = new QComboBox(m_processingTab);
+    m_ssimModeCombo->addItem("Global", static_cast<int>(SSIMMode::Global));
+    m_ssimModeCombo->addItem("Tiled (local)", static_cast<int>(SSIMMode::Tiled));
+    m_ssimModeCombo->setToolTip("Tiled compares ~16x16 pixel tiles and uses the lowest tile score, "
+                                "so small changes on a static slide are detected with a less extreme threshold.");
+
     // SSIM Preset
     QLabel* ssimPresetLabel = new QLabel("Preset:", m_processingTab);
     m_ssimPresetCombo = new QComboBox(m_processingTab);
@@ -141,11 +151,13 @@ void SettingsDialog::setupProcessingTab()
     m_ssimHelpLabel->setWordWrap(true);
     m_ssimHelpLabel->setStyleSheet("color: #666; font-size: 11px;");
 
-    ssimLayout->addWidget(ssimPresetLabel, 0, 0);
-    ssimLayout->addWidget(m_ssimPresetCombo, 0, 1);
-    ssimLayout->addWidget(customSSIMLabel, 1, 0);
-    ssimLayout->addWidget(m_customSSIMSpinBox, 1, 1);
-    ssimLayout->addWidget(m_ssimHelpLabel, 2, 0, 1, 2);
+    ssimLayout->addWidget(ssimModeLabel, 0, 0);
+    ssimLayout->addWidget(m_ssimModeCombo, 0, 1);
+    ssimLayout->addWidget(ssimPresetLabel, 1, 0);
+    ssimLayout->addWidget(m_ssimPresetCombo, 1, 1);
+    ssimLayout->addWidget(customSSIMLabel, 2, 0);
+    ssimLayout->addWidget(m_customSSIMSpinBox, 2, 1);
+    ssimLayout->addWidget(m_ssimHelpLabel, 3, 0, 1, 2);
 
     tabLayout->addWidget(m_ssimGroup);
 
@@ -205,13 +217,47 @@ void SettingsDialog::setupProcessingTab()
     m_chunkSizeSpinBox->setSingleStep(50);
     m_chunkSizeSpinBox->setSuffix(" frames");
 
-    m_chunkHelpLabel = new QLabel("Number of frames processed at once. Smaller values use less memory but may be slower. Larger values are faster but use more memory.", m_processingTab);
+    QLabel* chunkQueueDepthLabel = new QLabel("Chunk Queue Depth:", m_processingTab);
+    m_chunkQueueDepthSpinBox = new QSpinBox(m_processingTab);
+    m_chunkQueueDepthSpinBox->setRange(1, 16);
+    m_chunkQueueDepthSpinBox->setSuffix(" chunks");
+
+    m_lockFreeQueueCheckBox = new QCheckBox("Use lock-free chunk queue", m_processingTab);
+
+    QLabel* concurrentVideosLabel = new QLabel("Concurrent Videos:", m_processingTab);
+    m_concurrentVideosSpinBox = new QSpinBox(m_processingTab);
+    m_concurrentVideosSpinBox->setRange(1, 16);
+
+    QLabel* decoderThreadsLabel = new QLabel("Decoders per Video:", m_processingTab);
+    m_decoderThreadsSpinBox = new QSpinBox(m_processingTab);
+    m_decoderThreadsSpinBox->setRange(1, 16);
+
+    QLabel* memoryBudgetLabel = new QLabel("Memory Budget:", m_processingTab);
+    m_memoryBudgetSpinBox = new QSpinBox(m_processingTab);
+    m_memoryBudgetSpinBox->setRange(0, 262144);
+    m_memoryBudgetSpinBox->setSingleStep(512);
+    m_memoryBudgetSpinBox->setSuffix(" MB");
+    m_memoryBudgetSpinBox->setSpecialValueText("Unlimited");
+
+    m_chunkHelpLabel = new QLabel("Number of frames processed at once. Smaller values use less memory but may be slower. Larger values are faster but use more memory. "
+                                  "A deeper chunk queue lets decoding run ahead of slide detection at the cost of one chunk of memory per slot. "
+                                  "Concurrent videos are decoded in parallel; the memory budget caps decoded frames held across all of them. "
+                                  "Several decoders per video split a single long video at keyframes and decode its parts in parallel.", m_processingTab);
     m_chunkHelpLabel->setWordWrap(true);
     m_chunkHelpLabel->setStyleSheet("color: #666; font-size: 11px;");
 
     chunkLayout->addWidget(chunkSizeLabel, 0, 0);
     chunkLayout->addWidget(m_chunkSizeSpinBox, 0, 1);
-    chunkLayout->addWidget(m_chunkHelpLabel, 1, 0, 1, 2);
+    chunkLayout->addWidget(chunkQueueDepthLabel, 1, 0);
+    chunkLayout->addWidget(m_chunkQueueDepthSpinBox, 1, 1);
+    chunkLayout->addWidget(m_lockFreeQueueCheckBox, 2, 0, 1, 2);
+    chunkLayout->addWidget(concurrentVideosLabel, 3, 0);
+    chunkLayout->addWidget(m_concurrentVideosSpinBox, 3, 1);
+    chunkLayout->addWidget(decoderThreadsLabel, 4, 0);
+    chunkLayout->addWidget(m_decoderThreadsSpinBox, 4, 1);
+    chunkLayout->addWidget(memoryBudgetLabel, 5, 0);
+    chunkLayout->addWidget(m_memoryBudgetSpinBox, 5, 1);
+    chunkLayout->addWidget(m_chunkHelpLabel, 6, 0, 1, 2);
 
     tabLayout->addWidget(m_chunkGroup);
 
@@ -227,13 +273,24 @@ void SettingsDialog::setupProcessingTab()
     m_jpegQualitySpinBox->setSingleStep(5);
     m_jpegQualitySpinBox->setValue(95);
 
-    m_outputHelpLabel = new QLabel("Higher values produce better quality images but larger file sizes.", m_processingTab);
+    QLabel* slideWriterThreadsLabel = new QLabel("Writer Threads:", m_processingTab);
+    m_slideWriterThreadsSpinBox = new QSpinBox(m_processingTab);
+    m_slideWriterThreadsSpinBox->setRange(1, 16);
+
+    m_postProcessFromMemoryCheckBox = new QCheckBox("Prepare post-processing while extracting", m_processingTab);
+
+    m_outputHelpLabel = new QLabel("Higher values produce better quality images but larger file sizes. "
+                                   "Slides are encoded and written in the background by the writer threads while detection continues. "
+                                   "Preparing post-processing while extracting computes pHash and ML inputs from the decoded frames instead of re-reading the saved images.", m_processingTab);
     m_outputHelpLabel->setWordWrap(true);
     m_outputHelpLabel->setStyleSheet("color: #666; font-size: 11px;");
 
     outputLayout->addWidget(jpegQualityLabel, 0, 0);
     outputLayout->addWidget(m_jpegQualitySpinBox, 0, 1);
-    outputLayout->addWidget(m_outputHelpLabel, 1, 0, 1, 2);
+    outputLayout->addWidget(slideWriterThreadsLabel, 1, 0);
+    outputLayout->addWidget(m_slideWriterThreadsSpinBox, 1, 1);
+    outputLayout->addWidget(m_postProcessFromMemoryCheckBox, 2, 0, 1, 2);
+    outputLayout->addWidget(m_outputHelpLabel, 3, 0, 1, 2);
 
     tabLayout->addWidget(m_outputGroup);
     tabLayout->addStretch();
@@ -435,15 +492,24 @@ void SettingsDialog::setupMLClassificationTab()
 void SettingsDialog::updateUIFromConfig()
 {
     // SSIM settings
+    m_ssimModeCombo->setCurrentIndex(static_cast<int>(m_config.ssimMode));
     m_ssimPresetCombo->setCurrentIndex(static_cast<int>(m_config.ssimPreset));
+    m_customSSIMSpinBox->setMinimum(ConfigManager::getMinimumCustomSSIMThreshold(m_config.ssimMode));
     m_customSSIMSpinBox->setValue(m_config.customSSIMThreshold);
-    onSSIMPresetChanged(); // Update custom spinbox state
+    onSSIMModeChanged(); // Update preset labels and custom spinbox state
 
     // Chunk size
     m_chunkSizeSpinBox->setValue(m_config.chunkSize);
+    m_chunkQueueDepthSpinBox->setValue(m_config.chunkQueueDepth);
+    m_lockFreeQueueCheckBox->setChecked(m_config.useLockFreeChunkQueue);
+    m_concurrentVideosSpinBox->setValue(m_config.maxConcurrentVideos);
+    m_decoderThreadsSpinBox->setValue(m_config.decoderThreads);
+    m_memoryBudgetSpinBox->setValue(m_config.memoryBudgetMB);
 
     // Output settings
     m_jpegQualitySpinBox->setValue(m_config.jpegQuality);
+    m_slideWriterThreadsSpinBox->setValue(m_config.slideWriterThreads);
+    m_postProcessFromMemoryCheckBox->setChecked(m_config.postProcessFromMemory);
 
     // Downsampling settings
     m_enableDownsamplingCheckBox->setChecked(m_config.enableDownsampling);
@@ -479,14 +545,22 @@ void SettingsDialog::updateUIFromConfig()
 void SettingsDialog::updateConfigFromUI()
 {
     // SSIM settings
+    m_config.ssimMode = static_cast<SSIMMode>(m_ssimModeCombo->currentData().toInt());
     m_config.ssimPreset = static_cast<SSIMPreset>(m_ssimPresetCombo->currentData().toInt());
     m_config.customSSIMThreshold = m_customSSIMSpinBox->value();
 
     // Chunk size
     m_config.chunkSize = m_chunkSizeSpinBox->value();
+    m_config.chunkQueueDepth = m_chunkQueueDepthSpinBox->value();
+    m_config.useLockFreeChunkQueue = m_lockFreeQueueCheckBox->isChecked();
+    m_config.maxConcurrentVideos = m_concurrentVideosSpinBox->value();
+    m_config.decoderThreads = m_decoderThreadsSpinBox->value();
+    m_config.memoryBudgetMB = m_memoryBudgetSpinBox->value();
 
     // Output settings
     m_config.jpegQuality = m_jpegQualitySpinBox->value();
+    m_config.slideWriterThreads = m_slideWriterThreadsSpinBox->value();
+    m_config.postProcessFromMemory = m_postProcessFromMemoryCheckBox->isChecked();
 
     // Downsampling settings
     m_config.enableDownsampling = m_enableDownsamplingCheckBox->isChecked();
@@ -552,11 +626,40 @@ void SettingsDialog::onSSIMPresetChanged()
 
     if (!isCustom) {
         // Update custom value to match preset
-        double presetValue = ConfigManager::getSSIMThreshold(preset);
+        SSIMMode mode = static_cast<SSIMMode>(m_ssimModeCombo->currentData().toInt());
+        double presetValue = ConfigManager::getSSIMThreshold(preset, 0.9985, mode);
         m_customSSIMSpinBox->setValue(presetValue);
     }
 }
 
+void SettingsDialog::onSSIMModeChanged()
+{
+    SSIMMode mode = static_cast<SSIMMode>(m_ssimModeCombo->currentData().toInt());
+
+    // Presets map to different thresholds per mode; show the ones that apply
+    for (int i = 0; i < m_ssimPresetCombo->count(); ++i) {
+        SSIMPreset preset = static_cast<SSIMPreset>(m_ssimPresetCombo->itemData(i).toInt());
+        if (preset != SSIMPreset::Custom) {
+            m_ssimPresetCombo->setItemText(i, QString("%1 (%2)")
+                                               .arg(ConfigManager::getPresetName(preset))
+                                               .arg(ConfigManager::getSSIMThreshold(preset, 0.9985, mode)));
+        }
+    }
+
+    // Tiled custom values may go much lower; global keeps its original range
+    m_customSSIMSpinBox->setMinimum(ConfigManager::getMinimumCustomSSIMThreshold(mode));
+
+    if (mode == SSIMMode::Tiled) {
+        m_ssimHelpLabel->setText("Tiled mode scores the most changed ~16x16 pixel tile, so a new bullet point "
+                                 "drops the score far below the threshold while compression noise does not.");
+    } else {
+        m_ssimHelpLabel->setText("Higher global structural similarity threshold indicate stricter matching. "
+                                 "Note that a minor change of 0.001 can significantly impact performance.");
+    }
+
+    onSSIMPresetChanged();
+}
+
 void SettingsDialog::onDownsamplingToggled()
 {
     bool enabled = m_enableDownsamplingCheckBox->isChecked();
@@ -621,8 +724,8 @@ void SettingsDialog::onAddFromImageClicked()
     }
 
     // Calculate pHash
-    std::vector<uint8_t> hash = PHashCalculator::calculatePHash(filePath);
-    if (hash.empty()) {
+    PHash hash = PHashCalculator::calculatePHash(filePath);
+    if (!hash.valid) {
         emit statusMessage("Error: Failed to calculate pHash for the selected image.");
         return;
     }
@@ -659,8 +762,8 @@ void SettingsDialog::onManualInputClicked()
         return;
     }
 
-    std::vector<uint8_t> hash = PHashCalculator::hexStringToHash(hashHex);
-    if (hash.empty()) {
+    PHash hash = PHashCalculator::hexStringToHash(hashHex);
+    if (!hash.valid) {
         emit statusMessage("Error: Invalid hexadecimal string.");
         return;
     }
@@ -898,13 +1001,22 @@ void SettingsDialog::onRestoreDefaultsClicked()
     m_exclusionList = PostProcessor::getDefaultExclusionList();
 
     // Update UI to reflect defaults - Processing tab
+    m_ssimModeCombo->setCurrentIndex(static_cast<int>(m_config.ssimMode));
     m_ssimPresetCombo->setCurrentIndex(static_cast<int>(m_config.ssimPreset));
+    m_customSSIMSpinBox->setMinimum(ConfigManager::getMinimumCustomSSIMThreshold(m_config.ssimMode));
     m_customSSIMSpinBox->setValue(m_config.customSSIMThreshold);
-    onSSIMPresetChanged();
+    onSSIMModeChanged();
 
     m_chunkSizeSpinBox->setValue(m_config.chunkSize);
+    m_chunkQueueDepthSpinBox->setValue(m_config.chunkQueueDepth);
+    m_lockFreeQueueCheckBox->setChecked(m_config.useLockFreeChunkQueue);
+    m_concurrentVideosSpinBox->setValue(m_config.maxConcurrentVideos);
+    m_decoderThreadsSpinBox->setValue(m_config.decoderThreads);
+    m_memoryBudgetSpinBox->setValue(m_config.memoryBudgetMB);
 
     m_jpegQualitySpinBox->setValue(m_config.jpegQuality);
+    m_slideWriterThreadsSpinBox->setValue(m_config.slideWriterThreads);
+    m_postProcessFromMemoryCheckBox->setChecked(m_config.postProcessFromMemory);
 
     m_enableDownsamplingCheckBox->setChecked(m_config.enableDownsampling);
     m_downsampleWidthSpinBox->setValue(m_config.downsampleWidth);
@@ -41,6 +41,7 @@ signals:
 
 private slots:
     void onSSIMPresetChanged();
+    void onSSIMModeChanged();
     void onDownsamplingToggled();
     void onDownsamplePresetChanged();
     void onOkClicked();
@@ -83,6 +84,7 @@ private:
 
     // SSIM Settings Group
     QGroupBox* m_ssimGroup;
+    QComboBox* m_ssimModeCombo;
     QComboBox* m_ssimPresetCombo;
     QDoubleSpinBox* m_customSSIMSpinBox;
     QLabel* m_ssimHelpLabel;
@@ -90,11 +92,18 @@ private:
     // Chunk Size Settings Group
     QGroupBox* m_chunkGroup;
     QSpinBox* m_chunkSizeSpinBox;
+    QSpinBox* m_chunkQueueDepthSpinBox;
+    QCheckBox* m_lockFreeQueueCheckBox;
+    QSpinBox* m_concurrentVideosSpinBox;
+    QSpinBox* m_decoderThreadsSpinBox;
+    QSpinBox* m_memoryBudgetSpinBox;
     QLabel* m_chunkHelpLabel;
 
     // Output Settings Group
     QGroupBox* m_outputGroup;
     QSpinBox* m_jpegQualitySpinBox;
+    QSpinBox* m_slideWriterThreadsSpinBox;
+    QCheckBox* m_postProcessFromMemoryCheckBox;
     QLabel* m_outputHelpLabel;
 
     // Downsampling Settings Group
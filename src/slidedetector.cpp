@@ -1,5 +1,6 @@
 #include "slidedetector.h"
 #include "memoryoptimizer.h"
+#include "optimizationmanager.h"
 #include <QDebug>
 #include <QElapsedTimer>
 #include <algorithm>
@@ -8,6 +9,18 @@
 SlideDetector::SlideDetector(QObject *parent)
     : QObject(parent)
 {
+    // Score through the backend OptimizationManager benchmarked at startup; when it was not
+    // initialized the calculator keeps its built-in kernels. The shared form serializes
+    // concurrent pipelines on backends that are not thread-safe.
+    OptimizationManager& optimizationManager = OptimizationManager::getInstance();
+    if (optimizationManager.isReady()) {
+        m_ssimCalculator.setPairScorer(optimizationManager.getSharedCalculator());
+    }
+}
+
+void SlideDetector::setTiledSSIM(bool enabled)
+{
+    m_ssimCalculator.setTiledScoring(enabled);
 }
 
 SlideDetectionResult SlideDetector::detectSlides(const std::vector<std::string>& framePaths,
@@ -119,27 +132,20 @@ SlideDetectionResult SlideDetector::detectSlidesFromChunk(const std::vector<cv::
         return result;
     }
 
-    // Step 1: Build working frames using single-frame overlap mechanism
-    std::vector<cv::Mat> workingFrames;
+    // Step 1: Score the chunk against the previous chunk's last frame (single-frame overlap).
+    // For subsequent chunks score 0 compares the carried frame with newFrames[0], so local
+    // indices follow workingFrames = [lastFrame] + newFrames. Each frame is preprocessed once
+    // and the preprocessed last frame is carried instead of re-processing it next chunk.
     int startIndex = 0;
-
-    if (state.isFirstChunk()) {
-        // First chunk: use newFrames directly
-        workingFrames = newFrames;
-        startIndex = 0;
-    } else {
-        // Subsequent chunks: prepend lastFrame to newFrames
-        workingFrames.reserve(newFrames.size() + 1);
-        workingFrames.push_back(state.getLastFrameView());
-        workingFrames.insert(workingFrames.end(), newFrames.begin(), newFrames.end());
-        startIndex = 0; // Always start from comparing lastFrame vs newFrames[0]
-    }
+    cv::Mat lastPreprocessed;
 
     // Step 2: Calculate SSIM scores for all adjacent frame pairs
-    result.ssimScores = calculateSSIMScoresFromFrames(workingFrames, enableDownsampling, downsampleWidth, downsampleHeight);
+    result.ssimScores = calculateSSIMScoresFromFrames(newFrames, state.lastPreprocessedFrame,
+                                                      enableDownsampling, downsampleWidth, downsampleHeight,
+                                                      &lastPreprocessed);
 
     // Step 3: Handle first frame (only for the very first chunk)
-    if (state.isFirstChunk() && state.savedSlideIndices.empty() && !workingFrames.empty()) {
+    if (state.isFirstChunk() && state.savedSlideIndices.empty()) {
         // The first frame is saved by default
         state.savedSlideIndices.push_back(state.globalFrameOffset);
         state.lastStableIndex = state.globalFrameOffset;
@@ -280,7 +286,7 @@ SlideDetectionResult SlideDetector::detectSlidesFromChunk(const std::vector<cv::
 
     // Step 6: Update state for next chunk
     if (!newFrames.empty()) {
-        state.setLastFrame(newFrames.back()); // Store a copy using FrameBuffer
+        state.lastPreprocessedFrame = lastPreprocessed; // Detection-size gray copy, not the full frame
         state.lastFrameGlobalIndex = state.globalFrameOffset + static_cast<int>(newFrames.size()) - 1;
     }
 
@@ -363,45 +369,31 @@ std::vector<double> SlideDetector::calculateSSIMScoresFromFrames(const std::vect
                                                                int downsampleWidth,
                                                                int downsampleHeight)
 {
-    std::vector<double> scores;
-
-    if (frames.size() < 2) {
-        return scores;
-    }
-
-    // Prepare tasks for multi-threaded SSIM calculation
-    std::vector<SSIMTask> tasks;
-    tasks.reserve(frames.size() - 1);
-
-    for (size_t i = 0; i < frames.size() - 1; ++i) {
-        SSIMTask task;
-        task.index = static_cast<int>(i);
-        task.img1 = frames[i];
-        task.img2 = frames[i + 1];
-        task.useMatInput = true;  // Flag to indicate we're using Mat input
-        task.enableDownsampling = enableDownsampling;
-        task.downsampleWidth = downsampleWidth;
-        task.downsampleHeight = downsampleHeight;
-        tasks.push_back(task);
-    }
+    return calculateSSIMScoresFromFrames(frames, cv::Mat(), enableDownsampling, downsampleWidth, downsampleHeight, nullptr);
+}
 
+std::vector<double> SlideDetector::calculateSSIMScoresFromFrames(const std::vector<cv::Mat>& frames,
+                                                               const cv::Mat& previousFrame,
+                                                               bool enableDownsampling,
+                                                               int downsampleWidth,
+                                                               int downsampleHeight,
+                                                               cv::Mat* lastPreprocessed)
+{
     // Connect progress signal from SSIMCalculator
     connect(&m_ssimCalculator, &SSIMCalculator::calculationProgress,
             this, &SlideDetector::ssimCalculationProgress);
 
-    // Calculate SSIM scores using multi-threading
-    std::vector<SSIMResult> results = m_ssimCalculator.calculateMultiThreadedSSIM(tasks);
+    // Preprocess every frame once, then score adjacent pairs in parallel
+    std::vector<double> scores = m_ssimCalculator.calculateConsecutiveSSIM(frames, previousFrame,
+                                                                           enableDownsampling,
+                                                                           downsampleWidth,
+                                                                           downsampleHeight,
+                                                                           lastPreprocessed);
 
     // Disconnect progress signal
     disconnect(&m_ssimCalculator, &SSIMCalculator::calculationProgress,
                this, &SlideDetector::ssimCalculationProgress);
 
-    // Extract scores in correct order (results are already ordered by index)
-    scores.reserve(results.size());
-    for (const auto& result : results) {
-        scores.push_back(result.score);
-    }
-
     return scores;
 }
 
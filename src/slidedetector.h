@@ -24,6 +24,12 @@ class SlideDetector : public QObject
 public:
     explicit SlideDetector(QObject *parent = nullptr);
 
+    /**
+     * Score frame pairs with tiled (local) SSIM instead of global SSIM
+     * @param enabled true for tiled SSIM (lowest tile score), false for global SSIM
+     */
+    void setTiledSSIM(bool enabled);
+
     /**
      * Detect slides from a sequence of frame images using the two-stage algorithm
      * @param framePaths Vector of frame file paths in chronological order
@@ -133,6 +139,23 @@ public:
                                                      int downsampleWidth,
                                                      int downsampleHeight);
 
+    /**
+     * Calculate SSIM scores for consecutive frames, preprocessing each frame exactly once
+     * @param frames Vector of OpenCV Mat frames
+     * @param previousFrame Preprocessed frame preceding frames[0] (empty for the first chunk)
+     * @param enableDownsampling Whether to enable downsampling
+     * @param downsampleWidth Target width for downsampling
+     * @param downsampleHeight Target height for downsampling
+     * @param lastPreprocessed Receives the preprocessed last frame to carry into the next chunk
+     * @return Vector of SSIM scores, starting with previousFrame vs frames[0] when previousFrame is set
+     */
+    std::vector<double> calculateSSIMScoresFromFrames(const std::vector<cv::Mat>& frames,
+                                                     const cv::Mat& previousFrame,
+                                                     bool enableDownsampling,
+                                                     int downsampleWidth,
+                                                     int downsampleHeight,
+                                                     cv::Mat* lastPreprocessed);
+
     /**
      * Optimized calculate SSIM scores from FrameBuffers using zero-copy operations
      * @param frameBuffers Vector of FrameBuffers
@@ -0,0 +1,21 @@
+#ifndef SLIDEFEATURES_H
+#define SLIDEFEATURES_H
+
+#include <QString>
+#include <opencv2/core.hpp>
+#include "phashcalculator.h"
+
+/**
+ * @brief Post-processing inputs computed from a slide while it is still in memory
+ *
+ * Produced by the extraction pipeline when a slide is selected so that
+ * PostProcessor does not have to decode the written JPEG again for pHash
+ * or ML preprocessing. Fields that were not computed are left empty.
+ */
+struct SlideFeatures {
+    QString fileName;             // Slide file name within its output directory
+    PHash pHash;                  // 256-bit pHash, invalid if not computed
+    cv::Mat modelInput;           // RGB image at ML model input size, empty if not computed
+};
+
+#endif // SLIDEFEATURES_H
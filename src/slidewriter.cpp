@@ -0,0 +1,132 @@
+#include "slidewriter.h"
+#include "imageiohelper.h"
+#include "phashcalculator.h"
+#include "mlclassifier.h"
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+
+SlideWriter::SlideWriter(int threadCount, int maxPendingJobs)
+    : m_shutdown(false)
+{
+    int workers = std::max(1, threadCount);
+    m_maxPendingJobs = maxPendingJobs > 0 ? static_cast<size_t>(maxPendingJobs)
+                                          : static_cast<size_t>(workers) * 4;
+
+    m_workers.reserve(workers);
+    for (int i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&SlideWriter::workerLoop, this);
+    }
+}
+
+SlideWriter::~SlideWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void SlideWriter::submit(int videoIndex, const QString& filePath, const cv::Mat& frame, int jpegQuality,
+                         HashMode hashMode, ModelInputMode modelInputMode)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queueNotFull.wait(lock, [this]() { return m_jobs.size() < m_maxPendingJobs; });
+
+        m_jobs.push_back(Job{videoIndex, filePath, frame, jpegQuality, hashMode, modelInputMode});
+        m_pendingPerVideo[videoIndex]++;
+    }
+    m_jobAvailable.notify_one();
+}
+
+SlideWriteResult SlideWriter::waitForVideo(int videoIndex)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobFinished.wait(lock, [this, videoIndex]() {
+        auto it = m_pendingPerVideo.find(videoIndex);
+        return it == m_pendingPerVideo.end() || it->second == 0;
+    });
+
+    SlideWriteResult result;
+    auto it = m_resultsPerVideo.find(videoIndex);
+    if (it != m_resultsPerVideo.end()) {
+        result = std::move(it->second);
+        m_resultsPerVideo.erase(it);
+    }
+    m_pendingPerVideo.erase(videoIndex);
+    return result;
+}
+
+void SlideWriter::workerLoop()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this]() { return m_shutdown || !m_jobs.empty(); });
+
+            // Drain remaining jobs before honoring shutdown so no slide is lost
+            if (m_jobs.empty()) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        m_queueNotFull.notify_one();
+
+        // Encode and write outside the lock. An exception here must not escape the worker
+        // thread, and the job still has to be accounted for so waitForVideo() returns.
+        bool success = false;
+        SlideFeatures features;
+        try {
+            std::vector<int> compressionParams = {cv::IMWRITE_JPEG_QUALITY, job.jpegQuality};
+            success = ImageIOHelper::imwriteUnicode(job.filePath, job.frame, compressionParams);
+
+            // Derive post-processing inputs while the decoded frame is still at hand
+            if (success && (job.hashMode != HashMode::None || job.modelInputMode != ModelInputMode::None)) {
+                features.fileName = QFileInfo(job.filePath).fileName();
+                if (job.hashMode == HashMode::Reference) {
+                    features.pHash = PHashCalculator::calculatePHash(job.frame);
+                } else if (job.hashMode == HashMode::Fast) {
+                    features.pHash = PHashCalculator::calculatePHashFast(job.frame);
+                }
+                if (job.modelInputMode != ModelInputMode::None) {
+                    features.modelInput = MLClassifier::prepareModelInput(job.frame,
+                                                                          job.modelInputMode == ModelInputMode::Reduced);
+                }
+            }
+        } catch (const std::exception& e) {
+            qWarning() << "SlideWriter: Exception while writing" << job.filePath << ":" << e.what();
+            success = false;
+        } catch (...) {
+            qWarning() << "SlideWriter: Unknown exception while writing" << job.filePath;
+            success = false;
+        }
+        job.frame.release();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            SlideWriteResult& result = m_resultsPerVideo[job.videoIndex];
+            if (success) {
+                result.written++;
+                if (!features.fileName.isEmpty()) {
+                    result.features.append(std::move(features));
+                }
+            } else {
+                result.failed++;
+                result.failedPaths.append(job.filePath);
+            }
+            m_pendingPerVideo[job.videoIndex]--;
+        }
+        m_jobFinished.notify_all();
+    }
+}
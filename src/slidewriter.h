@@ -0,0 +1,127 @@
+#ifndef SLIDEWRITER_H
+#define SLIDEWRITER_H
+
+#include <QString>
+#include <QStringList>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include "slidefeatures.h"
+
+/**
+ * Per-video outcome of asynchronous slide writes
+ */
+struct SlideWriteResult {
+    int written = 0;            // Slides encoded and written successfully
+    int failed = 0;             // Slides that could not be encoded or written
+    QStringList failedPaths;    // Paths of the failed slides
+    QList<SlideFeatures> features;  // Post-processing features of the written slides (if requested)
+};
+
+/**
+ * Asynchronous JPEG writer stage for detected slides
+ *
+ * Slide detection hands selected frames to this stage instead of encoding them
+ * inline, so JPEG encoding and disk I/O overlap with SSIM on the next chunk.
+ * A fixed pool of worker threads drains a bounded job queue; submit() blocks
+ * when the queue is full so encoded-but-unwritten frames cannot pile up.
+ * Frames are held by cv::Mat reference, so no pixel data is copied.
+ * Optionally, post-processing features (pHash, ML input) are computed from the
+ * in-memory frame alongside encoding so the JPEG never has to be decoded again.
+ * The writer is shared by all concurrently processed videos and tracks results per video.
+ */
+class SlideWriter
+{
+public:
+    /**
+     * pHash computed from the in-memory frame, matching the post-processing hash path
+     */
+    enum class HashMode {
+        None,       // No hash
+        Reference,  // PHashCalculator::calculatePHash()
+        Fast        // PHashCalculator::calculatePHashFast()
+    };
+
+    /**
+     * ML classification input computed from the in-memory frame, matching the file decode path
+     */
+    enum class ModelInputMode {
+        None,       // No model input
+        Full,       // Like a full-resolution decode (MLClassifierOptions::reducedDecode off)
+        Reduced     // Like a reduced-resolution JPEG decode (MLClassifierOptions::reducedDecode on)
+    };
+
+    /**
+     * Constructor
+     * @param threadCount Number of encoder threads (at least 1)
+     * @param maxPendingJobs Maximum queued jobs before submit() blocks (0 = 4 per thread)
+     */
+    explicit SlideWriter(int threadCount, int maxPendingJobs = 0);
+
+    /**
+     * Destructor - finishes queued jobs and joins the worker threads
+     */
+    ~SlideWriter();
+
+    SlideWriter(const SlideWriter&) = delete;
+    SlideWriter& operator=(const SlideWriter&) = delete;
+
+    /**
+     * Queue a slide for encoding, blocking while the queue is full
+     * @param videoIndex Video the slide belongs to
+     * @param filePath Destination path (supports Unicode)
+     * @param frame Frame to encode; shared by reference, must not be modified afterwards
+     * @param jpegQuality JPEG quality (1-100)
+     * @param hashMode Also compute the slide's pHash for post-processing with this method
+     * @param modelInputMode Also prepare the slide's ML classification input this way
+     */
+    void submit(int videoIndex, const QString& filePath, const cv::Mat& frame, int jpegQuality,
+                HashMode hashMode = HashMode::None, ModelInputMode modelInputMode = ModelInputMode::None);
+
+    /**
+     * Wait until every slide submitted for a video has been written
+     * @param videoIndex Video to wait for
+     * @return Write results for the video; its bookkeeping is cleared afterwards
+     */
+    SlideWriteResult waitForVideo(int videoIndex);
+
+    /**
+     * Get the number of encoder threads
+     * @return Thread count
+     */
+    int threadCount() const { return static_cast<int>(m_workers.size()); }
+
+private:
+    struct Job {
+        int videoIndex;
+        QString filePath;
+        cv::Mat frame;
+        int jpegQuality;
+        HashMode hashMode;
+        ModelInputMode modelInputMode;
+    };
+
+    /**
+     * Worker thread loop: encode and write queued jobs until shutdown
+     */
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<Job> m_jobs;
+    size_t m_maxPendingJobs;
+    bool m_shutdown;
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;   // Signals workers
+    std::condition_variable m_queueNotFull;   // Signals blocked submitters
+    std::condition_variable m_jobFinished;    // Signals waitForVideo()
+
+    std::unordered_map<int, int> m_pendingPerVideo;             // Queued or in-flight jobs
+    std::unordered_map<int, SlideWriteResult> m_resultsPerVideo;
+};
+
+#endif // SLIDEWRITER_H
@@ -1,18 +1,16 @@
 #include "ssimcalculator.h"
 #include "imageiohelper.h"
 #include "memoryoptimizer.h"
+#include "ssimkernels.h"
+#include "optimizationmanager.h"
 #include <iostream>
 #include <algorithm>
 #include <atomic>
 #include <QTimer>
 #include <cstring>
 
-#if SIMD_AVAILABLE
-    #ifdef __APPLE__
-        #include <Accelerate/Accelerate.h>
-    #elif defined(__x86_64__) || defined(_M_X64)
-        #include <immintrin.h>
-    #endif
+#if SIMD_AVAILABLE && defined(__APPLE__)
+    #include <Accelerate/Accelerate.h>
 #endif
 
 // ============================================================================
@@ -126,6 +124,18 @@ double OptimizedSSIMCalculator::calculateOptimizedSSIM(const cv::Mat& gray1, con
         return 0.0;
     }
 
+    // 8-bit grayscale pairs take the fused single-pass moment kernel
+    SSIMMoments moments;
+    if (SSIMKernels::computeMoments(gray1, gray2, moments)) {
+        double result = moments.globalSSIM(C1, C2);
+
+        // Clamp result to valid SSIM range [0, 1]
+        if (result < 0.0) result = 0.0;
+        if (result > 1.0) result = 1.0;
+
+        return result;
+    }
+
     // Calculate means using SIMD if available, with error handling
     double mean1, mean2, var1, var2, covariance;
 
@@ -335,153 +345,38 @@ double OptimizedSSIMCalculator::calculateCovarianceSIMD(const cv::Mat& gray1, co
 }
 
 #elif defined(__x86_64__) || defined(_M_X64)
-// x86_64 AVX2 optimizations
+// x86_64: exact integer moments from the runtime-dispatched SSIMKernels table
+// (SSE4.2/AVX2/AVX-512 are selected per machine instead of by compiler flags)
 double OptimizedSSIMCalculator::calculateMeanSIMD(const cv::Mat& grayImage) {
-    if (grayImage.type() != CV_8UC1) {
+    SSIMMoments moments;
+    if (!SSIMKernels::computeMoments(grayImage, grayImage, moments)) {
         return calculateMeanFallback(grayImage);
     }
 
-    const uint8_t* data = grayImage.ptr<uint8_t>();
-    const int totalPixels = grayImage.rows * grayImage.cols;
-    const int simdPixels = (totalPixels / 32) * 32; // Process 32 pixels at a time with AVX2
-
-    __m256i sum = _mm256_setzero_si256();
-
-    // Process 32 pixels at a time
-    for (int i = 0; i < simdPixels; i += 32) {
-        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
-
-        // Convert uint8 to uint16 to avoid overflow
-        __m256i pixels_lo = _mm256_unpacklo_epi8(pixels, _mm256_setzero_si256());
-        __m256i pixels_hi = _mm256_unpackhi_epi8(pixels, _mm256_setzero_si256());
-
-        // Add to sum
-        sum = _mm256_add_epi16(sum, pixels_lo);
-        sum = _mm256_add_epi16(sum, pixels_hi);
-    }
-
-    // Extract sum from SIMD register
-    uint16_t sumArray[16];
-    _mm256_storeu_si256(reinterpret_cast<__m256i*>(sumArray), sum);
-
-    uint64_t totalSum = 0;
-    for (int i = 0; i < 16; ++i) {
-        totalSum += sumArray[i];
-    }
-
-    // Process remaining pixels
-    for (int i = simdPixels; i < totalPixels; ++i) {
-        totalSum += data[i];
-    }
-
-    return static_cast<double>(totalSum) / totalPixels;
+    return static_cast<double>(moments.sumX) / moments.count;
 }
 
 double OptimizedSSIMCalculator::calculateVarianceSIMD(const cv::Mat& grayImage, double mean) {
-    if (grayImage.type() != CV_8UC1) {
+    SSIMMoments moments;
+    if (!SSIMKernels::computeMoments(grayImage, grayImage, moments)) {
         return calculateVarianceFallback(grayImage, mean);
     }
 
-    const uint8_t* data = grayImage.ptr<uint8_t>();
-    const int totalPixels = grayImage.rows * grayImage.cols;
-    const int simdPixels = (totalPixels / 32) * 32;
-
-    __m256 meanVec = _mm256_set1_ps(static_cast<float>(mean));
-    __m256 sumVec = _mm256_setzero_ps();
-
-    // Process 8 pixels at a time (converting to float)
-    for (int i = 0; i < simdPixels; i += 8) {
-        // Load 8 uint8 pixels and convert to float
-        __m128i pixels8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i));
-        __m128i pixels16 = _mm_unpacklo_epi8(pixels8, _mm_setzero_si128());
-        __m128i pixels32_lo = _mm_unpacklo_epi16(pixels16, _mm_setzero_si128());
-        __m128i pixels32_hi = _mm_unpackhi_epi16(pixels16, _mm_setzero_si128());
-
-        __m256 pixelsFloat = _mm256_cvtepi32_ps(_mm256_set_m128i(pixels32_hi, pixels32_lo));
-
-        // Subtract mean and square
-        __m256 diff = _mm256_sub_ps(pixelsFloat, meanVec);
-        __m256 squared = _mm256_mul_ps(diff, diff);
-
-        // Add to sum
-        sumVec = _mm256_add_ps(sumVec, squared);
-    }
-
-    // Extract sum from SIMD register
-    float sumArray[8];
-    _mm256_storeu_ps(sumArray, sumVec);
-
-    double totalSum = 0.0;
-    for (int i = 0; i < 8; ++i) {
-        totalSum += sumArray[i];
-    }
-
-    // Process remaining pixels
-    for (int i = simdPixels; i < totalPixels; ++i) {
-        double diff = data[i] - mean;
-        totalSum += diff * diff;
-    }
-
-    return totalSum / totalPixels;
+    // E[(x - m)²] = E[x²] - 2m·E[x] + m²
+    const double n = static_cast<double>(moments.count);
+    return static_cast<double>(moments.sumXX) / n - 2.0 * mean * (static_cast<double>(moments.sumX) / n) + mean * mean;
 }
 
 double OptimizedSSIMCalculator::calculateCovarianceSIMD(const cv::Mat& gray1, const cv::Mat& gray2, double mean1, double mean2) {
-    if (gray1.type() != CV_8UC1 || gray2.type() != CV_8UC1) {
+    SSIMMoments moments;
+    if (!SSIMKernels::computeMoments(gray1, gray2, moments)) {
         return calculateCovarianceFallback(gray1, gray2, mean1, mean2);
     }
 
-    const uint8_t* data1 = gray1.ptr<uint8_t>();
-    const uint8_t* data2 = gray2.ptr<uint8_t>();
-    const int totalPixels = gray1.rows * gray1.cols;
-    const int simdPixels = (totalPixels / 8) * 8;
-
-    __m256 mean1Vec = _mm256_set1_ps(static_cast<float>(mean1));
-    __m256 mean2Vec = _mm256_set1_ps(static_cast<float>(mean2));
-    __m256 sumVec = _mm256_setzero_ps();
-
-    // Process 8 pixels at a time
-    for (int i = 0; i < simdPixels; i += 8) {
-        // Load and convert pixels to float
-        __m128i pixels1_8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data1 + i));
-        __m128i pixels2_8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data2 + i));
-
-        __m128i pixels1_16 = _mm_unpacklo_epi8(pixels1_8, _mm_setzero_si128());
-        __m128i pixels2_16 = _mm_unpacklo_epi8(pixels2_8, _mm_setzero_si128());
-
-        __m128i pixels1_32_lo = _mm_unpacklo_epi16(pixels1_16, _mm_setzero_si128());
-        __m128i pixels1_32_hi = _mm_unpackhi_epi16(pixels1_16, _mm_setzero_si128());
-        __m128i pixels2_32_lo = _mm_unpacklo_epi16(pixels2_16, _mm_setzero_si128());
-        __m128i pixels2_32_hi = _mm_unpackhi_epi16(pixels2_16, _mm_setzero_si128());
-
-        __m256 pixels1Float = _mm256_cvtepi32_ps(_mm256_set_m128i(pixels1_32_hi, pixels1_32_lo));
-        __m256 pixels2Float = _mm256_cvtepi32_ps(_mm256_set_m128i(pixels2_32_hi, pixels2_32_lo));
-
-        // Subtract means and multiply
-        __m256 diff1 = _mm256_sub_ps(pixels1Float, mean1Vec);
-        __m256 diff2 = _mm256_sub_ps(pixels2Float, mean2Vec);
-        __m256 product = _mm256_mul_ps(diff1, diff2);
-
-        // Add to sum
-        sumVec = _mm256_add_ps(sumVec, product);
-    }
-
-    // Extract sum from SIMD register
-    float sumArray[8];
-    _mm256_storeu_ps(sumArray, sumVec);
-
-    double totalSum = 0.0;
-    for (int i = 0; i < 8; ++i) {
-        totalSum += sumArray[i];
-    }
-
-    // Process remaining pixels
-    for (int i = simdPixels; i < totalPixels; ++i) {
-        double diff1 = data1[i] - mean1;
-        double diff2 = data2[i] - mean2;
-        totalSum += diff1 * diff2;
-    }
-
-    return totalSum / totalPixels;
+    // E[(x - m1)(y - m2)] = E[xy] - m2·E[x] - m1·E[y] + m1·m2
+    const double n = static_cast<double>(moments.count);
+    return static_cast<double>(moments.sumXY) / n - mean2 * (static_cast<double>(moments.sumX) / n) -
+           mean1 * (static_cast<double>(moments.sumY) / n) + mean1 * mean2;
 }
 
 #endif // __x86_64__
@@ -533,6 +428,16 @@ SSIMCalculator::SSIMCalculator(QObject* parent) : QObject(parent)
     m_optimizedCalculator->setMemoryPool(m_memoryPool);
 }
 
+void SSIMCalculator::setPairScorer(SSIMCalculatorBase* scorer)
+{
+    m_pairScorer = scorer;
+}
+
+void SSIMCalculator::setTiledScoring(bool enabled)
+{
+    m_tiledScoring = enabled;
+}
+
 double SSIMCalculator::calculateGlobalSSIM(const std::string& img1Path, const std::string& img2Path)
 {
     // Use Unicode-safe helper for image loading
@@ -578,6 +483,26 @@ double SSIMCalculator::calculateGlobalSSIM(const cv::Mat& img1, const cv::Mat& i
         cv::resize(gray2, gray2, gray1.size());
     }
 
+    return calculateSSIMFromGray(gray1, gray2);
+}
+
+double SSIMCalculator::calculateSSIMFromGray(const cv::Mat& gray1, const cv::Mat& gray2)
+{
+    if (m_tiledScoring) {
+        TiledSSIMResult tiled;
+        if (SSIMKernels::computeTiledSSIM(gray1, gray2, SSIMKernels::DEFAULT_TILE_SIZE, C1, C2, tiled)) {
+            return tiled.minSSIM;
+        }
+    } else if (m_pairScorer) {
+        return m_pairScorer->calculateSSIM(gray1, gray2);
+    }
+
+    // One fused pass over both images for 8-bit grayscale pairs
+    SSIMMoments moments;
+    if (SSIMKernels::computeMoments(gray1, gray2, moments)) {
+        return moments.globalSSIM(C1, C2);
+    }
+
     // Calculate means
     double mean1 = calculateMean(gray1);
     double mean2 = calculateMean(gray2);
@@ -742,6 +667,183 @@ std::vector<SSIMResult> SSIMCalculator::calculateMultiThreadedSSIM(const std::ve
     return results;
 }
 
+std::vector<double> SSIMCalculator::calculateConsecutiveSSIM(const std::vector<cv::Mat>& frames,
+                                                          const cv::Mat& previousFrame,
+                                                          bool enableDownsampling,
+                                                          int downsampleWidth,
+                                                          int downsampleHeight,
+                                                          cv::Mat* lastPreprocessed)
+{
+    const int frameCount = static_cast<int>(frames.size());
+    const bool hasPrevious = !previousFrame.empty();
+    const int totalPairs = frameCount - (hasPrevious ? 0 : 1);
+
+    if (frameCount == 0 || totalPairs < 1) {
+        if (lastPreprocessed && frameCount == 1) {
+            *lastPreprocessed = preprocessFrame(frames.front(), enableDownsampling, downsampleWidth, downsampleHeight).clone();
+        }
+        return {};
+    }
+
+    // All frames are scored at one common size: the carried frame's, otherwise the first frame's
+    cv::Size commonSize;
+    if (hasPrevious) {
+        commonSize = previousFrame.size();
+    } else {
+        for (const auto& frame : frames) {
+            if (frame.empty()) {
+                continue;
+            }
+            bool downsample = enableDownsampling && (frame.cols > downsampleWidth || frame.rows > downsampleHeight);
+            commonSize = downsample ? cv::Size(downsampleWidth, downsampleHeight) : frame.size();
+            break;
+        }
+    }
+
+    if (commonSize.area() == 0) {
+        std::cerr << "Warning: No valid frames for consecutive SSIM calculation" << std::endl;
+        return std::vector<double>(totalPairs, 0.0);
+    }
+
+    // Phase 1: preprocess every frame once into one contiguous grayscale buffer
+    cv::Mat buffer = FrameBufferPool::instance().acquireMat(commonSize.height * frameCount, commonSize.width, CV_8UC1);
+    std::vector<cv::Mat> grayFrames;
+    grayFrames.reserve(frameCount + 1);
+
+    if (hasPrevious) {
+        cv::Mat previousGray = previousFrame;
+        if (previousGray.type() != CV_8UC1) {
+            previousGray = convertToGrayscale(previousFrame);
+        }
+        grayFrames.push_back(previousGray);
+    }
+    for (int i = 0; i < frameCount; ++i) {
+        grayFrames.push_back(buffer.rowRange(i * commonSize.height, (i + 1) * commonSize.height));
+    }
+
+    const int frameOffset = hasPrevious ? 1 : 0;
+    std::vector<char> valid(grayFrames.size(), 1);
+    valid[0] = !grayFrames[0].empty();
+
+    runParallelRanges(frameCount, [&](int startIndex, int endIndex) {
+        cv::Mat scratch;
+        for (int i = startIndex; i < endIndex; ++i) {
+            cv::Mat& dst = grayFrames[i + frameOffset];
+            if (!preprocessFrameInto(frames[i], dst, enableDownsampling, downsampleWidth, downsampleHeight, scratch)) {
+                dst.setTo(cv::Scalar(0));
+                valid[i + frameOffset] = 0;
+            }
+        }
+    });
+
+    // Phase 2: score adjacent pairs of preprocessed frames
+    std::vector<double> scores(totalPairs, 0.0);
+    std::atomic<int> completedCount(0);
+    const int progressInterval = std::max(1, std::min(totalPairs / 20, 10));
+
+    auto scorePairs = [&](int startIndex, int endIndex) {
+        for (int i = startIndex; i < endIndex; ++i) {
+            if (valid[i] && valid[i + 1]) {
+                scores[i] = calculateSSIMFromGray(grayFrames[i], grayFrames[i + 1]);
+            }
+
+            int currentCompleted = completedCount.fetch_add(1) + 1;
+            if (currentCompleted % progressInterval == 0 || currentCompleted == totalPairs) {
+                emit calculationProgress(currentCompleted, totalPairs);
+            }
+        }
+    };
+
+    // Backends holding device state (GPU queues) take the pairs one at a time
+    if (m_tiledScoring || !m_pairScorer || m_pairScorer->isThreadSafe()) {
+        runParallelRanges(totalPairs, scorePairs);
+    } else {
+        scorePairs(0, totalPairs);
+    }
+
+    // Copy the last frame out so the caller does not keep the whole buffer alive
+    if (lastPreprocessed) {
+        *lastPreprocessed = grayFrames.back().clone();
+    }
+
+    return scores;
+}
+
+cv::Mat SSIMCalculator::preprocessFrame(const cv::Mat& frame, bool enableDownsampling, int downsampleWidth, int downsampleHeight)
+{
+    cv::Mat processed = enableDownsampling ? downsampleImage(frame, downsampleWidth, downsampleHeight) : frame;
+    return processed.empty() ? cv::Mat() : convertToGrayscale(processed);
+}
+
+bool SSIMCalculator::preprocessFrameInto(const cv::Mat& frame, cv::Mat& dst, bool enableDownsampling,
+                                         int downsampleWidth, int downsampleHeight, cv::Mat& scratch)
+{
+    if (frame.empty()) {
+        return false;
+    }
+
+    const cv::Size targetSize(downsampleWidth, downsampleHeight);
+    cv::Mat source = frame;
+
+    // Same order as calculateGlobalSSIM (downsample, then convert) so scores are unchanged
+    if (enableDownsampling && (frame.cols > downsampleWidth || frame.rows > downsampleHeight)) {
+        if (frame.type() == CV_8UC1 && dst.size() == targetSize) {
+            cv::resize(frame, dst, targetSize, 0, 0, cv::INTER_AREA);
+            return true;
+        }
+        cv::resize(frame, scratch, targetSize, 0, 0, cv::INTER_AREA);
+        source = scratch;
+    }
+
+    // Write straight into the destination view when sizes already match
+    if (source.type() == CV_8UC3 && source.size() == dst.size()) {
+        cv::cvtColor(source, dst, cv::COLOR_BGR2GRAY);
+        return true;
+    }
+
+    cv::Mat gray = convertToGrayscale(source);
+    if (gray.empty() || gray.type() != CV_8UC1) {
+        return false;
+    }
+
+    if (gray.size() == dst.size()) {
+        gray.copyTo(dst);
+    } else {
+        cv::resize(gray, dst, dst.size());
+    }
+    return true;
+}
+
+void SSIMCalculator::runParallelRanges(int count, const std::function<void(int, int)>& func)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    const int numThreads = std::min(getOptimalThreadCount(), count);
+    if (numThreads <= 1) {
+        func(0, count);
+        return;
+    }
+
+    const int itemsPerThread = (count + numThreads - 1) / numThreads; // Ceiling division
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+
+    for (int i = 0; i < numThreads; ++i) {
+        int startIndex = i * itemsPerThread;
+        int endIndex = std::min(startIndex + itemsPerThread, count);
+        if (startIndex >= count) {
+            break;
+        }
+        threads.emplace_back(func, startIndex, endIndex);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 std::vector<double> SSIMCalculator::calculateBatchSSIM(const std::vector<cv::Mat>& frames,
                                                     bool enableDownsampling,
                                                     int downsampleWidth,
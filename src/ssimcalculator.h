@@ -9,6 +9,7 @@
 #include <mutex>
 #include <memory>
 #include <atomic>
+#include <functional>
 #include <QObject>
 #include "memoryoptimizer.h"
 
@@ -16,7 +17,7 @@
     #include <Accelerate/Accelerate.h>
     #define SIMD_AVAILABLE 1
 #elif defined(__x86_64__) || defined(_M_X64)
-    #include <immintrin.h>
+    // Kernels are dispatched at runtime (see ssimkernels.h)
     #define SIMD_AVAILABLE 1
 #else
     #define SIMD_AVAILABLE 0
@@ -25,6 +26,7 @@
 // Forward declarations
 class SSIMMemoryPool;
 class OptimizedSSIMCalculator;
+class SSIMCalculatorBase;
 
 /**
  * Memory pool for SSIM operations to reduce allocation overhead
@@ -131,6 +133,23 @@ class SSIMCalculator : public QObject
 public:
     SSIMCalculator(QObject* parent = nullptr);
 
+    /**
+     * Score preprocessed grayscale pairs with an external backend instead of the built-in kernels
+     * @param scorer Backend owned by the caller (nullptr restores the built-in kernels).
+     *               Pairs are scored serially unless the backend reports isThreadSafe();
+     *               a backend shared with other calculators must serialize its own calls
+     *               (see OptimizationManager::getSharedCalculator()).
+     */
+    void setPairScorer(SSIMCalculatorBase* scorer);
+
+    /**
+     * Switch pair scoring between global SSIM and tiled (local) SSIM.
+     * Tiled scoring returns the lowest tile score, so a change confined to a small
+     * region of an otherwise static frame still lowers the score noticeably.
+     * @param enabled true for tiled SSIM, false for global SSIM
+     */
+    void setTiledScoring(bool enabled);
+
     /**
      * Calculate global SSIM between two images
      * @param img1Path Path to first image
@@ -166,6 +185,35 @@ public:
      */
     std::vector<SSIMResult> calculateMultiThreadedSSIM(const std::vector<SSIMTask>& tasks);
 
+    /**
+     * Calculate SSIM scores between consecutive frames using multi-threading.
+     * Every frame is downsampled and converted to grayscale exactly once into a
+     * contiguous buffer, then adjacent pairs are scored in parallel.
+     * @param frames Frames in timeline order
+     * @param previousFrame Preprocessed frame preceding frames[0] (empty if none)
+     * @param enableDownsampling Whether to enable downsampling
+     * @param downsampleWidth Target width for downsampling
+     * @param downsampleHeight Target height for downsampling
+     * @param lastPreprocessed Receives a copy of the preprocessed last frame (optional)
+     * @return SSIM scores, starting with previousFrame vs frames[0] when previousFrame is set
+     */
+    std::vector<double> calculateConsecutiveSSIM(const std::vector<cv::Mat>& frames,
+                                               const cv::Mat& previousFrame,
+                                               bool enableDownsampling,
+                                               int downsampleWidth,
+                                               int downsampleHeight,
+                                               cv::Mat* lastPreprocessed = nullptr);
+
+    /**
+     * Downsample and convert a frame to grayscale exactly as SSIM scoring does
+     * @param frame Input frame (BGR or grayscale)
+     * @param enableDownsampling Whether to enable downsampling
+     * @param downsampleWidth Target width for downsampling
+     * @param downsampleHeight Target height for downsampling
+     * @return Grayscale frame ready for scoring, or empty Mat on failure
+     */
+    cv::Mat preprocessFrame(const cv::Mat& frame, bool enableDownsampling, int downsampleWidth, int downsampleHeight);
+
     /**
      * Calculate SSIM scores for multiple frames using optimized batch processing
      * @param frames Vector of frames to process
@@ -242,6 +290,34 @@ private:
      */
     double calculateCovariance(const cv::Mat& gray1, const cv::Mat& gray2, double mean1, double mean2);
 
+    /**
+     * Calculate global SSIM between two preprocessed grayscale images of equal size
+     * @param gray1 First grayscale image
+     * @param gray2 Second grayscale image
+     * @return SSIM score
+     */
+    double calculateSSIMFromGray(const cv::Mat& gray1, const cv::Mat& gray2);
+
+    /**
+     * Preprocess a frame into a pre-sized grayscale destination
+     * @param frame Input frame (BGR or grayscale)
+     * @param dst Destination view with the common preprocessed size
+     * @param enableDownsampling Whether to enable downsampling
+     * @param downsampleWidth Target width for downsampling
+     * @param downsampleHeight Target height for downsampling
+     * @param scratch Per-thread scratch buffer for the downsampled color frame
+     * @return false if the frame could not be converted
+     */
+    bool preprocessFrameInto(const cv::Mat& frame, cv::Mat& dst, bool enableDownsampling,
+                             int downsampleWidth, int downsampleHeight, cv::Mat& scratch);
+
+    /**
+     * Run a function over [0, count) split into contiguous ranges across worker threads
+     * @param count Number of items
+     * @param func Function called with (startIndex, endIndex)
+     */
+    void runParallelRanges(int count, const std::function<void(int, int)>& func);
+
     /**
      * Get optimal number of threads for SSIM calculation
      * @return Number of threads (CPU cores - 1, minimum 1)
@@ -273,6 +349,10 @@ private:
     // Optimized calculator and memory pool instances
     std::unique_ptr<OptimizedSSIMCalculator> m_optimizedCalculator;
     std::shared_ptr<SSIMMemoryPool> m_memoryPool;
+
+    // Backend for pair scoring selected by OptimizationManager (not owned)
+    SSIMCalculatorBase* m_pairScorer = nullptr;
+    bool m_tiledScoring = false;
 };
 
 #endif // SSIMCALCULATOR_H
\ No newline at end of file
@@ -0,0 +1,596 @@
+#include "ssimkernels.h"
+#include "platformdetector.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define SSIM_KERNELS_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define SSIM_KERNELS_NEON 1
+#endif
+
+namespace {
+
+// Vector iterations between flushes of the 32-bit square accumulators to 64 bits.
+// Each 32-bit lane gains at most 4 * 255² = 260100 per iteration, so 4096 iterations
+// stay below 2^31 and the sums remain exact.
+constexpr size_t FLUSH_ITERATIONS = 4096;
+
+#if SSIM_KERNELS_X86
+
+SIMD_TARGET("sse4.2")
+uint64_t sumLanesU32x4(__m128i value)
+{
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), value);
+    return static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+ * SSE4.2 kernel: same scheme as the AVX2 kernel on 16 pixels per iteration
+ */
+SIMD_TARGET("sse4.2")
+void momentsSSE42(const uint8_t* x, const uint8_t* y, size_t count, SSIMMoments& moments)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const size_t vectorCount = count & ~static_cast<size_t>(15);
+    __m128i sumX = zero;
+    __m128i sumY = zero;
+    size_t i = 0;
+
+    while (i < vectorCount) {
+        const size_t blockEnd = std::min(vectorCount, i + FLUSH_ITERATIONS * 16);
+        __m128i sumXX = zero;
+        __m128i sumYY = zero;
+        __m128i sumXY = zero;
+
+        for (; i < blockEnd; i += 16) {
+            const __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+            const __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+
+            sumX = _mm_add_epi64(sumX, _mm_sad_epu8(vx, zero));
+            sumY = _mm_add_epi64(sumY, _mm_sad_epu8(vy, zero));
+
+            const __m128i xLo = _mm_unpacklo_epi8(vx, zero);
+            const __m128i xHi = _mm_unpackhi_epi8(vx, zero);
+            const __m128i yLo = _mm_unpacklo_epi8(vy, zero);
+            const __m128i yHi = _mm_unpackhi_epi8(vy, zero);
+
+            sumXX = _mm_add_epi32(sumXX, _mm_add_epi32(_mm_madd_epi16(xLo, xLo), _mm_madd_epi16(xHi, xHi)));
+            sumYY = _mm_add_epi32(sumYY, _mm_add_epi32(_mm_madd_epi16(yLo, yLo), _mm_madd_epi16(yHi, yHi)));
+            sumXY = _mm_add_epi32(sumXY, _mm_add_epi32(_mm_madd_epi16(xLo, yLo), _mm_madd_epi16(xHi, yHi)));
+        }
+
+        moments.sumXX += sumLanesU32x4(sumXX);
+        moments.sumYY += sumLanesU32x4(sumYY);
+        moments.sumXY += sumLanesU32x4(sumXY);
+    }
+
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sumX);
+    moments.sumX += lanes[0] + lanes[1];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sumY);
+    moments.sumY += lanes[0] + lanes[1];
+    moments.count += vectorCount;
+
+    SSIMKernels::momentsScalar(x + vectorCount, y + vectorCount, count - vectorCount, moments);
+}
+
+/**
+ * Add eight zero-extended 16-bit values to eight 32-bit column sums
+ */
+SIMD_TARGET("sse4.2")
+void accumulateColumnsU16x8(uint32_t* sums, __m128i values)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i* lo = reinterpret_cast<__m128i*>(sums);
+    __m128i* hi = reinterpret_cast<__m128i*>(sums + 4);
+    _mm_storeu_si128(lo, _mm_add_epi32(_mm_loadu_si128(lo), _mm_unpacklo_epi16(values, zero)));
+    _mm_storeu_si128(hi, _mm_add_epi32(_mm_loadu_si128(hi), _mm_unpackhi_epi16(values, zero)));
+}
+
+/**
+ * SSE4.2 column kernel: 8 pixels per iteration. Squares of 8-bit values fit in 16 bits,
+ * so the products come from a plain 16-bit multiply before widening.
+ */
+SIMD_TARGET("sse4.2")
+void columnsSSE42(const uint8_t* x, const uint8_t* y, size_t count, const SSIMColumnSums& sums)
+{
+    const size_t vectorCount = count & ~static_cast<size_t>(7);
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        const __m128i vx = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i)));
+        const __m128i vy = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i)));
+
+        accumulateColumnsU16x8(sums.x + i, vx);
+        accumulateColumnsU16x8(sums.y + i, vy);
+        accumulateColumnsU16x8(sums.xx + i, _mm_mullo_epi16(vx, vx));
+        accumulateColumnsU16x8(sums.yy + i, _mm_mullo_epi16(vy, vy));
+        accumulateColumnsU16x8(sums.xy + i, _mm_mullo_epi16(vx, vy));
+    }
+
+    const SSIMColumnSums tail{sums.x + vectorCount, sums.y + vectorCount, sums.xx + vectorCount,
+                              sums.yy + vectorCount, sums.xy + vectorCount};
+    SSIMKernels::columnsScalar(x + vectorCount, y + vectorCount, count - vectorCount, tail);
+}
+
+SIMD_TARGET("avx2")
+uint64_t sumLanesU32(__m256i value)
+{
+    alignas(32) uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), value);
+    uint64_t sum = 0;
+    for (uint32_t lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+
+SIMD_TARGET("avx2")
+uint64_t sumLanesU64(__m256i value)
+{
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), value);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+ * AVX2 kernel: SAD for the plain sums, madd on zero-extended 16-bit pixels for the squares
+ */
+SIMD_TARGET("avx2")
+void momentsAVX2(const uint8_t* x, const uint8_t* y, size_t count, SSIMMoments& moments)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const size_t vectorCount = count & ~static_cast<size_t>(31);
+    __m256i sumX = zero;
+    __m256i sumY = zero;
+    size_t i = 0;
+
+    while (i < vectorCount) {
+        const size_t blockEnd = std::min(vectorCount, i + FLUSH_ITERATIONS * 32);
+        __m256i sumXX = zero;
+        __m256i sumYY = zero;
+        __m256i sumXY = zero;
+
+        for (; i < blockEnd; i += 32) {
+            const __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+            const __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+
+            sumX = _mm256_add_epi64(sumX, _mm256_sad_epu8(vx, zero));
+            sumY = _mm256_add_epi64(sumY, _mm256_sad_epu8(vy, zero));
+
+            const __m256i xLo = _mm256_unpacklo_epi8(vx, zero);
+            const __m256i xHi = _mm256_unpackhi_epi8(vx, zero);
+            const __m256i yLo = _mm256_unpacklo_epi8(vy, zero);
+            const __m256i yHi = _mm256_unpackhi_epi8(vy, zero);
+
+            sumXX = _mm256_add_epi32(sumXX, _mm256_add_epi32(_mm256_madd_epi16(xLo, xLo), _mm256_madd_epi16(xHi, xHi)));
+            sumYY = _mm256_add_epi32(sumYY, _mm256_add_epi32(_mm256_madd_epi16(yLo, yLo), _mm256_madd_epi16(yHi, yHi)));
+            sumXY = _mm256_add_epi32(sumXY, _mm256_add_epi32(_mm256_madd_epi16(xLo, yLo), _mm256_madd_epi16(xHi, yHi)));
+        }
+
+        moments.sumXX += sumLanesU32(sumXX);
+        moments.sumYY += sumLanesU32(sumYY);
+        moments.sumXY += sumLanesU32(sumXY);
+    }
+
+    moments.sumX += sumLanesU64(sumX);
+    moments.sumY += sumLanesU64(sumY);
+    moments.count += vectorCount;
+
+    SSIMKernels::momentsScalar(x + vectorCount, y + vectorCount, count - vectorCount, moments);
+}
+
+/**
+ * Add sixteen 16-bit values to sixteen 32-bit column sums
+ */
+SIMD_TARGET("avx2")
+void accumulateColumnsU16x16(uint32_t* sums, __m256i values)
+{
+    __m256i* lo = reinterpret_cast<__m256i*>(sums);
+    __m256i* hi = reinterpret_cast<__m256i*>(sums + 8);
+    _mm256_storeu_si256(lo, _mm256_add_epi32(_mm256_loadu_si256(lo),
+                                             _mm256_cvtepu16_epi32(_mm256_castsi256_si128(values))));
+    _mm256_storeu_si256(hi, _mm256_add_epi32(_mm256_loadu_si256(hi),
+                                             _mm256_cvtepu16_epi32(_mm256_extracti128_si256(values, 1))));
+}
+
+/**
+ * AVX2 column kernel: 16 pixels per iteration, same scheme as the SSE4.2 column kernel
+ */
+SIMD_TARGET("avx2")
+void columnsAVX2(const uint8_t* x, const uint8_t* y, size_t count, const SSIMColumnSums& sums)
+{
+    const size_t vectorCount = count & ~static_cast<size_t>(15);
+
+    for (size_t i = 0; i < vectorCount; i += 16) {
+        const __m256i vx = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        const __m256i vy = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+
+        accumulateColumnsU16x16(sums.x + i, vx);
+        accumulateColumnsU16x16(sums.y + i, vy);
+        accumulateColumnsU16x16(sums.xx + i, _mm256_mullo_epi16(vx, vx));
+        accumulateColumnsU16x16(sums.yy + i, _mm256_mullo_epi16(vy, vy));
+        accumulateColumnsU16x16(sums.xy + i, _mm256_mullo_epi16(vx, vy));
+    }
+
+    const SSIMColumnSums tail{sums.x + vectorCount, sums.y + vectorCount, sums.xx + vectorCount,
+                              sums.yy + vectorCount, sums.xy + vectorCount};
+    SSIMKernels::columnsScalar(x + vectorCount, y + vectorCount, count - vectorCount, tail);
+}
+
+SIMD_TARGET("avx512f,avx512bw")
+uint64_t sumLanesU32x16(__m512i value)
+{
+    alignas(64) uint32_t lanes[16];
+    _mm512_store_si512(reinterpret_cast<void*>(lanes), value);
+    uint64_t sum = 0;
+    for (uint32_t lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+
+/**
+ * AVX-512 VNNI kernel: vpdpwssd fuses the 16-bit multiply-add with the accumulation
+ */
+SIMD_TARGET("avx512f,avx512bw,avx512vnni")
+void momentsAVX512VNNI(const uint8_t* x, const uint8_t* y, size_t count, SSIMMoments& moments)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const size_t vectorCount = count & ~static_cast<size_t>(63);
+    __m512i sumX = zero;
+    __m512i sumY = zero;
+    size_t i = 0;
+
+    while (i < vectorCount) {
+        const size_t blockEnd = std::min(vectorCount, i + FLUSH_ITERATIONS * 64);
+        __m512i sumXX = zero;
+        __m512i sumYY = zero;
+        __m512i sumXY = zero;
+
+        for (; i < blockEnd; i += 64) {
+            const __m512i vx = _mm512_loadu_si512(reinterpret_cast<const void*>(x + i));
+            const __m512i vy = _mm512_loadu_si512(reinterpret_cast<const void*>(y + i));
+
+            sumX = _mm512_add_epi64(sumX, _mm512_sad_epu8(vx, zero));
+            sumY = _mm512_add_epi64(sumY, _mm512_sad_epu8(vy, zero));
+
+            const __m512i xLo = _mm512_cvtepu8_epi16(_mm512_castsi512_si256(vx));
+            const __m512i xHi = _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(vx, 1));
+            const __m512i yLo = _mm512_cvtepu8_epi16(_mm512_castsi512_si256(vy));
+            const __m512i yHi = _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(vy, 1));
+
+            sumXX = _mm512_dpwssd_epi32(_mm512_dpwssd_epi32(sumXX, xLo, xLo), xHi, xHi);
+            sumYY = _mm512_dpwssd_epi32(_mm512_dpwssd_epi32(sumYY, yLo, yLo), yHi, yHi);
+            sumXY = _mm512_dpwssd_epi32(_mm512_dpwssd_epi32(sumXY, xLo, yLo), xHi, yHi);
+        }
+
+        moments.sumXX += sumLanesU32x16(sumXX);
+        moments.sumYY += sumLanesU32x16(sumYY);
+        moments.sumXY += sumLanesU32x16(sumXY);
+    }
+
+    moments.sumX += static_cast<uint64_t>(_mm512_reduce_add_epi64(sumX));
+    moments.sumY += static_cast<uint64_t>(_mm512_reduce_add_epi64(sumY));
+    moments.count += vectorCount;
+
+    SSIMKernels::momentsScalar(x + vectorCount, y + vectorCount, count - vectorCount, moments);
+}
+
+#endif // SSIM_KERNELS_X86
+
+#if SSIM_KERNELS_NEON
+
+/**
+ * NEON kernel: UDOT when the target has the dot-product extension, widening multiply otherwise
+ */
+void momentsNEON(const uint8_t* x, const uint8_t* y, size_t count, SSIMMoments& moments)
+{
+    const size_t vectorCount = count & ~static_cast<size_t>(15);
+    size_t i = 0;
+
+    while (i < vectorCount) {
+        const size_t blockEnd = std::min(vectorCount, i + FLUSH_ITERATIONS * 16);
+        uint32x4_t sumX = vdupq_n_u32(0);
+        uint32x4_t sumY = vdupq_n_u32(0);
+        uint32x4_t sumXX = vdupq_n_u32(0);
+        uint32x4_t sumYY = vdupq_n_u32(0);
+        uint32x4_t sumXY = vdupq_n_u32(0);
+
+        for (; i < blockEnd; i += 16) {
+            const uint8x16_t vx = vld1q_u8(x + i);
+            const uint8x16_t vy = vld1q_u8(y + i);
+
+#if defined(__ARM_FEATURE_DOTPROD)
+            const uint8x16_t ones = vdupq_n_u8(1);
+            sumX = vdotq_u32(sumX, vx, ones);
+            sumY = vdotq_u32(sumY, vy, ones);
+            sumXX = vdotq_u32(sumXX, vx, vx);
+            sumYY = vdotq_u32(sumYY, vy, vy);
+            sumXY = vdotq_u32(sumXY, vx, vy);
+#else
+            sumX = vpadalq_u16(sumX, vpaddlq_u8(vx));
+            sumY = vpadalq_u16(sumY, vpaddlq_u8(vy));
+            sumXX = vpadalq_u16(sumXX, vmull_u8(vget_low_u8(vx), vget_low_u8(vx)));
+            sumXX = vpadalq_u16(sumXX, vmull_high_u8(vx, vx));
+            sumYY = vpadalq_u16(sumYY, vmull_u8(vget_low_u8(vy), vget_low_u8(vy)));
+            sumYY = vpadalq_u16(sumYY, vmull_high_u8(vy, vy));
+            sumXY = vpadalq_u16(sumXY, vmull_u8(vget_low_u8(vx), vget_low_u8(vy)));
+            sumXY = vpadalq_u16(sumXY, vmull_high_u8(vx, vy));
+#endif
+        }
+
+        moments.sumX += vaddlvq_u32(sumX);
+        moments.sumY += vaddlvq_u32(sumY);
+        moments.sumXX += vaddlvq_u32(sumXX);
+        moments.sumYY += vaddlvq_u32(sumYY);
+        moments.sumXY += vaddlvq_u32(sumXY);
+    }
+
+    moments.count += vectorCount;
+
+    SSIMKernels::momentsScalar(x + vectorCount, y + vectorCount, count - vectorCount, moments);
+}
+
+/**
+ * Add eight 16-bit values to eight 32-bit column sums
+ */
+inline void accumulateColumnsU16x8(uint32_t* sums, uint16x8_t values)
+{
+    vst1q_u32(sums, vaddw_u16(vld1q_u32(sums), vget_low_u16(values)));
+    vst1q_u32(sums + 4, vaddw_high_u16(vld1q_u32(sums + 4), values));
+}
+
+/**
+ * NEON column kernel: 8 pixels per iteration with widening adds into the column sums
+ */
+void columnsNEON(const uint8_t* x, const uint8_t* y, size_t count, const SSIMColumnSums& sums)
+{
+    const size_t vectorCount = count & ~static_cast<size_t>(7);
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        const uint8x8_t vx = vld1_u8(x + i);
+        const uint8x8_t vy = vld1_u8(y + i);
+
+        accumulateColumnsU16x8(sums.x + i, vmovl_u8(vx));
+        accumulateColumnsU16x8(sums.y + i, vmovl_u8(vy));
+        accumulateColumnsU16x8(sums.xx + i, vmull_u8(vx, vx));
+        accumulateColumnsU16x8(sums.yy + i, vmull_u8(vy, vy));
+        accumulateColumnsU16x8(sums.xy + i, vmull_u8(vx, vy));
+    }
+
+    const SSIMColumnSums tail{sums.x + vectorCount, sums.y + vectorCount, sums.xx + vectorCount,
+                              sums.yy + vectorCount, sums.xy + vectorCount};
+    SSIMKernels::columnsScalar(x + vectorCount, y + vectorCount, count - vectorCount, tail);
+}
+
+#endif // SSIM_KERNELS_NEON
+
+/**
+ * Rank instruction sets by the widest moments kernel they can run
+ */
+int kernelLevel(SIMDInstructionSet instructionSet)
+{
+    switch (instructionSet) {
+        case SIMDInstructionSet::NEON:
+        case SIMDInstructionSet::SSE4_2:
+        case SIMDInstructionSet::AVX:
+            return 1;
+        case SIMDInstructionSet::AVX2:
+            return 2;
+        case SIMDInstructionSet::AVX512F:
+        case SIMDInstructionSet::AVX512BW:
+        case SIMDInstructionSet::AVX512VL:
+        case SIMDInstructionSet::AVX512VNNI:
+        case SIMDInstructionSet::AVX512VPOPCNTDQ:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+SSIMKernelTable buildKernelTable(int maxLevel)
+{
+    const PlatformDetector& detector = PlatformDetector::getInstance();
+    SSIMKernelTable table{SSIMKernels::momentsScalar, SSIMKernels::columnsScalar, SIMDInstructionSet::None, "Scalar"};
+
+#if SSIM_KERNELS_X86
+    if (maxLevel >= 3 &&
+        detector.isSIMDSupported(SIMDInstructionSet::AVX512BW) &&
+        detector.isSIMDSupported(SIMDInstructionSet::AVX512VNNI)) {
+        table = {momentsAVX512VNNI, columnsAVX2, SIMDInstructionSet::AVX512VNNI, "AVX-512 VNNI"};
+    } else if (maxLevel >= 2 && detector.isSIMDSupported(SIMDInstructionSet::AVX2)) {
+        table = {momentsAVX2, columnsAVX2, SIMDInstructionSet::AVX2, "AVX2"};
+    } else if (maxLevel >= 1 && detector.isSIMDSupported(SIMDInstructionSet::SSE4_2)) {
+        table = {momentsSSE42, columnsSSE42, SIMDInstructionSet::SSE4_2, "SSE4.2"};
+    }
+#elif SSIM_KERNELS_NEON
+    if (maxLevel >= 1 && detector.isSIMDSupported(SIMDInstructionSet::NEON)) {
+        table = {momentsNEON, columnsNEON, SIMDInstructionSet::NEON, "NEON"};
+    }
+#else
+    (void)detector;
+    (void)maxLevel;
+#endif
+
+    return table;
+}
+
+} // namespace
+
+double SSIMMoments::globalSSIM(double c1, double c2) const
+{
+    if (count == 0) {
+        return 0.0;
+    }
+
+    // Exact integer sums make every derived statistic independent of the kernel used
+    const double n = static_cast<double>(count);
+    const double mean1 = static_cast<double>(sumX) / n;
+    const double mean2 = static_cast<double>(sumY) / n;
+    const double var1 = static_cast<double>(sumXX) / n - mean1 * mean1;
+    const double var2 = static_cast<double>(sumYY) / n - mean2 * mean2;
+    const double covariance = static_cast<double>(sumXY) / n - mean1 * mean2;
+
+    const double numerator = (2 * mean1 * mean2 + c1) * (2 * covariance + c2);
+    const double denominator = (mean1 * mean1 + mean2 * mean2 + c1) * (var1 + var2 + c2);
+
+    if (denominator == 0.0) {
+        return 1.0; // Perfect similarity when both images are uniform
+    }
+
+    return numerator / denominator;
+}
+
+bool SSIMKernels::computeMoments(const cv::Mat& gray1, const cv::Mat& gray2, SSIMMoments& moments)
+{
+    return computeMoments(gray1, gray2, moments, momentsKernel());
+}
+
+bool SSIMKernels::computeMoments(const cv::Mat& gray1, const cv::Mat& gray2, SSIMMoments& moments,
+                                 MomentsFunction kernel)
+{
+    moments = SSIMMoments();
+
+    if (gray1.empty() || gray2.empty() || gray1.size() != gray2.size() ||
+        gray1.type() != CV_8UC1 || gray2.type() != CV_8UC1) {
+        return false;
+    }
+
+    if (gray1.isContinuous() && gray2.isContinuous()) {
+        kernel(gray1.ptr<uint8_t>(), gray2.ptr<uint8_t>(), gray1.total(), moments);
+    } else {
+        for (int row = 0; row < gray1.rows; ++row) {
+            kernel(gray1.ptr<uint8_t>(row), gray2.ptr<uint8_t>(row), static_cast<size_t>(gray1.cols), moments);
+        }
+    }
+
+    return true;
+}
+
+const SSIMKernelTable& SSIMKernels::table()
+{
+    // Built once, on first use or from initialize() at startup
+    static const SSIMKernelTable kernelTable = buildKernelTable(kernelLevel(SIMDInstructionSet::AVX512VNNI));
+    return kernelTable;
+}
+
+SSIMKernelTable SSIMKernels::tableFor(SIMDInstructionSet instructionSet)
+{
+    return buildKernelTable(kernelLevel(instructionSet));
+}
+
+void SSIMKernels::initialize()
+{
+    std::cerr << "SSIMKernels: Using " << table().name << " kernels" << std::endl;
+}
+
+SSIMKernels::MomentsFunction SSIMKernels::momentsKernel()
+{
+    return table().moments;
+}
+
+const char* SSIMKernels::momentsKernelName()
+{
+    return table().name;
+}
+
+void SSIMKernels::momentsScalar(const uint8_t* x, const uint8_t* y, size_t count, SSIMMoments& moments)
+{
+    uint64_t sumX = 0, sumY = 0, sumXX = 0, sumYY = 0, sumXY = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t a = x[i];
+        const uint32_t b = y[i];
+        sumX += a;
+        sumY += b;
+        sumXX += a * a;
+        sumYY += b * b;
+        sumXY += a * b;
+    }
+
+    moments.sumX += sumX;
+    moments.sumY += sumY;
+    moments.sumXX += sumXX;
+    moments.sumYY += sumYY;
+    moments.sumXY += sumXY;
+    moments.count += count;
+}
+
+void SSIMKernels::columnsScalar(const uint8_t* x, const uint8_t* y, size_t count, const SSIMColumnSums& sums)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t a = x[i];
+        const uint32_t b = y[i];
+        sums.x[i] += a;
+        sums.y[i] += b;
+        sums.xx[i] += a * a;
+        sums.yy[i] += b * b;
+        sums.xy[i] += a * b;
+    }
+}
+
+bool SSIMKernels::computeTiledSSIM(const cv::Mat& gray1, const cv::Mat& gray2, int tileSize,
+                                   double c1, double c2, TiledSSIMResult& result)
+{
+    result = TiledSSIMResult();
+
+    if (gray1.empty() || gray2.empty() || gray1.size() != gray2.size() ||
+        gray1.type() != CV_8UC1 || gray2.type() != CV_8UC1 ||
+        tileSize < 1 || tileSize > MAX_TILE_SIZE) {
+        return false;
+    }
+
+    // Split each axis into equal tiles of roughly tileSize pixels so no sliver tile is left at the edge
+    const int width = gray1.cols;
+    const int height = gray1.rows;
+    const int tilesX = std::max(1, (width + tileSize / 2) / tileSize);
+    const int tilesY = std::max(1, (height + tileSize / 2) / tileSize);
+
+    const SSIMColumnFunction accumulate = table().columns;
+    std::vector<uint32_t> columnSums(static_cast<size_t>(width) * 5);
+    const SSIMColumnSums sums{columnSums.data(), columnSums.data() + width, columnSums.data() + 2 * width,
+                              columnSums.data() + 3 * width, columnSums.data() + 4 * width};
+
+    double ssimSum = 0.0;
+    double minSSIM = 1.0;
+
+    for (int tileY = 0; tileY < tilesY; ++tileY) {
+        const int rowBegin = tileY * height / tilesY;
+        const int rowEnd = (tileY + 1) * height / tilesY;
+
+        // Box-filter one band of tile rows: per-column sums over the band's rows
+        std::fill(columnSums.begin(), columnSums.end(), 0u);
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            accumulate(gray1.ptr<uint8_t>(row), gray2.ptr<uint8_t>(row), static_cast<size_t>(width), sums);
+        }
+
+        for (int tileX = 0; tileX < tilesX; ++tileX) {
+            const int colBegin = tileX * width / tilesX;
+            const int colEnd = (tileX + 1) * width / tilesX;
+
+            SSIMMoments moments;
+            for (int col = colBegin; col < colEnd; ++col) {
+                moments.sumX += sums.x[col];
+                moments.sumY += sums.y[col];
+                moments.sumXX += sums.xx[col];
+                moments.sumYY += sums.yy[col];
+                moments.sumXY += sums.xy[col];
+            }
+            moments.count = static_cast<uint64_t>(colEnd - colBegin) * static_cast<uint64_t>(rowEnd - rowBegin);
+
+            const double ssim = moments.globalSSIM(c1, c2);
+            ssimSum += ssim;
+            minSSIM = std::min(minSSIM, ssim);
+        }
+    }
+
+    result.tileCount = tilesX * tilesY;
+    result.meanSSIM = ssimSum / result.tileCount;
+    result.minSSIM = minSSIM;
+    return true;
+}
@@ -0,0 +1,168 @@
+#ifndef SSIMKERNELS_H
+#define SSIMKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include "platformdetector.h"
+
+/**
+ * First and second order pixel moments of an 8-bit image pair.
+ * All sums are exact integers, so statistics derived from them are bit-stable
+ * regardless of which kernel produced them.
+ */
+struct SSIMMoments {
+    uint64_t sumX = 0;      // Σx
+    uint64_t sumY = 0;      // Σy
+    uint64_t sumXX = 0;     // Σx²
+    uint64_t sumYY = 0;     // Σy²
+    uint64_t sumXY = 0;     // Σxy
+    uint64_t count = 0;     // Number of pixels
+
+    /**
+     * Calculate global SSIM from the accumulated moments
+     * @param c1 Luminance stabilization constant
+     * @param c2 Contrast stabilization constant
+     * @return SSIM score (unclamped), or 1.0 for two uniform images
+     */
+    double globalSSIM(double c1, double c2) const;
+};
+
+/**
+ * Kernel signature: accumulate the moments of `count` pixel pairs into `moments`
+ */
+using SSIMMomentsFunction = void (*)(const uint8_t* x, const uint8_t* y, size_t count, SSIMMoments& moments);
+
+/**
+ * Per-column 32-bit moment sums of one band of rows, one array per moment
+ */
+struct SSIMColumnSums {
+    uint32_t* x;
+    uint32_t* y;
+    uint32_t* xx;
+    uint32_t* yy;
+    uint32_t* xy;
+};
+
+/**
+ * Kernel signature: add one row of `count` pixel pairs to the per-column sums
+ */
+using SSIMColumnFunction = void (*)(const uint8_t* x, const uint8_t* y, size_t count, const SSIMColumnSums& sums);
+
+/**
+ * Scores of a tiled (local) SSIM comparison
+ */
+struct TiledSSIMResult {
+    double meanSSIM = 0.0;  // Mean of the tile scores
+    double minSSIM = 0.0;   // Lowest tile score
+    int tileCount = 0;      // Number of tiles compared
+};
+
+/**
+ * Kernels selected for the running CPU
+ */
+struct SSIMKernelTable {
+    SSIMMomentsFunction moments;            // Fused moments kernel
+    SSIMColumnFunction columns;             // Per-column sums for tiled SSIM
+    SIMDInstructionSet instructionSet;      // Instruction set the kernels were compiled for
+    const char* name;                       // Human-readable kernel name
+};
+
+/**
+ * Fused single-pass moment kernels for global SSIM.
+ *
+ * One pass over both images accumulates Σx, Σy, Σx², Σy² and Σxy in integer
+ * registers; the tiled variant keeps the same sums per column and tile. Every
+ * variant (AVX-512 VNNI, AVX2, SSE4.2, NEON, scalar) is compiled into the binary
+ * with per-function target attributes; the dispatch table is built once from the
+ * instruction sets reported by PlatformDetector.
+ */
+class SSIMKernels {
+public:
+    using MomentsFunction = SSIMMomentsFunction;
+
+    /**
+     * Build the dispatch table and log the selection. Call at startup, before
+     * worker threads run; later calls are no-ops apart from the log line.
+     */
+    static void initialize();
+
+    /**
+     * Get the dispatch table for this machine
+     * @return Kernel table
+     */
+    static const SSIMKernelTable& table();
+
+    /**
+     * Get the fastest kernels this CPU supports that need no more than the given
+     * instruction set, e.g. AVX2 yields the AVX2 kernel even on AVX-512 hardware
+     * @param instructionSet Widest instruction set the kernels may use
+     * @return Kernel table (scalar if nothing better qualifies)
+     */
+    static SSIMKernelTable tableFor(SIMDInstructionSet instructionSet);
+
+    /**
+     * Compute the moments of two CV_8UC1 images of equal size
+     * @param gray1 First grayscale image
+     * @param gray2 Second grayscale image
+     * @param moments Receives the moments
+     * @return false if the images are empty, not CV_8UC1 or differ in size
+     */
+    static bool computeMoments(const cv::Mat& gray1, const cv::Mat& gray2, SSIMMoments& moments);
+
+    /**
+     * Compute the moments of two CV_8UC1 images of equal size with a specific kernel
+     * @param gray1 First grayscale image
+     * @param gray2 Second grayscale image
+     * @param moments Receives the moments
+     * @param kernel Moments kernel to run
+     * @return false if the images are empty, not CV_8UC1 or differ in size
+     */
+    static bool computeMoments(const cv::Mat& gray1, const cv::Mat& gray2, SSIMMoments& moments,
+                               MomentsFunction kernel);
+
+    /**
+     * Compute SSIM per tile of two CV_8UC1 images of equal size. Each axis is split into
+     * equal tiles of about tileSize pixels; tile moments come from per-column sums over
+     * each band of rows (a box filter over non-overlapping tiles).
+     * @param gray1 First grayscale image
+     * @param gray2 Second grayscale image
+     * @param tileSize Target tile edge length in pixels (1 to MAX_TILE_SIZE)
+     * @param c1 Luminance stabilization constant
+     * @param c2 Contrast stabilization constant
+     * @param result Receives the mean and minimum tile SSIM
+     * @return false if the images are empty, not CV_8UC1, differ in size or tileSize is out of range
+     */
+    static bool computeTiledSSIM(const cv::Mat& gray1, const cv::Mat& gray2, int tileSize,
+                                 double c1, double c2, TiledSSIMResult& result);
+
+    /**
+     * Get the kernel selected for this machine
+     * @return Moments kernel function
+     */
+    static MomentsFunction momentsKernel();
+
+    /**
+     * Get the name of the selected kernel for logging
+     * @return Kernel name, e.g. "AVX2"
+     */
+    static const char* momentsKernelName();
+
+    /**
+     * Portable reference kernel, also used for the tails of the SIMD kernels
+     */
+    static void momentsScalar(const uint8_t* x, const uint8_t* y, size_t count, SSIMMoments& moments);
+
+    /**
+     * Portable column kernel, also used for the tails of the SIMD column kernels
+     */
+    static void columnsScalar(const uint8_t* x, const uint8_t* y, size_t count, const SSIMColumnSums& sums);
+
+    // Tile edge used for detection: 30x17 tiles at the default 480x270 downsample size
+    static constexpr int DEFAULT_TILE_SIZE = 16;
+
+    // Largest tile edge whose 32-bit column sums of squares cannot overflow
+    static constexpr int MAX_TILE_SIZE = 4096;
+};
+
+#endif // SSIMKERNELS_H
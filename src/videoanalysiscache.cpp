@@ -0,0 +1,154 @@
+#include "videoanalysiscache.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <algorithm>
+
+VideoAnalysisCache::VideoAnalysisCache(const QString& videoPath)
+    : m_videoInfo(videoPath)
+{
+}
+
+QString VideoAnalysisCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/videoAnalysis";
+}
+
+QString VideoAnalysisCache::cacheFilePath() const
+{
+    QByteArray pathHash = QCryptographicHash::hash(m_videoInfo.absoluteFilePath().toUtf8(),
+                                                   QCryptographicHash::Sha1);
+    return cacheDirectory() + "/" + QString::fromLatin1(pathHash.toHex()) + ".vac";
+}
+
+QByteArray VideoAnalysisCache::fingerprint()
+{
+    if (!m_fingerprint.isEmpty()) {
+        return m_fingerprint;
+    }
+
+    QFile file(m_videoInfo.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    // Head and tail catch re-encodes and remuxes that keep the size and timestamp
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const qint64 size = file.size();
+    hash.addData(QByteArray::number(size));
+    hash.addData(file.read(FINGERPRINT_BYTES));
+    if (size > FINGERPRINT_BYTES && file.seek(std::max(FINGERPRINT_BYTES, size - FINGERPRINT_BYTES))) {
+        hash.addData(file.read(FINGERPRINT_BYTES));
+    }
+
+    m_fingerprint = hash.result();
+    return m_fingerprint;
+}
+
+bool VideoAnalysisCache::load(HardwareDecoder::VideoAnalysis& analysis)
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0, version = 0;
+    QString videoPath;
+    qint64 size = 0, modifiedMs = 0;
+    QByteArray storedFingerprint;
+    in >> magic >> version >> videoPath >> size >> modifiedMs >> storedFingerprint;
+    if (in.status() != QDataStream::Ok || magic != FILE_MAGIC || version != FORMAT_VERSION) {
+        return false;
+    }
+
+    // Cheap checks first; the fingerprint reads from the video
+    if (videoPath != m_videoInfo.absoluteFilePath() || size != m_videoInfo.size() ||
+        modifiedMs != m_videoInfo.lastModified().toMSecsSinceEpoch() ||
+        storedFingerprint != fingerprint()) {
+        return false;
+    }
+
+    HardwareDecoder::VideoAnalysis cached;
+    QString codecName;
+    qint32 width = 0, height = 0, codecId = 0;
+    quint32 keyframeCount = 0;
+    in >> cached.info.duration >> cached.info.frameRate >> width >> height
+       >> cached.info.avgIFrameInterval >> cached.info.isScreenRecording >> codecName
+       >> codecId >> cached.keyframeIndexComplete >> keyframeCount;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "VideoAnalysisCache: Discarding truncated cache file" << file.fileName();
+        return false;
+    }
+
+    // A partial index would restrict every later run to the scanned part of the video
+    if (!cached.keyframeIndexComplete || keyframeCount == 0) {
+        qWarning() << "VideoAnalysisCache: Discarding incomplete analysis" << file.fileName();
+        return false;
+    }
+
+    cached.info.width = width;
+    cached.info.height = height;
+    cached.info.codecName = codecName.toStdString();
+    cached.codecId = codecId;
+
+    cached.keyframeIndex.reserve(keyframeCount);
+    for (quint32 i = 0; i < keyframeCount; i++) {
+        qint64 keyframe = 0;
+        in >> keyframe;
+        cached.keyframeIndex.push_back(keyframe);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "VideoAnalysisCache: Discarding truncated cache file" << file.fileName();
+        return false;
+    }
+
+    analysis = std::move(cached);
+    return true;
+}
+
+bool VideoAnalysisCache::save(const HardwareDecoder::VideoAnalysis& analysis)
+{
+    if (!analysis.keyframeIndexComplete || analysis.keyframeIndex.empty()) {
+        return false;
+    }
+
+    QByteArray videoFingerprint = fingerprint();
+    if (videoFingerprint.isEmpty() || !QDir().mkpath(cacheDirectory())) {
+        return false;
+    }
+
+    QSaveFile file(cacheFilePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "VideoAnalysisCache: Failed to open cache file for writing:" << file.fileName();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << FILE_MAGIC << FORMAT_VERSION << m_videoInfo.absoluteFilePath()
+        << m_videoInfo.size() << m_videoInfo.lastModified().toMSecsSinceEpoch() << videoFingerprint;
+
+    const HardwareDecoder::VideoInfo& info = analysis.info;
+    out << info.duration << info.frameRate << static_cast<qint32>(info.width) << static_cast<qint32>(info.height)
+        << info.avgIFrameInterval << info.isScreenRecording << QString::fromStdString(info.codecName)
+        << static_cast<qint32>(analysis.codecId) << analysis.keyframeIndexComplete
+        << static_cast<quint32>(analysis.keyframeIndex.size());
+    for (int64_t keyframe : analysis.keyframeIndex) {
+        out << static_cast<qint64>(keyframe);
+    }
+
+    if (!file.commit()) {
+        qWarning() << "VideoAnalysisCache: Failed to write cache file:" << file.fileName();
+        return false;
+    }
+
+    return true;
+}
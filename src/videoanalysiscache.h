@@ -0,0 +1,72 @@
+#ifndef VIDEOANALYSISCACHE_H
+#define VIDEOANALYSISCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFileInfo>
+#include "hardwaredecoder.h"
+
+/**
+ * @brief Persistent cache of per-video analysis results
+ *
+ * Stores the stream info, I-frame interval statistics and keyframe index that
+ * HardwareDecoder::openVideo() gathers by probing and scanning a video, so
+ * re-running the same videos (e.g. while tuning SSIM thresholds) skips the
+ * analysis. Each video gets a small binary file in the application cache
+ * directory rather than a sidecar next to the video, which may live on
+ * read-only or network storage. Entries are validated against the video's
+ * size, modification time and a hash of its first and last bytes.
+ */
+class VideoAnalysisCache
+{
+public:
+    /**
+     * @brief Constructor
+     * @param videoPath Video file the cached analysis belongs to
+     */
+    explicit VideoAnalysisCache(const QString& videoPath);
+
+    /**
+     * @brief Load the cached analysis of the video
+     * @param analysis Output analysis
+     * @return true if a complete analysis of this exact file version is cached
+     */
+    bool load(HardwareDecoder::VideoAnalysis& analysis);
+
+    /**
+     * @brief Store the analysis of the video, replacing any older entry
+     * Analyses whose keyframe index does not cover the whole stream are not stored, since
+     * the cache is only invalidated when the video file changes.
+     * @param analysis Analysis to store
+     * @return true if saved successfully
+     */
+    bool save(const HardwareDecoder::VideoAnalysis& analysis);
+
+    /**
+     * @brief Get the cache file path of the video
+     * @return Path of the cache file
+     */
+    QString cacheFilePath() const;
+
+    /**
+     * @brief Get the directory holding all video analysis cache files
+     * @return Cache directory path
+     */
+    static QString cacheDirectory();
+
+private:
+    /**
+     * @brief Hash the size and the first and last bytes of the video
+     * @return SHA-1 fingerprint, empty if the file cannot be read
+     */
+    QByteArray fingerprint();
+
+    QFileInfo m_videoInfo;
+    QByteArray m_fingerprint;   // Computed on first use
+
+    static constexpr quint32 FILE_MAGIC = 0x56414331;       // "VAC1"
+    static constexpr quint32 FORMAT_VERSION = 2;   // 2: keyframe index completeness flag
+    static constexpr qint64 FINGERPRINT_BYTES = 64 * 1024;  // Hashed at each end of the file
+};
+
+#endif // VIDEOANALYSISCACHE_H
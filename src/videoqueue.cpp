@@ -1,5 +1,6 @@
 #include "videoqueue.h"
 #include <QFileInfo>
+#include <QMutexLocker>
 #include <algorithm>
 
 VideoQueue::VideoQueue(QObject *parent)
@@ -15,16 +16,21 @@ int VideoQueue::addVideo(const QString& filePath)
         return -1;
     }
 
-    // Check if video is already in queue
-    for (const auto& video : m_videos) {
-        if (video.filePath == filePath) {
-            return -1; // Already exists
+    int index;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // Check if video is already in queue
+        for (const auto& video : m_videos) {
+            if (video.filePath == filePath) {
+                return -1; // Already exists
+            }
         }
-    }
 
-    // Add to queue
-    m_videos.emplace_back(filePath);
-    int index = static_cast<int>(m_videos.size() - 1);
+        // Add to queue
+        m_videos.emplace_back(filePath);
+        index = static_cast<int>(m_videos.size() - 1);
+    }
 
     emit videoAdded(index);
     return index;
@@ -32,53 +38,86 @@ int VideoQueue::addVideo(const QString& filePath)
 
 bool VideoQueue::removeVideo(int index)
 {
-    if (index < 0 || index >= static_cast<int>(m_videos.size())) {
-        return false;
-    }
+    {
+        QMutexLocker locker(&m_mutex);
+        if (index < 0 || index >= static_cast<int>(m_videos.size())) {
+            return false;
+        }
 
-    // Don't allow removal of currently processing videos
-    ProcessingStatus status = m_videos[index].status;
-    if (status == ProcessingStatus::FFmpegHandling ||
-        status == ProcessingStatus::SSIMCalculating ||
-        status == ProcessingStatus::ImageProcessing) {
-        return false;
-    }
+        // Don't allow removal of currently processing videos
+        ProcessingStatus status = m_videos[index].status;
+        if (status == ProcessingStatus::FFmpegHandling ||
+            status == ProcessingStatus::SSIMCalculating ||
+            status == ProcessingStatus::ImageProcessing) {
+            return false;
+        }
 
-    m_videos.erase(m_videos.begin() + index);
+        m_videos.erase(m_videos.begin() + index);
+    }
     emit videoRemoved(index);
     return true;
 }
 
 VideoQueueItem* VideoQueue::getVideo(int index)
 {
+    QMutexLocker locker(&m_mutex);
     if (index < 0 || index >= static_cast<int>(m_videos.size())) {
         return nullptr;
     }
     return &m_videos[index];
 }
 
-const std::vector<VideoQueueItem>& VideoQueue::getAllVideos() const
+QString VideoQueue::getFilePath(int index) const
 {
+    QMutexLocker locker(&m_mutex);
+    if (index < 0 || index >= static_cast<int>(m_videos.size())) {
+        return QString();
+    }
+    return m_videos[index].filePath;
+}
+
+void VideoQueue::setOutputDirectory(int index, const QString& outputDirectory)
+{
+    QMutexLocker locker(&m_mutex);
+    if (index < 0 || index >= static_cast<int>(m_videos.size())) {
+        return;
+    }
+    m_videos[index].outputDirectory = outputDirectory;
+}
+
+std::vector<VideoQueueItem> VideoQueue::getAllVideos() const
+{
+    QMutexLocker locker(&m_mutex);
     return m_videos;
 }
 
 int VideoQueue::size() const
 {
+    QMutexLocker locker(&m_mutex);
     return static_cast<int>(m_videos.size());
 }
 
 bool VideoQueue::isEmpty() const
 {
+    QMutexLocker locker(&m_mutex);
     return m_videos.empty();
 }
 
 void VideoQueue::updateStatus(int index, ProcessingStatus status)
 {
-    if (index < 0 || index >= static_cast<int>(m_videos.size())) {
-        return;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (index < 0 || index >= static_cast<int>(m_videos.size())) {
+            return;
+        }
+        applyStatus(m_videos[index], status);
     }
 
-    VideoQueueItem& video = m_videos[index];
+    emit statusChanged(index, status);
+}
+
+void VideoQueue::applyStatus(VideoQueueItem& video, ProcessingStatus status)
+{
     video.status = status;
 
     // Update timestamps
@@ -90,38 +129,51 @@ void VideoQueue::updateStatus(int index, ProcessingStatus status)
             video.processingTimeSeconds = video.startTime.msecsTo(video.endTime) / 1000.0;
         }
     }
-
-    emit statusChanged(index, status);
 }
 
 void VideoQueue::updateStatistics(int index, int extractedSlides, double processingTime)
 {
-    if (index < 0 || index >= static_cast<int>(m_videos.size())) {
-        return;
-    }
+    {
+        QMutexLocker locker(&m_mutex);
+        if (index < 0 || index >= static_cast<int>(m_videos.size())) {
+            return;
+        }
 
-    VideoQueueItem& video = m_videos[index];
-    video.extractedSlides = extractedSlides;
-    if (processingTime > 0) {
-        video.processingTimeSeconds = processingTime;
+        VideoQueueItem& video = m_videos[index];
+        video.extractedSlides = extractedSlides;
+        if (processingTime > 0) {
+            video.processingTimeSeconds = processingTime;
+        }
     }
 
     emit statisticsUpdated(index);
 }
 
-void VideoQueue::setError(int index, const QString& errorMessage)
+void VideoQueue::setSlideWriteFailures(int index, int failures)
 {
-    if (index < 0 || index >= static_cast<int>(m_videos.size())) {
-        return;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (index < 0 || index >= static_cast<int>(m_videos.size())) {
+            return;
+        }
+
+        m_videos[index].slideWriteFailures = failures;
     }
 
-    VideoQueueItem& video = m_videos[index];
-    video.status = ProcessingStatus::Error;
-    video.errorMessage = errorMessage;
-    video.endTime = QDateTime::currentDateTime();
+    emit statisticsUpdated(index);
+}
+
+void VideoQueue::setError(int index, const QString& errorMessage)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (index < 0 || index >= static_cast<int>(m_videos.size())) {
+            return;
+        }
 
-    if (!video.startTime.isNull()) {
-        video.processingTimeSeconds = video.startTime.msecsTo(video.endTime) / 1000.0;
+        VideoQueueItem& video = m_videos[index];
+        video.errorMessage = errorMessage;
+        applyStatus(video, ProcessingStatus::Error);
     }
 
     emit statusChanged(index, ProcessingStatus::Error);
@@ -129,29 +181,39 @@ void VideoQueue::setError(int index, const QString& errorMessage)
 
 void VideoQueue::clearCompleted()
 {
-    auto it = std::remove_if(m_videos.begin(), m_videos.end(),
-        [](const VideoQueueItem& video) {
-            return video.status == ProcessingStatus::Completed ||
-                   video.status == ProcessingStatus::Error;
-        });
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = std::remove_if(m_videos.begin(), m_videos.end(),
+            [](const VideoQueueItem& video) {
+                return video.status == ProcessingStatus::Completed ||
+                       video.status == ProcessingStatus::Error;
+            });
 
-    if (it != m_videos.end()) {
+        if (it == m_videos.end()) {
+            return;
+        }
         m_videos.erase(it, m_videos.end());
-        emit queueCleared();
     }
+    emit queueCleared();
 }
 
 void VideoQueue::clearAll()
 {
-    // Only clear if no videos are currently processing
-    if (!isProcessing()) {
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // Only clear if no videos are currently processing
+        if (isProcessingLocked()) {
+            return;
+        }
         m_videos.clear();
-        emit queueCleared();
     }
+    emit queueCleared();
 }
 
 int VideoQueue::getNextToProcess() const
 {
+    QMutexLocker locker(&m_mutex);
     for (int i = 0; i < static_cast<int>(m_videos.size()); ++i) {
         if (m_videos[i].status == ProcessingStatus::Queued) {
             return i;
@@ -160,7 +222,33 @@ int VideoQueue::getNextToProcess() const
     return -1;
 }
 
+int VideoQueue::claimNextToProcess()
+{
+    int index = -1;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < static_cast<int>(m_videos.size()); ++i) {
+            if (m_videos[i].status == ProcessingStatus::Queued) {
+                applyStatus(m_videos[i], ProcessingStatus::FFmpegHandling);
+                index = i;
+                break;
+            }
+        }
+    }
+
+    if (index != -1) {
+        emit statusChanged(index, ProcessingStatus::FFmpegHandling);
+    }
+    return index;
+}
+
 bool VideoQueue::isProcessing() const
+{
+    QMutexLocker locker(&m_mutex);
+    return isProcessingLocked();
+}
+
+bool VideoQueue::isProcessingLocked() const
 {
     for (const auto& video : m_videos) {
         ProcessingStatus status = video.status;
@@ -175,16 +263,25 @@ bool VideoQueue::isProcessing() const
 
 void VideoQueue::resetErrorVideos()
 {
-    for (auto& video : m_videos) {
-        if (video.status == ProcessingStatus::Error) {
-            video.status = ProcessingStatus::Queued;
-            video.errorMessage.clear();
-            video.startTime = QDateTime();
-            video.endTime = QDateTime();
-            video.processingTimeSeconds = 0.0;
-            emit statusChanged(static_cast<int>(&video - &m_videos[0]), ProcessingStatus::Queued);
+    std::vector<int> resetIndices;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < static_cast<int>(m_videos.size()); ++i) {
+            VideoQueueItem& video = m_videos[i];
+            if (video.status == ProcessingStatus::Error) {
+                video.status = ProcessingStatus::Queued;
+                video.errorMessage.clear();
+                video.startTime = QDateTime();
+                video.endTime = QDateTime();
+                video.processingTimeSeconds = 0.0;
+                resetIndices.push_back(i);
+            }
         }
     }
+
+    for (int index : resetIndices) {
+        emit statusChanged(index, ProcessingStatus::Queued);
+    }
 }
 
 QString VideoQueue::getStatusString(ProcessingStatus status)
@@ -5,6 +5,7 @@
 #include <QString>
 #include <QDateTime>
 #include <QFileInfo>
+#include <QMutex>
 #include <vector>
 
 enum class ProcessingStatus {
@@ -26,6 +27,7 @@ struct VideoQueueItem {
     int extractedSlides;
     QString errorMessage;
     double processingTimeSeconds;
+    int slideWriteFailures;     // Slides that could not be written to disk
 
     // Post-processing statistics
     int movedToTrash;           // Total moved to trash (pHash + ML)
@@ -40,12 +42,22 @@ struct VideoQueueItem {
         addedTime(QDateTime::currentDateTime()),
         extractedSlides(0),
         processingTimeSeconds(0.0),
+        slideWriteFailures(0),
         movedToTrash(0),
         movedByPHash(0),
         movedByML(0)
     {}
 };
 
+/**
+ * Queue of videos to process.
+ *
+ * Every accessor and mutator locks an internal mutex, so concurrent video workers can
+ * update their own items while others are being read. Signals are emitted after the
+ * lock is released. getVideo() hands out a pointer into the queue; only fields that
+ * do not change during processing (paths, names, post-processing statistics) may be
+ * read through it while workers run. Use getAllVideos() for a consistent snapshot.
+ */
 class VideoQueue : public QObject
 {
     Q_OBJECT
@@ -75,10 +87,24 @@ public:
     VideoQueueItem* getVideo(int index);
 
     /**
-     * Get all videos in queue
-     * @return Vector of all video items
+     * Get the file path of a video
+     * @param index Index of video
+     * @return File path, empty if invalid index
+     */
+    QString getFilePath(int index) const;
+
+    /**
+     * Record the output directory slides of a video are written to
+     * @param index Index of video
+     * @param outputDirectory Output directory
+     */
+    void setOutputDirectory(int index, const QString& outputDirectory);
+
+    /**
+     * Get a snapshot of all videos in queue
+     * @return Copy of all video items
      */
-    const std::vector<VideoQueueItem>& getAllVideos() const;
+    std::vector<VideoQueueItem> getAllVideos() const;
 
     /**
      * Get number of videos in queue
@@ -107,6 +133,13 @@ public:
      */
     void updateStatistics(int index, int extractedSlides, double processingTime);
 
+    /**
+     * Record slides that failed to encode or write for a video
+     * @param index Index of video
+     * @param failures Number of failed slide writes
+     */
+    void setSlideWriteFailures(int index, int failures);
+
     /**
      * Set error message for video
      * @param index Index of video
@@ -130,6 +163,13 @@ public:
      */
     int getNextToProcess() const;
 
+    /**
+     * Atomically take the first queued video and mark it as FFmpegHandling,
+     * so concurrent workers never claim the same video
+     * @return Index of the claimed video, -1 if none available
+     */
+    int claimNextToProcess();
+
     /**
      * Check if any video is currently being processed
      * @return true if processing
@@ -156,7 +196,21 @@ signals:
     void queueCleared();
 
 private:
+    /**
+     * Check for videos in a processing state; caller must hold m_mutex
+     * @return true if processing
+     */
+    bool isProcessingLocked() const;
+
+    /**
+     * Apply a status change and its timestamps; caller must hold m_mutex
+     * @param video Video item
+     * @param status New status
+     */
+    static void applyStatus(VideoQueueItem& video, ProcessingStatus status);
+
     std::vector<VideoQueueItem> m_videos;
+    mutable QMutex m_mutex;     // Guards m_videos
 };
 
 #endif // VIDEOQUEUE_H
\ No newline at end of file